@@ -1,7 +1,12 @@
 #include "LiquidRenderer.hpp"
 #include "aura_kernel.h"
+#include "aura_shaders.h"
+#include <algorithm>
 #include <android/log.h>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -9,51 +14,126 @@
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-// Minimal SPIR-V for a Triangle (Vertex Shader)
-const uint32_t vert_code[] = {
-    0x07230203, 0x00010000, 0x00080007, 0x0000001a, 0x00000000, 0x00020011,
-    0x00000001, 0x0006000b, 0x00000001, 0x4c534c47, 0x2e737464, 0x35342e30,
-    0x00000000, 0x0003000e, 0x00000000, 0x00000001, 0x0005000f, 0x00000000,
-    0x00000004, 0x6e69616d, 0x00000000, 0x00030003, 0x00000002, 0x000001c2,
-    0x00040005, 0x00000004, 0x6e69616d, 0x00000000, 0x00050006, 0x00000009,
-    0x00000000, 0x6c675f50, 0x6974696f, 0x6e000073, 0x00050006, 0x00000009,
-    0x00000001, 0x6c675f50, 0x6e696f50, 0x697a6500, 0x00050006, 0x00000009,
-    0x00000002, 0x6c675f43, 0x4470696c, 0x74736944, 0x636e6100, 0x00050006,
-    0x00000009, 0x00000003, 0x6c675f43, 0x6c6c7543, 0x74736944, 0x636e6100,
-    0x00040005, 0x00000007, 0x6c675f50, 0x65726956, 0x78000062, 0x00030005,
-    0x0000000d, 0x00000000, 0x00050048, 0x00000009, 0x00000000, 0x0000000b,
-    0x00000000, 0x00050048, 0x00000009, 0x00000001, 0x0000000b, 0x00000001,
-    0x00050048, 0x00000009, 0x00000002, 0x0000000b, 0x00000002, 0x00050048,
-    0x00000009, 0x00000003, 0x0000000b, 0x00000003, 0x00030047, 0x00000009,
-    0x00000002, 0x00020013, 0x00000002, 0x00030021, 0x00000003, 0x00000002,
-    0x00030016, 0x00000006, 0x00000020, 0x00040017, 0x00000007, 0x00000006,
-    0x00000004, 0x00040015, 0x00000008, 0x00000020, 0x00000000, 0x00040018,
-    0x00000008, 0x00000006, 0x00000001, 0x0006001c, 0x00000009, 0x00000007,
-    0x00000006, 0x00000008, 0x00000008, 0x00040020, 0x0000000a, 0x00000003,
-    0x00000009, 0x0004003b, 0x0000000a, 0x0000000b, 0x00000003, 0x00040015,
-    0x0000000c, 0x00000020, 0x00000001, 0x0004002b, 0x0000000c, 0x0000000d,
-    0x00000000, 0x00040020, 0x0000000e, 0x00000001, 0x0000000c, 0x0004003b,
-    0x0000000e, 0x0000000f, 0x00000001, 0x00040020, 0x00000010, 0x00000003,
-    0x00000007, 0x00040015, 0x00000012, 0x00000020, 0x00000000, 0x0004002b,
-    0x00000012, 0x00000013, 0x00000003, 0x00040017, 0x00000014, 0x00000006,
-    0x00000002, 0x0006001c, 0x00000015, 0x00000014, 0x00000013, 0x00000013,
-    0x00000013, 0x00040020, 0x00000016, 0x00000001, 0x00000015, 0x0004003b,
-    0x00000016, 0x00000017, 0x00000001, 0x0004002b, 0x00000006, 0x00000018,
-    0x00000000, 0x0004002b, 0x00000006, 0x00000019, 0x3f800000, 0x00050036,
-    0x00000002, 0x00000004, 0x00000000, 0x00000003, 0x000200f8, 0x00000005,
-    0x0004003d, 0x0000000c, 0x00000011, 0x0000000f, 0x00050041, 0x00000010,
-    0x00000017, 0x00000011, 0x00000013, 0x0004003d, 0x00000014, 0x00000018,
-    0x00000017, 0x00050051, 0x00000006, 0x00000019, 0x00000018, 0x00000000,
-    0x00050051, 0x00000006, 0x0000001a, 0x00000018, 0x00000001, 0x00070050,
-    0x00000007, 0x0000001b, 0x00000019, 0x0000001a, 0x00000018, 0x00000019,
-    0x00050041, 0x00000010, 0x0000001c, 0x0000000b, 0x0000000d, 0x0003003e,
-    0x0000001c, 0x0000001b, 0x000100fd, 0x00010038};
-
-LiquidRenderer::LiquidRenderer() {}
-LiquidRenderer::~LiquidRenderer() { cleanup(); }
+LiquidRenderer::LiquidRenderer() {
+  // Inisialisasi state awal (Pusat layar, bentuk kecil)
+  island = springs.addIsland({200.0f, 40.0f, 400.0f, 50.0f, 20.0f}, stiffness,
+                             damping);
+}
+LiquidRenderer::~LiquidRenderer() {
+  stop();
+  cleanup();
+}
+
+bool LiquidRenderer::start(ANativeWindow *win) {
+  if (renderThread.joinable())
+    return false;
+  window = win;
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    stopRequested = false;
+    wakePending = false;
+  }
+  renderThread = std::thread(&LiquidRenderer::renderLoop, this);
+  return true;
+}
+
+void LiquidRenderer::stop() {
+  if (!renderThread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    stopRequested = true;
+  }
+  wakeCondition.notify_one();
+  renderThread.join();
+  if (window != nullptr) {
+    ANativeWindow_release(window);
+    window = nullptr;
+  }
+}
+
+void LiquidRenderer::wake() {
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    wakePending = true;
+  }
+  wakeCondition.notify_one();
+}
+
+void LiquidRenderer::setTarget(const IslandState &target) {
+  targets.publish(target);
+  wake();
+}
+
+void LiquidRenderer::setPowerSaving(bool enabled) {
+  requestedPowerMode.store(enabled ? AURA_POWER_EFFICIENT
+                                   : AURA_POWER_BALANCED);
+}
+
+void LiquidRenderer::renderLoop() {
+  if (!init(window)) {
+    LOGE("Render thread: Vulkan init failed");
+    cleanup();
+    return;
+  }
+  presenter.start(presentQueue, framesInFlight);
+  auto lastTick = std::chrono::steady_clock::now();
+  // Frame pertama selalu digambar
+  bool redraw = true;
+  while (true) {
+    IslandState target;
+    bool newTarget = targets.take(target);
+    if (newTarget)
+      springs.setTarget(island, target);
+    if (surfaceChanged.exchange(false)) {
+      uint64_t size = surfaceSize.load();
+      if ((uint32_t)size != swapChainExtent.width ||
+          (uint32_t)(size >> 32) != swapChainExtent.height)
+        swapChainOutdated = true;
+      redraw = true;
+    }
+    bool idle = !newTarget && !redraw && !swapChainOutdated &&
+                springs.allAtRest();
+    {
+      std::unique_lock<std::mutex> lock(wakeMutex);
+      if (stopRequested)
+        break;
+      if (idle) {
+        // Tidak ada yang berubah di layar: tidur sampai target/resize baru
+        wakeCondition.wait(lock,
+                           [this] { return wakePending || stopRequested; });
+        wakePending = false;
+        lastTick = std::chrono::steady_clock::now();
+        continue;
+      }
+      wakePending = false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    float dt = std::chrono::duration<float>(now - lastTick).count();
+    lastTick = now;
+    // Langkah yang membuat pulau diam tetap digambar (bentuk akhir)
+    springs.step(dt);
+    render();
+    redraw = false;
+  }
+  // Present yang masih antre keluar dulu; cleanup memanggil vkDeviceWaitIdle
+  presenter.stop();
+  cleanup();
+}
 
 bool LiquidRenderer::init(ANativeWindow *win) {
   window = win;
+  startTime = std::chrono::steady_clock::now();
+  kernelChannel = aura_kernel_channel_create();
+  if (kernelChannel == nullptr)
+    LOGE("Kernel channel unavailable");
+  AuraFluidCurve curve = {};
+  aura_kernel_get_fluid_curve(&curve);
+  fluidCurve[0] = curve.ripple_frequency;
+  fluidCurve[1] = curve.ripple_amplitude;
+  fluidCurve[2] = curve.wave_frequency;
+  fluidCurve[3] = curve.wave_amplitude;
   if (!createInstance())
     return false;
   if (!createSurface())
@@ -66,14 +146,24 @@ bool LiquidRenderer::init(ANativeWindow *win) {
     return false;
   if (!createImageViews())
     return false;
+  if (!createRenderFinishedSemaphores())
+    return false;
   if (!createRenderPass())
     return false;
+  if (!createDescriptorSetLayout())
+    return false;
+  if (!createPipelineCache())
+    return false;
   if (!createGraphicsPipeline())
     return false;
   if (!createFramebuffers())
     return false;
   if (!createCommandPool())
     return false;
+  if (!createUniformRing())
+    return false;
+  if (!createDescriptorSets())
+    return false;
   if (!createCommandBuffers())
     return false;
   if (!createSyncObjects())
@@ -88,7 +178,17 @@ bool LiquidRenderer::createInstance() {
   appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
   appInfo.pApplicationName = "Aura Android";
   appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
-  appInfo.apiVersion = VK_API_VERSION_1_0;
+  // Timeline semaphore dan synchronization2 butuh instance 1.3; loader
+  // Vulkan 1.0 tidak punya vkEnumerateInstanceVersion dan menolak versi > 1.0
+  auto enumerateInstanceVersion =
+      (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(
+          VK_NULL_HANDLE, "vkEnumerateInstanceVersion");
+  if (enumerateInstanceVersion &&
+      enumerateInstanceVersion(&instanceApiVersion) != VK_SUCCESS)
+    instanceApiVersion = VK_API_VERSION_1_0;
+  appInfo.apiVersion = instanceApiVersion < VK_API_VERSION_1_3
+                           ? instanceApiVersion
+                           : VK_API_VERSION_1_3;
 
   std::vector<const char *> extensions = {
       VK_KHR_SURFACE_EXTENSION_NAME, VK_KHR_ANDROID_SURFACE_EXTENSION_NAME};
@@ -121,6 +221,19 @@ bool LiquidRenderer::pickPhysicalDevice() {
   return true;
 }
 
+bool LiquidRenderer::hasDeviceExtension(const char *name) const {
+  uint32_t count = 0;
+  vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count,
+                                       nullptr);
+  std::vector<VkExtensionProperties> extensions(count);
+  vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count,
+                                       extensions.data());
+  for (const auto &ext : extensions)
+    if (std::strcmp(ext.extensionName, name) == 0)
+      return true;
+  return false;
+}
+
 bool LiquidRenderer::createLogicalDevice() {
   float queuePriority = 1.0f;
   VkDeviceQueueCreateInfo queueCreateInfo = {};
@@ -129,55 +242,176 @@ bool LiquidRenderer::createLogicalDevice() {
   queueCreateInfo.queueCount = 1;
   queueCreateInfo.pQueuePriorities = &queuePriority;
 
-  const std::vector<const char *> deviceExtensions = {
+  std::vector<const char *> deviceExtensions = {
       VK_KHR_SWAPCHAIN_EXTENSION_NAME};
   VkDeviceCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   createInfo.pQueueCreateInfos = &queueCreateInfo;
   createInfo.queueCreateInfoCount = 1;
+
+  // Frame pacing dengan timeline semaphore bila device dan instance 1.3
+  timelineEnabled = instanceApiVersion >= VK_API_VERSION_1_3 &&
+                    FrameTimeline::supported(instance, physicalDevice);
+  VkPhysicalDeviceVulkan12Features features12 = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+  features12.timelineSemaphore = timelineEnabled;
+  VkPhysicalDeviceVulkan13Features features13 = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES, &features12};
+  features13.synchronization2 = VK_TRUE;
+
+  // GPU mobile menjalankan fp16 dua kali lebih cepat: pakai shader fast math
+  // bila shaderFloat16 ada. Inti sejak 1.2; device 1.1 (masih banyak di
+  // Android) memakai VK_KHR_shader_float16_int8 yang juga harus diaktifkan.
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(physicalDevice, &props);
+  auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2)vkGetInstanceProcAddr(
+      instance, "vkGetPhysicalDeviceFeatures2");
+  bool float16Core = false;
+  bool float16Extension = false;
+  if (instanceApiVersion >= VK_API_VERSION_1_2 &&
+      props.apiVersion >= VK_API_VERSION_1_2 && getFeatures2) {
+    VkPhysicalDeviceVulkan12Features supported12 = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    VkPhysicalDeviceFeatures2 supported = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, &supported12};
+    getFeatures2(physicalDevice, &supported);
+    float16Core = supported12.shaderFloat16 == VK_TRUE;
+  } else if (instanceApiVersion >= VK_API_VERSION_1_1 &&
+             props.apiVersion >= VK_API_VERSION_1_1 && getFeatures2 &&
+             hasDeviceExtension(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME)) {
+    VkPhysicalDeviceShaderFloat16Int8Features supported16 = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+    VkPhysicalDeviceFeatures2 supported = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, &supported16};
+    getFeatures2(physicalDevice, &supported);
+    float16Extension = supported16.shaderFloat16 == VK_TRUE;
+  }
+  fastMathEnabled = float16Core || float16Extension;
+  features12.shaderFloat16 = float16Core;
+  VkPhysicalDeviceShaderFloat16Int8Features features16 = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+  features16.shaderFloat16 = float16Extension;
+  if (float16Extension)
+    deviceExtensions.push_back(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME);
   createInfo.enabledExtensionCount =
       static_cast<uint32_t>(deviceExtensions.size());
   createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
+  if (timelineEnabled)
+    createInfo.pNext = &features13;
+  else if (float16Core)
+    createInfo.pNext = &features12;
+  // Hanya di bawah 1.2, jadi tidak pernah bersama features12/13
+  else if (float16Extension)
+    createInfo.pNext = &features16;
+
   if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) !=
       VK_SUCCESS)
     return false;
   vkGetDeviceQueue(device, 0, 0, &graphicsQueue);
   presentQueue = graphicsQueue;
-  return true;
+  return memoryAllocator.init(physicalDevice, device);
 }
 
-bool LiquidRenderer::createSwapChain() {
-  VkSurfaceCapabilitiesKHR capabilities;
-  vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface,
-                                            &capabilities);
-  swapChainExtent = capabilities.currentExtent;
-  swapChainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+bool LiquidRenderer::createSwapChain(VkSwapchainKHR oldSwapChain) {
+  // Ukuran mengikuti currentExtent dari surface (ANativeWindow)
+  SwapchainSettings settings;
+  VkExtent2D windowExtent = {(uint32_t)ANativeWindow_getWidth(window),
+                             (uint32_t)ANativeWindow_getHeight(window)};
+  if (!querySwapchainSettings(physicalDevice, surface, presentPreference,
+                              windowExtent, swapChainImageFormat, settings))
+    return false;
+  if (settings.extent.width == 0 || settings.extent.height == 0)
+    return false;
+  if (oldSwapChain != VK_NULL_HANDLE &&
+      settings.format.format != swapChainImageFormat) {
+    LOGE("Surface format changed during resize");
+    return false;
+  }
+  swapChainExtent = settings.extent;
+  swapChainImageFormat = settings.format.format;
 
   VkSwapchainCreateInfoKHR createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
   createInfo.surface = surface;
-  createInfo.minImageCount = 2;
+  createInfo.minImageCount = settings.imageCount;
   createInfo.imageFormat = swapChainImageFormat;
+  createInfo.imageColorSpace = settings.format.colorSpace;
   createInfo.imageExtent = swapChainExtent;
   createInfo.imageArrayLayers = 1;
   createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
   createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-  createInfo.preTransform = capabilities.currentTransform;
-  createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-  createInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
-
-  if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapChain) !=
+  createInfo.preTransform = settings.preTransform;
+  createInfo.compositeAlpha = settings.compositeAlpha;
+  createInfo.presentMode = settings.presentMode;
+  createInfo.clipped = VK_TRUE;
+  createInfo.oldSwapchain = oldSwapChain;
+
+  VkSwapchainKHR newSwapChain = VK_NULL_HANDLE;
+  if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &newSwapChain) !=
       VK_SUCCESS)
     return false;
+  swapChain = newSwapChain;
   uint32_t imageCount;
   vkGetSwapchainImagesKHR(device, swapChain, &imageCount, nullptr);
   swapChainImages.resize(imageCount);
   vkGetSwapchainImagesKHR(device, swapChain, &imageCount,
                           swapChainImages.data());
+  LOGI("Swapchain: %ux%u, %u images, %s", swapChainExtent.width,
+       swapChainExtent.height, imageCount,
+       presentModeName(settings.presentMode));
+  return true;
+}
+
+bool LiquidRenderer::recreateSwapChain() {
+  auto start = std::chrono::steady_clock::now();
+  // Present yang masih antre memakai swapchain dan semaphore lama
+  presenter.drain();
+  RetiredSwapchain retired = {};
+  retired.swapChain = swapChain;
+  if (!createSwapChain(swapChain))
+    return false;
+
+  retired.imageViews = std::move(swapChainImageViews);
+  retired.framebuffers = std::move(swapChainFramebuffers);
+  retired.commandBuffers = std::move(commandBuffers);
+  retired.renderFinishedSemaphores = std::move(renderFinishedSemaphores);
+  frameTimeline.deferUntilRetired(
+      [this, retired = std::move(retired)]() mutable {
+        destroyRetiredSwapchain(retired);
+      });
+
+  if (!createImageViews() || !createRenderFinishedSemaphores() ||
+      !createFramebuffers() || !createCommandBuffers())
+    return false;
+  LOGI("Swapchain recreated in %.2f ms",
+       std::chrono::duration<double, std::milli>(
+           std::chrono::steady_clock::now() - start)
+           .count());
   return true;
 }
 
+void LiquidRenderer::destroyRetiredSwapchain(RetiredSwapchain &retired) {
+  if (!retired.commandBuffers.empty())
+    vkFreeCommandBuffers(device, commandPool,
+                         (uint32_t)retired.commandBuffers.size(),
+                         retired.commandBuffers.data());
+  for (auto fb : retired.framebuffers)
+    vkDestroyFramebuffer(device, fb, nullptr);
+  for (auto iv : retired.imageViews)
+    vkDestroyImageView(device, iv, nullptr);
+  for (auto s : retired.renderFinishedSemaphores)
+    vkDestroySemaphore(device, s, nullptr);
+  vkDestroySwapchainKHR(device, retired.swapChain, nullptr);
+}
+
+void LiquidRenderer::onSurfaceChanged(uint32_t width, uint32_t height) {
+  // Dipanggil dari thread UI; thread render membandingkan dengan swapchain
+  surfaceSize.store((uint64_t)width | ((uint64_t)height << 32));
+  surfaceChanged = true;
+  wake();
+}
+
 bool LiquidRenderer::createImageViews() {
   swapChainImageViews.resize(swapChainImages.size());
   for (size_t i = 0; i < swapChainImages.size(); i++) {
@@ -194,6 +428,18 @@ bool LiquidRenderer::createImageViews() {
   return true;
 }
 
+bool LiquidRenderer::createRenderFinishedSemaphores() {
+  // Per image, bukan per frame slot: semaphore present baru bebas setelah
+  // image yang sama di-acquire lagi
+  renderFinishedSemaphores.assign(swapChainImages.size(), VK_NULL_HANDLE);
+  VkSemaphoreCreateInfo semInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  for (auto &s : renderFinishedSemaphores) {
+    if (vkCreateSemaphore(device, &semInfo, nullptr, &s) != VK_SUCCESS)
+      return false;
+  }
+  return true;
+}
+
 bool LiquidRenderer::createRenderPass() {
   VkAttachmentDescription colorAttachment = {};
   colorAttachment.format = swapChainImageFormat;
@@ -221,28 +467,181 @@ bool LiquidRenderer::createRenderPass() {
          VK_SUCCESS;
 }
 
-VkShaderModule
-LiquidRenderer::createShaderModule(const std::vector<uint32_t> &code) {
+bool LiquidRenderer::createDescriptorSetLayout() {
+  // 0 = data per frame (uniform), 1 = instance pulau (storage)
+  VkDescriptorSetLayoutBinding bindings[2] = {};
+  bindings[0].binding = 0;
+  bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  bindings[0].descriptorCount = 1;
+  bindings[0].stageFlags =
+      VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+  bindings[1] = bindings[0];
+  bindings[1].binding = 1;
+  bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+  layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layoutInfo.bindingCount = 2;
+  layoutInfo.pBindings = bindings;
+  return vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr,
+                                     &descriptorSetLayout) == VK_SUCCESS;
+}
+
+bool LiquidRenderer::createPipelineCache() {
+  if (!pipelineCache.load(physicalDevice, device, cachePath))
+    return false;
+  LOGI("Pipeline cache %s: %s", cachePath.c_str(),
+       pipelineCache.statusString());
+  return true;
+}
+
+VkShaderModule LiquidRenderer::createShaderModule(const uint32_t *code,
+                                                 size_t size) {
   VkShaderModuleCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-  createInfo.codeSize = code.size() * sizeof(uint32_t);
-  createInfo.pCode = code.data();
-  VkShaderModule shaderModule;
+  createInfo.codeSize = size;
+  createInfo.pCode = code;
+  VkShaderModule shaderModule = VK_NULL_HANDLE;
   vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule);
   return shaderModule;
 }
 
 bool LiquidRenderer::createGraphicsPipeline() {
-  std::vector<uint32_t> vert_vec(std::begin(vert_code), std::end(vert_code));
-  VkShaderModule vertModule = createShaderModule(vert_vec);
+  // SPIR-V dikompilasi saat build dari aura-graphics/shaders (AuraShaders.cmake)
+  VkShaderModule vertModule = createShaderModule(
+      aura_shaders::shader_vert, aura_shaders::shader_vert_size);
+  VkShaderModule fragModule =
+      fastMathEnabled ? createShaderModule(aura_shaders::liquid_fast_frag,
+                                           aura_shaders::liquid_fast_frag_size)
+                      : createShaderModule(aura_shaders::liquid_frag,
+                                           aura_shaders::liquid_frag_size);
+  if (vertModule == VK_NULL_HANDLE || fragModule == VK_NULL_HANDLE) {
+    LOGE("Failed to create shader modules");
+    vkDestroyShaderModule(device, vertModule, nullptr);
+    vkDestroyShaderModule(device, fragModule, nullptr);
+    return false;
+  }
+
+  VkPipelineShaderStageCreateInfo stages[2] = {};
+  stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+  stages[0].module = vertModule;
+  stages[0].pName = "main";
+  stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+  stages[1].module = fragModule;
+  stages[1].pName = "main";
+  // Konstanta 1-3 di liquid_common.glsl: oktaf warp, glow, highlight
+  VkSpecializationMapEntry qualityEntries[3] = {
+      {1, offsetof(LiquidQualitySpec, warpIterations), sizeof(int32_t)},
+      {2, offsetof(LiquidQualitySpec, glow), sizeof(VkBool32)},
+      {3, offsetof(LiquidQualitySpec, highlight), sizeof(VkBool32)}};
+  LiquidQualitySpec spec = {};
+  VkSpecializationInfo specialization = {3, qualityEntries, sizeof(spec),
+                                         &spec};
+  stages[1].pSpecializationInfo = &specialization;
+
+  VkPipelineVertexInputStateCreateInfo vertexInput = {};
+  vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+  VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+  inputAssembly.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+  // Viewport/scissor dinamis: resize tidak perlu membangun ulang pipeline
+  VkPipelineViewportStateCreateInfo viewportState = {};
+  viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+  viewportState.viewportCount = 1;
+  viewportState.scissorCount = 1;
+  VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                    VK_DYNAMIC_STATE_SCISSOR};
+  VkPipelineDynamicStateCreateInfo dynamicState = {};
+  dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+  dynamicState.dynamicStateCount = 2;
+  dynamicState.pDynamicStates = dynamicStates;
+
+  VkPipelineRasterizationStateCreateInfo rasterizer = {};
+  rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+  rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+  rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+  rasterizer.lineWidth = 1.0f;
+
+  VkPipelineMultisampleStateCreateInfo multisampling = {};
+  multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+  multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+  // Premultiplied alpha agar glow pulau yang bertumpuk tercampur benar
+  VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+  colorBlendAttachment.blendEnable = VK_TRUE;
+  colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+  colorBlendAttachment.dstColorBlendFactor =
+      VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+  colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  colorBlendAttachment.dstAlphaBlendFactor =
+      VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+  colorBlendAttachment.colorWriteMask =
+      VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+      VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+  VkPipelineColorBlendStateCreateInfo colorBlending = {};
+  colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+  colorBlending.attachmentCount = 1;
+  colorBlending.pAttachments = &colorBlendAttachment;
 
-  // In actual app, we'd also load frag shader. For now, empty pipeline is
-  // better than null.
   VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
   pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-  vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout);
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+  if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr,
+                             &pipelineLayout) != VK_SUCCESS) {
+    vkDestroyShaderModule(device, fragModule, nullptr);
+    vkDestroyShaderModule(device, vertModule, nullptr);
+    return false;
+  }
 
+  VkGraphicsPipelineCreateInfo pipelineInfo = {};
+  pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  pipelineInfo.stageCount = 2;
+  pipelineInfo.pStages = stages;
+  pipelineInfo.pVertexInputState = &vertexInput;
+  pipelineInfo.pInputAssemblyState = &inputAssembly;
+  pipelineInfo.pViewportState = &viewportState;
+  pipelineInfo.pRasterizationState = &rasterizer;
+  pipelineInfo.pMultisampleState = &multisampling;
+  pipelineInfo.pColorBlendState = &colorBlending;
+  pipelineInfo.pDynamicState = &dynamicState;
+  pipelineInfo.layout = pipelineLayout;
+  pipelineInfo.renderPass = renderPass;
+  pipelineInfo.subpass = 0;
+
+  auto buildStart = std::chrono::steady_clock::now();
+  VkResult result = VK_SUCCESS;
+  for (uint32_t tier = 0; tier < QUALITY_TIER_COUNT && result == VK_SUCCESS;
+       tier++) {
+    spec = liquidQualitySpec((QualityTier)tier);
+    result = vkCreateGraphicsPipelines(device, pipelineCache.handle(), 1,
+                                       &pipelineInfo, nullptr,
+                                       &graphicsPipelines[tier]);
+  }
+  double buildMs = std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - buildStart)
+                       .count();
+
+  vkDestroyShaderModule(device, fragModule, nullptr);
   vkDestroyShaderModule(device, vertModule, nullptr);
+  if (result != VK_SUCCESS) {
+    LOGE("Failed to create graphics pipeline (%d)", result);
+    return false;
+  }
+
+  pipelineCache.recordBuildTime(buildMs);
+  LOGI("Pipelines (%u tiers, %s) built in %.2f ms (cache %s, saved %.2f ms)",
+       QUALITY_TIER_COUNT, fastMathEnabled ? "fp16 fast math" : "fp32",
+       buildMs, pipelineCache.statusString(),
+       pipelineCache.timeSavedMs());
   return true;
 }
 
@@ -267,76 +666,104 @@ bool LiquidRenderer::createFramebuffers() {
 bool LiquidRenderer::createCommandPool() {
   VkCommandPoolCreateInfo poolInfo = {};
   poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  // Command buffer satu slot direkam ulang saat tier kualitas berganti
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
   poolInfo.queueFamilyIndex = 0;
   return vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) ==
          VK_SUCCESS;
 }
 
+bool LiquidRenderer::createUniformRing() {
+  framesInFlight = std::clamp(framesInFlight, 1u, FrameTimeline::MAX_DEPTH);
+  // Kedua ring menempati reservasi di depan setiap slot arena
+  VkDeviceSize perFrame = sizeof(LiquidFrameUniforms) +
+                          IslandInstanceRing::slotSize(MAX_ISLANDS) +
+                          2 * FrameUploadArena::MAX_ALIGNMENT;
+  return uploadArena.init(memoryAllocator, perFrame, framesInFlight,
+                          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                              VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                              VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT) &&
+         uniformRing.init(uploadArena, sizeof(LiquidFrameUniforms)) &&
+         islandRing.init(uploadArena, MAX_ISLANDS);
+}
+
+bool LiquidRenderer::createDescriptorSets() {
+  VkDescriptorPoolSize poolSizes[] = {
+      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1}};
+  VkDescriptorPoolCreateInfo poolInfo = {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = 2;
+  poolInfo.pPoolSizes = poolSizes;
+  if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) !=
+      VK_SUCCESS)
+    return false;
+
+  VkDescriptorSetAllocateInfo allocInfo = {};
+  allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.descriptorPool = descriptorPool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &descriptorSetLayout;
+  if (vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet) !=
+      VK_SUCCESS)
+    return false;
+
+  VkDescriptorBufferInfo frameInfo = {uniformRing.buffer(), 0,
+                                      uniformRing.elementSize()};
+  VkDescriptorBufferInfo islandInfo = {islandRing.buffer(), 0,
+                                       islandRing.instancesRange()};
+  VkWriteDescriptorSet writes[2] = {};
+  writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writes[0].dstSet = descriptorSet;
+  writes[0].dstBinding = 0;
+  writes[0].descriptorCount = 1;
+  writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  writes[0].pBufferInfo = &frameInfo;
+  writes[1] = writes[0];
+  writes[1].dstBinding = 1;
+  writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+  writes[1].pBufferInfo = &islandInfo;
+  vkUpdateDescriptorSets(device, 2, writes, 0, nullptr);
+  return true;
+}
+
 bool LiquidRenderer::createCommandBuffers() {
-  commandBuffers.resize(swapChainFramebuffers.size());
+  uint32_t imageCount = (uint32_t)swapChainFramebuffers.size();
+  commandBuffers.resize(framesInFlight * imageCount);
   VkCommandBufferAllocateInfo allocInfo = {};
   allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
   allocInfo.commandPool = commandPool;
   allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
   allocInfo.commandBufferCount = (uint32_t)commandBuffers.size();
-  return vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) ==
-         VK_SUCCESS;
-}
+  if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) !=
+      VK_SUCCESS)
+    return false;
 
-bool LiquidRenderer::createSyncObjects() {
-  imageAvailableSemaphores.resize(2);
-  renderFinishedSemaphores.resize(2);
-  inFlightFences.resize(2);
-  VkSemaphoreCreateInfo semInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
-  VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr,
-                                 VK_FENCE_CREATE_SIGNALED_BIT};
-  for (int i = 0; i < 2; i++) {
-    vkCreateSemaphore(device, &semInfo, nullptr, &imageAvailableSemaphores[i]);
-    vkCreateSemaphore(device, &semInfo, nullptr, &renderFinishedSemaphores[i]);
-    vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[i]);
-  }
+  // Record once; render() only writes the uniform and island rings and
+  // submits, unless the quality tier changes.
+  recordedTiers.assign(framesInFlight, activeTier);
+  for (uint32_t frame = 0; frame < framesInFlight; frame++)
+    recordFrameSlot(frame);
   return true;
 }
 
-return true;
-}
-
-void LiquidRenderer::updateState(IslandState target, float deltaTime) {
-  // Logika Spring Physics untuk morphing UI
-  auto calculateSpring = [&](float current, float targetVal,
-                             float &velocity) -> float {
-    float force = -stiffness * (current - targetVal) - damping * velocity;
-    velocity += force * deltaTime;
-    return current + velocity * deltaTime;
-  };
-
-  currentState.width =
-      calculateSpring(currentState.width, target.width, currentVelocity.width);
-  currentState.height = calculateSpring(currentState.height, target.height,
-                                        currentVelocity.height);
-  currentState.x = calculateSpring(currentState.x, target.x, currentVelocity.x);
-  currentState.y = calculateSpring(currentState.y, target.y, currentVelocity.y);
-  currentState.cornerRadius =
-      calculateSpring(currentState.cornerRadius, target.cornerRadius,
-                      currentVelocity.cornerRadius);
-
-  LOGI("[LiquidRenderer] Morphing Update: W=%.2f, H=%.2f", currentState.width,
-       currentState.height);
+void LiquidRenderer::recordFrameSlot(uint32_t frame) {
+  uint32_t imageCount = (uint32_t)swapChainFramebuffers.size();
+  for (uint32_t image = 0; image < imageCount; image++) {
+    VkCommandBuffer commandBuffer = commandBuffers[frame * imageCount + image];
+    vkResetCommandBuffer(commandBuffer, 0);
+    recordCommandBuffer(commandBuffer, frame, image);
+  }
+  recordedTiers[frame] = activeTier;
 }
 
-void LiquidRenderer::render() {
-
-  vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE,
-                  UINT64_MAX);
-  vkResetFences(device, 1, &inFlightFences[currentFrame]);
-  uint32_t imageIndex;
-  vkAcquireNextImageKHR(device, swapChain, UINT64_MAX,
-                        imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE,
-                        &imageIndex);
-
+void LiquidRenderer::recordCommandBuffer(VkCommandBuffer commandBuffer,
+                                         uint32_t frame, uint32_t imageIndex) {
   VkCommandBufferBeginInfo beginInfo = {
       VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-  vkBeginCommandBuffer(commandBuffers[imageIndex], &beginInfo);
+  vkBeginCommandBuffer(commandBuffer, &beginInfo);
   VkRenderPassBeginInfo rpBegin = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
   rpBegin.renderPass = renderPass;
   rpBegin.framebuffer = swapChainFramebuffers[imageIndex];
@@ -345,68 +772,204 @@ void LiquidRenderer::render() {
   rpBegin.clearValueCount = 1;
   rpBegin.pClearValues = &clearColor;
 
-  vkCmdBeginRenderPass(commandBuffers[imageIndex], &rpBegin,
-                       VK_SUBPASS_CONTENTS_INLINE);
-  vkCmdEndRenderPass(commandBuffers[imageIndex]);
-  vkEndCommandBuffer(commandBuffers[imageIndex]);
-
-  VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  VkPipelineStageFlags waitStages[] = {
-      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-  submitInfo.waitSemaphoreCount = 1;
-  submitInfo.pWaitSemaphores = &imageAvailableSemaphores[currentFrame];
-  submitInfo.pWaitDstStageMask = waitStages;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &commandBuffers[imageIndex];
-  submitInfo.signalSemaphoreCount = 1;
-  submitInfo.pSignalSemaphores = &renderFinishedSemaphores[currentFrame];
-  vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]);
-
-  VkPresentInfoKHR presentInfo = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
-  presentInfo.waitSemaphoreCount = 1;
-  presentInfo.pWaitSemaphores = &renderFinishedSemaphores[currentFrame];
-  presentInfo.swapchainCount = 1;
-  presentInfo.pSwapchains = &swapChain;
-  presentInfo.pImageIndices = &imageIndex;
-  vkQueuePresentKHR(graphicsQueue, &presentInfo);
-
-  currentFrame = (currentFrame + 1) % 2;
-}
-
-uint32_t LiquidRenderer::findMemoryType(uint32_t typeFilter,
-                                        VkMemoryPropertyFlags properties) {
-  VkPhysicalDeviceMemoryProperties memProperties;
-  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-    if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags &
-                                    properties) == properties) {
-      return i;
+  vkCmdBeginRenderPass(commandBuffer, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+  uint32_t dynamicOffsets[] = {uniformRing.dynamicOffset(frame),
+                                islandRing.dynamicOffset(frame)};
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    graphicsPipelines[(uint32_t)activeTier]);
+  VkViewport viewport = {0.0f, 0.0f, (float)swapChainExtent.width,
+                         (float)swapChainExtent.height, 0.0f, 1.0f};
+  VkRect2D scissor = {{0, 0}, swapChainExtent};
+  vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+  vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          pipelineLayout, 0, 1, &descriptorSet, 2,
+                          dynamicOffsets);
+  // Semua pulau dalam satu instanced draw; jumlahnya ada di islandRing
+  islandRing.recordDraw(commandBuffer, frame);
+  vkCmdEndRenderPass(commandBuffer);
+  vkEndCommandBuffer(commandBuffer);
+}
+
+bool LiquidRenderer::createSyncObjects() {
+  if (!frameTimeline.init(device, framesInFlight, timelineEnabled))
+    return false;
+  LOGI("Frame pacing: %s, %u frame(s) in flight",
+       frameTimeline.usesTimeline() ? "timeline semaphore"
+                                    : "fence per frame slot",
+       frameTimeline.depth());
+  imageAvailableSemaphores.assign(framesInFlight, VK_NULL_HANDLE);
+  VkSemaphoreCreateInfo semInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  for (auto &s : imageAvailableSemaphores) {
+    if (vkCreateSemaphore(device, &semInfo, nullptr, &s) != VK_SUCCESS)
+      return false;
+  }
+  return true;
+}
+
+void LiquidRenderer::updateUniforms(uint32_t frame) {
+  LiquidFrameUniforms *u = uniformRing.at<LiquidFrameUniforms>(frame);
+  float time = std::chrono::duration<float>(std::chrono::steady_clock::now() -
+                                            startTime)
+                   .count();
+  float width = (float)swapChainExtent.width;
+  float height = (float)swapChainExtent.height;
+  u->timing[0] = time;
+  u->timing[1] = 1.0f; // liquid layer penuh, tanpa upscale
+  std::copy(fluidCurve, fluidCurve + 4, u->fluidCurve);
+  u->resolution[0] = width;
+  u->resolution[1] = height;
+  u->resolution[2] = 1.0f / width;
+  u->resolution[3] = 1.0f / height;
+  u->counts[0] = islandRing.upload(frame, springs, islandStyles);
+  u->counts[1] = 0; // jalur tiled hanya ada di desktop
+  uniformRing.flush(frame);
+}
+
+void LiquidRenderer::pollKernelEvents() {
+  if (kernelChannel == nullptr)
+    return;
+  // Kanal milik thread render, jadi permintaan dari JNI diteruskan di sini
+  uint32_t requested = requestedPowerMode.load();
+  if (requested != forwardedPowerMode &&
+      aura_kernel_channel_request_power_mode(kernelChannel, requested))
+    forwardedPowerMode = requested;
+  AuraKernelEvent event;
+  while (aura_kernel_channel_poll_event(kernelChannel, &event)) {
+    if (event.kind == AURA_EVENT_POWER_MODE) {
+      powerMode = event.value;
+      LOGI("Kernel: power mode %u (x%.2f)", powerMode, event.factor);
+      // Mode hemat daya: detail shader dibatasi Medium
+      governor.setCeiling(powerMode == AURA_POWER_EFFICIENT
+                              ? QualityTier::Medium
+                              : QualityTier::High);
     }
   }
-  return 0;
+}
+
+void LiquidRenderer::render() {
+  auto frameStart = std::chrono::steady_clock::now();
+  pollKernelEvents();
+  // Frame N memakai slot frame N - framesInFlight: satu host wait pada
+  // timeline (juga menjalankan release yang sudah jatuh tempo)
+  if (!frameTimeline.waitForSlot()) {
+    LOGE("Frame timeline wait failed");
+    return;
+  }
+  uint32_t frame = frameTimeline.slot();
+  // Tier baru berlaku di batas slot; command buffer slot ini sudah bebas
+  activeTier = governor.tier();
+
+  VkResult presented = presenter.takeResult();
+  if (presented == VK_ERROR_OUT_OF_DATE_KHR || presented == VK_SUBOPTIMAL_KHR)
+    swapChainOutdated = true;
+  if (swapChainOutdated) {
+    if (!recreateSwapChain())
+      return;
+    swapChainOutdated = false;
+  }
+  uint32_t imageIndex;
+  auto acquireStart = std::chrono::steady_clock::now();
+  VkResult acquired = vkAcquireNextImageKHR(
+      device, swapChain, UINT64_MAX, imageAvailableSemaphores[frame],
+      VK_NULL_HANDLE, &imageIndex);
+  if (acquired == VK_ERROR_OUT_OF_DATE_KHR) {
+    // Tidak ada image dan belum ada submit; coba lagi di frame berikutnya
+    swapChainOutdated = true;
+    return;
+  }
+  if (acquired == VK_SUBOPTIMAL_KHR)
+    swapChainOutdated = true;
+  else if (acquired != VK_SUCCESS)
+    return;
+  auto acquireEnd = std::chrono::steady_clock::now();
+
+  updateUniforms(frame);
+  if (recordedTiers[frame] != activeTier)
+    recordFrameSlot(frame);
+  VkCommandBuffer commandBuffer =
+      commandBuffers[frame * swapChainImages.size() + imageIndex];
+  // Semaphore acquire per slot, semaphore present per image
+  VkSemaphore rendered = renderFinishedSemaphores[imageIndex];
+  VkResult submitted;
+  {
+    // graphicsQueue == presentQueue; thread present juga memakainya
+    std::lock_guard<std::mutex> queueLock(presenter.queueMutex());
+    submitted = frameTimeline.submit(
+        graphicsQueue, commandBuffer, imageAvailableSemaphores[frame],
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, rendered);
+  }
+  if (submitted != VK_SUCCESS) {
+    LOGE("Frame submit failed");
+    return;
+  }
+  // Hasil present (OUT_OF_DATE/SUBOPTIMAL) dibaca di frame berikutnya
+  auto pushStart = std::chrono::steady_clock::now();
+  presenter.push(swapChain, imageIndex, rendered);
+  auto frameEnd = std::chrono::steady_clock::now();
+
+  // Tanpa timestamp GPU: biaya frame = waktu CPU dikurangi tunggu acquire
+  // dan antrean present, yang tidak dipengaruhi biaya shader
+  using Ms = std::chrono::duration<double, std::milli>;
+  double frameMs = Ms(frameEnd - frameStart).count();
+  double cost = frameMs - Ms(acquireEnd - acquireStart).count() -
+                Ms(frameEnd - pushStart).count();
+  if (governor.addFrame(cost))
+    LOGI("Quality: %s (%.2f ms per frame)", qualityTierName(governor.tier()),
+         governor.smoothedMs());
+
+  if (kernelChannel != nullptr) {
+    AuraFrameTelemetry telemetry = {};
+    telemetry.frame_number = frameTimeline.frameNumber() - 1;
+    telemetry.cpu_frame_ms = (float)frameMs;
+    telemetry.island_count = springs.islandCount();
+    if (!aura_kernel_channel_push_telemetry(kernelChannel, &telemetry))
+      telemetryDropped++;
+  }
 }
 
 void LiquidRenderer::cleanup() {
+  aura_kernel_channel_destroy(kernelChannel);
+  kernelChannel = nullptr;
   if (device != VK_NULL_HANDLE) {
     vkDeviceWaitIdle(device);
-    for (auto f : inFlightFences)
-      vkDestroyFence(device, f, nullptr);
+    // Swapchain lama yang masih ditunda ikut dihancurkan di sini
+    frameTimeline.destroy();
     for (auto s : renderFinishedSemaphores)
       vkDestroySemaphore(device, s, nullptr);
     for (auto s : imageAvailableSemaphores)
       vkDestroySemaphore(device, s, nullptr);
     vkDestroyCommandPool(device, commandPool, nullptr);
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    DeviceMemoryStats stats = memoryAllocator.stats();
+    LOGI("Device memory: %u allocations in %u blocks + %u dedicated, "
+         "%.1f KiB used, %.1f KiB rounding, upload arena %.1f KiB per frame",
+         stats.allocations, stats.blocks, stats.dedicated,
+         stats.usedBytes / 1024.0, stats.wastedBytes / 1024.0,
+         uploadArena.reservedBytes() / 1024.0);
+    uniformRing.destroy();
+    islandRing.destroy();
+    uploadArena.destroy();
     for (auto fb : swapChainFramebuffers)
       vkDestroyFramebuffer(device, fb, nullptr);
+    for (VkPipeline pipeline : graphicsPipelines)
+      vkDestroyPipeline(device, pipeline, nullptr);
+    if (!cachePath.empty() && !pipelineCache.save())
+      LOGE("Pipeline cache: failed to write %s", cachePath.c_str());
+    pipelineCache.destroy();
     vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
     vkDestroyRenderPass(device, renderPass, nullptr);
     for (auto iv : swapChainImageViews)
       vkDestroyImageView(device, iv, nullptr);
     vkDestroySwapchainKHR(device, swapChain, nullptr);
+    memoryAllocator.destroy();
     vkDestroyDevice(device, nullptr);
+    device = VK_NULL_HANDLE;
   }
   if (instance != VK_NULL_HANDLE) {
     vkDestroySurfaceKHR(instance, surface, nullptr);
     vkDestroyInstance(instance, nullptr);
+    instance = VK_NULL_HANDLE;
   }
 }
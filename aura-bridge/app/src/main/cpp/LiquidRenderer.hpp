@@ -7,63 +7,175 @@
 
 #include <android/log.h>
 #include <android/native_window.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <thread>
 #include <vector>
 #include <vulkan/vulkan.h>
 
-/**
- * @brief Status geometri pulau untuk animasi spring physics (Standard Master
- * Context).
- */
-struct IslandState {
-  float width;
-  float height;
-  float x;
-  float y;
-  float cornerRadius;
-};
+#include "DeviceMemoryAllocator.hpp"
+#include "FramePresenter.hpp"
+#include "FrameTimeline.hpp"
+#include "FrameUploadArena.hpp"
+#include "IslandInstanceRing.hpp"
+#include "LiquidUniforms.hpp"
+#include "PipelineCache.hpp"
+#include "QualityGovernor.hpp"
+#include "SpringBatch.hpp"
+#include "StateMailbox.hpp"
+#include "SwapchainSupport.hpp"
+#include "UniformRing.hpp"
+
+struct AuraKernelChannel;
+
+// Kapasitas storage buffer instance pulau per frame
+static const uint32_t MAX_ISLANDS = 256;
 
 class LiquidRenderer {
 public:
   LiquidRenderer();
   ~LiquidRenderer();
 
+  // Must be called before start(); empty keeps the pipeline cache in memory.
+  void setPipelineCachePath(const std::string &path) { cachePath = path; }
+  void setPresentPreference(PresentPreference preference) {
+    presentPreference = preference;
+  }
+  // Juga sebelum start(): 1 = latensi terendah, 3 = throughput (lihat
+  // FrameTimeline).
+  void setFramesInFlight(uint32_t frames) { framesInFlight = frames; }
+  // Menjalankan init, loop render dan cleanup di thread render sendiri dan
+  // mengambil alih referensi `window`. False jika thread sudah berjalan.
+  bool start(ANativeWindow *window);
+  // Dari surfaceDestroyed: hentikan thread render, lepaskan Vulkan + window.
+  void stop();
+  // Dari SurfaceHolder.Callback.surfaceChanged (rotasi / resize); swapchain
+  // dibuat ulang pada frame berikutnya tanpa vkDeviceWaitIdle.
+  void onSurfaceChanged(uint32_t width, uint32_t height);
+  // Target baru untuk pulau dari thread UI/JNI. Tidak pernah menunggu GPU:
+  // lewat mailbox latest-wins, jadi hanya satu thread yang boleh memanggil.
+  void setTarget(const IslandState &target);
+  // Battery saver dari thread UI/JNI; thread render meneruskannya ke kernel
+  // sebagai mode daya (AURA_POWER_EFFICIENT / AURA_POWER_BALANCED) pada
+  // frame berikutnya.
+  void setPowerSaving(bool enabled);
+
+private:
+  // Semua di bawah ini hanya disentuh thread render
   bool init(ANativeWindow *window);
+  void renderLoop();
   void render();
-  void updateState(IslandState target, float deltaTime);
   void cleanup();
+  void wake();
+  void pollKernelEvents();
 
-private:
   ANativeWindow *window = nullptr;
   VkInstance instance = VK_NULL_HANDLE;
   VkSurfaceKHR surface = VK_NULL_HANDLE;
   VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
   VkDevice device = VK_NULL_HANDLE;
+  // Semua buffer renderer dialokasikan dari blok allocator ini
+  DeviceMemoryAllocator memoryAllocator;
   VkQueue graphicsQueue = VK_NULL_HANDLE;
   VkQueue presentQueue = VK_NULL_HANDLE;
   VkSwapchainKHR swapChain = VK_NULL_HANDLE;
-  VkFormat swapChainImageFormat;
-  VkExtent2D swapChainExtent;
+  VkFormat swapChainImageFormat = VK_FORMAT_UNDEFINED;
+  VkExtent2D swapChainExtent = {0, 0};
   std::vector<VkImage> swapChainImages;
   std::vector<VkImageView> swapChainImageViews;
   std::vector<VkFramebuffer> swapChainFramebuffers;
+  PresentPreference presentPreference = PresentPreference::Balanced;
+  bool swapChainOutdated = false;
+
+  // Thread render dan antrean dari thread UI/JNI
+  std::thread renderThread;
+  StateMailbox<IslandState> targets;
+  // Ukuran surface terakhir (width | height << 32) dari surfaceChanged
+  std::atomic<uint64_t> surfaceSize{0};
+  std::atomic<bool> surfaceChanged{false};
+  // Membangunkan thread render yang tidur saat pulau diam
+  std::mutex wakeMutex;
+  std::condition_variable wakeCondition;
+  bool wakePending = false;
+  bool stopRequested = false;
+
+  // Swapchain lama yang mungkin masih dipakai frame in flight; dihancurkan
+  // lewat FrameTimeline::deferUntilRetired setelah semua frame sebelum
+  // penggantian selesai.
+  struct RetiredSwapchain {
+    VkSwapchainKHR swapChain;
+    std::vector<VkImageView> imageViews;
+    std::vector<VkFramebuffer> framebuffers;
+    std::vector<VkCommandBuffer> commandBuffers;
+    std::vector<VkSemaphore> renderFinishedSemaphores;
+  };
 
   VkRenderPass renderPass = VK_NULL_HANDLE;
+  VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+  std::string cachePath;
+  PipelineCache pipelineCache;
   VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
-  VkPipeline graphicsPipeline = VK_NULL_HANDLE;
+  // Satu pipeline per QualityTier (specialization constant liquid.frag),
+  // semuanya dibangun saat init agar ganti tier tidak pernah compile
+  VkPipeline graphicsPipelines[QUALITY_TIER_COUNT] = {};
 
   VkCommandPool commandPool = VK_NULL_HANDLE;
+  // Recorded once per [frame in flight][swapchain image]; per-frame values
+  // only travel through the uniform ring.
   std::vector<VkCommandBuffer> commandBuffers;
+  // Tier yang direkam per frame slot; slot direkam ulang setelah governor
+  // berganti tier dan frame lama di slot itu selesai
+  std::vector<QualityTier> recordedTiers;
+  // Menjaga 120 fps dengan menurunkan detail shader, bukan menjatuhkan frame
+  QualityGovernor governor;
+  QualityTier activeTier = QualityTier::High;
+
+  UniformRing uniformRing;
+  VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+  VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+  IslandInstanceRing islandRing;
+  // Menampung uniformRing dan islandRing, satu slot per frame in flight
+  FrameUploadArena uploadArena;
+  std::chrono::steady_clock::time_point startTime;
+  // Koefisien kurva fluid intensity dari kernel (AuraFluidCurve); dihitung
+  // di shader per pulau, bukan lewat FFI per frame
+  float fluidCurve[4] = {};
+
+  // Kanal lock-free ke kernel Rust: event masuk di awal frame, telemetri
+  // keluar di akhir frame (keduanya dari thread render)
+  AuraKernelChannel *kernelChannel = nullptr;
+  uint32_t powerMode = 1; // AURA_POWER_BALANCED
+  uint64_t telemetryDropped = 0;
+  // Mode daya yang diminta host dan yang sudah diteruskan ke kernel;
+  // UINT32_MAX = belum ada permintaan
+  std::atomic<uint32_t> requestedPowerMode{UINT32_MAX};
+  uint32_t forwardedPowerMode = UINT32_MAX;
 
+  // Satu timeline semaphore untuk pacing semua frame (fence per slot pada
+  // device Vulkan 1.0/1.1). Semaphore acquire per frame slot, semaphore
+  // present per image swapchain.
+  FrameTimeline frameTimeline;
+  // Present di thread sendiri: vkQueuePresentKHR yang menunggu vsync tidak
+  // lagi menahan simulasi frame berikutnya (lihat FramePresenter)
+  FramePresenter presenter;
+  uint32_t framesInFlight = 2;
+  uint32_t instanceApiVersion = VK_API_VERSION_1_0;
+  bool timelineEnabled = false;
+  // liquid_fast.frag (fp16, sin/cos polinomial) bila device punya
+  // shaderFloat16
+  bool fastMathEnabled = false;
   std::vector<VkSemaphore> imageAvailableSemaphores;
   std::vector<VkSemaphore> renderFinishedSemaphores;
-  std::vector<VkFence> inFlightFences;
-  uint32_t currentFrame = 0;
 
   // Spring Physics State
-  IslandState currentState;
-  IslandState currentVelocity;
+  SpringBatch springs;
+  std::vector<IslandStyle> islandStyles = std::vector<IslandStyle>(1);
+  uint32_t island = 0;
   const float stiffness = 150.0f;
   const float damping = 20.0f;
 
@@ -71,19 +183,29 @@ private:
   bool setupDebugMessenger();
   bool createSurface();
   bool pickPhysicalDevice();
+  bool hasDeviceExtension(const char *name) const;
   bool createLogicalDevice();
-  bool createSwapChain();
+  bool createSwapChain(VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE);
+  bool recreateSwapChain();
+  void destroyRetiredSwapchain(RetiredSwapchain &retired);
   bool createImageViews();
+  bool createRenderFinishedSemaphores();
   bool createRenderPass();
+  bool createDescriptorSetLayout();
+  bool createPipelineCache();
   bool createGraphicsPipeline();
   bool createFramebuffers();
   bool createCommandPool();
+  bool createUniformRing();
+  bool createDescriptorSets();
   bool createCommandBuffers();
+  void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frame,
+                           uint32_t imageIndex);
+  void recordFrameSlot(uint32_t frame);
   bool createSyncObjects();
+  void updateUniforms(uint32_t frame);
 
-  VkShaderModule createShaderModule(const std::vector<uint32_t> &code);
-  uint32_t findMemoryType(uint32_t typeFilter,
-                          VkMemoryPropertyFlags properties);
+  VkShaderModule createShaderModule(const uint32_t *code, size_t size);
 };
 
 #endif
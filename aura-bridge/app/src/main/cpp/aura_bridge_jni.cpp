@@ -11,6 +11,9 @@
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 
 static LiquidRenderer *g_renderer = nullptr;
+static std::string g_cacheDir;
+// Battery saver terakhir dari Kotlin; diterapkan juga ke renderer baru
+static bool g_powerSaving = false;
 
 extern "C" {
 
@@ -31,29 +34,65 @@ Java_com_aura_bridge_AuraBridge_getKernelVersion(JNIEnv *env, jobject thiz) {
   return result;
 }
 
+JNIEXPORT void JNICALL Java_com_aura_bridge_AuraBridge_setCacheDirectory(
+    JNIEnv *env, jobject thiz, jstring path) {
+  const char *chars = env->GetStringUTFChars(path, nullptr);
+  g_cacheDir = chars;
+  env->ReleaseStringUTFChars(path, chars);
+}
+
 JNIEXPORT void JNICALL Java_com_aura_bridge_AuraBridge_startLiquidIsland(
     JNIEnv *env, jobject thiz, jobject surface) {
   ANativeWindow *window = ANativeWindow_fromSurface(env, surface);
   if (window != nullptr && g_renderer != nullptr) {
     LOGI("[Aura Bridge] Initializing Vulkan Renderer on Native Window...");
-    if (g_renderer->init(window)) {
-      LOGI("[Aura Bridge] Vulkan Renderer Ready!");
-      // In a real app, you'd start a render thread here.
-      // For now, we just do one frame to verify.
-      g_renderer->render();
-    }
+    if (!g_cacheDir.empty())
+      g_renderer->setPipelineCachePath(g_cacheDir +
+                                       "/aura_pipeline_cache.bin");
+    g_renderer->setPowerSaving(g_powerSaving);
+    // Vulkan init and every frame run on the renderer's own thread
+    if (g_renderer->start(window))
+      LOGI("[Aura Bridge] Render thread started");
+    else
+      ANativeWindow_release(window);
   } else {
     LOGI("[Aura Bridge] Failed to capture Native Window or Renderer not "
          "initialized.");
   }
 }
 
+JNIEXPORT void JNICALL Java_com_aura_bridge_AuraBridge_resizeLiquidIsland(
+    JNIEnv *env, jobject thiz, jint width, jint height) {
+  if (g_renderer != nullptr) {
+    g_renderer->onSurfaceChanged((uint32_t)width, (uint32_t)height);
+  }
+}
+
+JNIEXPORT void JNICALL
+Java_com_aura_bridge_AuraBridge_stopLiquidIsland(JNIEnv *env, jobject thiz) {
+  if (g_renderer != nullptr) {
+    // Join thread render sebelum surface hilang; renderer baru untuk
+    // surface berikutnya
+    delete g_renderer;
+    g_renderer = new LiquidRenderer();
+    LOGI("[Aura Bridge] Render thread stopped");
+  }
+}
+
+JNIEXPORT void JNICALL Java_com_aura_bridge_AuraBridge_setPowerSaveMode(
+    JNIEnv *env, jobject thiz, jboolean enabled) {
+  g_powerSaving = enabled == JNI_TRUE;
+  if (g_renderer != nullptr)
+    g_renderer->setPowerSaving(g_powerSaving);
+}
+
 JNIEXPORT void JNICALL Java_com_aura_bridge_AuraBridge_updateIslandState(
     JNIEnv *env, jobject thiz, jfloat width, jfloat height, jfloat x, jfloat y,
     jfloat cornerRadius, jfloat deltaTime) {
   if (g_renderer != nullptr) {
+    // Langkah spring diatur thread render sendiri; deltaTime tidak dipakai
     IslandState target = {width, height, x, y, cornerRadius};
-    g_renderer->updateState(target, deltaTime);
+    g_renderer->setTarget(target);
   }
 }
 }
@@ -18,10 +18,29 @@ class AuraBridge {
     /** Mendapatkan versi kernel yang sedang berjalan. */
     external fun getKernelVersion(): String
 
-    /** Memulai rendering Liquid Island pada surface yang diberikan. */
+    /** Lokasi cache pipeline Vulkan (biasanya context.cacheDir). */
+    external fun setCacheDirectory(path: String)
+
+    /** Memulai rendering Liquid Island pada surface yang diberikan (di thread render C++). */
     external fun startLiquidIsland(surface: Any)
 
-    /** Memperbarui dimensi dan posisi pulau dengan animasi spring physics. */
+    /** Menghentikan thread render; wajib sebelum surface dihancurkan. */
+    external fun stopLiquidIsland()
+
+    /** Ukuran surface berubah (rotasi/resize); swapchain dibuat ulang tanpa reinit. */
+    external fun resizeLiquidIsland(width: Int, height: Int)
+
+    /**
+     * Status battery saver Android. Kernel pindah ke mode daya Efficient (atau kembali ke
+     * Balanced) dan renderer membatasi kualitas shader sesuai jawabannya.
+     */
+    external fun setPowerSaveMode(enabled: Boolean)
+
+    /**
+     * Memperbarui dimensi dan posisi pulau dengan animasi spring physics. Tidak pernah menunggu
+     * GPU; thread render memakai target terbaru dan menghitung langkahnya sendiri (deltaTime
+     * diabaikan).
+     */
     external fun updateIslandState(
             width: Float,
             height: Float,
@@ -19,9 +19,11 @@ class AuraSurfaceView(context: Context, private val bridge: AuraBridge) :
 
     override fun surfaceChanged(holder: SurfaceHolder, format: Int, width: Int, height: Int) {
         // Handle perubahan ukuran layar (rotasi)
+        bridge.resizeLiquidIsland(width, height)
     }
 
     override fun surfaceDestroyed(holder: SurfaceHolder) {
-        // Hentikan rendering saat aplikasi ditutup
+        // Hentikan rendering saat aplikasi ditutup; kembali setelah thread render selesai
+        bridge.stopLiquidIsland()
     }
 }
@@ -1,7 +1,12 @@
 package com.aura.bridge
 
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+import android.content.IntentFilter
 import android.graphics.Color
 import android.os.Bundle
+import android.os.PowerManager
 import android.widget.FrameLayout
 import android.widget.TextView
 import androidx.appcompat.app.AppCompatActivity
@@ -9,6 +14,15 @@ import androidx.appcompat.app.AppCompatActivity
 class MainActivity : AppCompatActivity() {
 
     private lateinit var bridge: AuraBridge
+    private var bridgeReady = false
+
+    // Battery saver Android -> mode daya kernel
+    private val powerSaveReceiver =
+            object : BroadcastReceiver() {
+                override fun onReceive(context: Context, intent: Intent) {
+                    updatePowerSaveMode()
+                }
+            }
 
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
@@ -37,8 +51,25 @@ class MainActivity : AppCompatActivity() {
         // Inisialisasi Bridge
         try {
             bridge.initializeBridge()
+            bridge.setCacheDirectory(cacheDir.absolutePath)
+            bridgeReady = true
+            updatePowerSaveMode()
+            registerReceiver(
+                    powerSaveReceiver,
+                    IntentFilter(PowerManager.ACTION_POWER_SAVE_MODE_CHANGED)
+            )
         } catch (e: Exception) {
             statusText.text = "Aura OS Error: Native Bridge Not Ready"
         }
     }
+
+    override fun onDestroy() {
+        if (bridgeReady) unregisterReceiver(powerSaveReceiver)
+        super.onDestroy()
+    }
+
+    private fun updatePowerSaveMode() {
+        val power = getSystemService(Context.POWER_SERVICE) as PowerManager
+        bridge.setPowerSaveMode(power.isPowerSaveMode)
+    }
 }
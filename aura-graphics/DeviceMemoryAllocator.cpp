@@ -0,0 +1,355 @@
+#include "DeviceMemoryAllocator.hpp"
+
+#include <algorithm>
+#include <set>
+
+struct DeviceMemoryBlock {
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  uint8_t *mapped = nullptr;
+  VkDeviceSize size = 0;
+  uint32_t memoryType = 0;
+  MemoryKind kind = MemoryKind::Linear;
+  // Node size of order 0; order k nodes are minNode << k bytes
+  VkDeviceSize minNode = DeviceMemoryAllocator::MIN_NODE_SIZE;
+  // Offsets of the free nodes of each order
+  std::vector<std::set<VkDeviceSize>> freeNodes;
+  uint32_t allocations = 0;
+};
+
+static VkDeviceSize roundUpPow2(VkDeviceSize value) {
+  VkDeviceSize result = 1;
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+static VkDeviceSize roundDownPow2(VkDeviceSize value) {
+  VkDeviceSize result = 1;
+  while (result <= value / 2)
+    result <<= 1;
+  return result;
+}
+
+static uint32_t orderOf(VkDeviceSize nodeSize, VkDeviceSize minNode) {
+  uint32_t order = 0;
+  while ((minNode << order) < nodeSize)
+    order++;
+  return order;
+}
+
+// Takes a free node of `order`, splitting a larger one if needed; false when
+// the block has no room
+static bool takeNode(DeviceMemoryBlock &block, uint32_t order,
+                     VkDeviceSize &offset) {
+  uint32_t from = order;
+  while (from < block.freeNodes.size() && block.freeNodes[from].empty())
+    from++;
+  if (from >= block.freeNodes.size())
+    return false;
+  // Lowest address first keeps the free space at the top of the block
+  offset = *block.freeNodes[from].begin();
+  block.freeNodes[from].erase(block.freeNodes[from].begin());
+  while (from > order) {
+    from--;
+    block.freeNodes[from].insert(offset + (block.minNode << from));
+  }
+  return true;
+}
+
+// Returns a node and merges it with its buddy for as long as that is free
+static void returnNode(DeviceMemoryBlock &block, VkDeviceSize offset,
+                       uint32_t order) {
+  while (order + 1 < block.freeNodes.size()) {
+    VkDeviceSize buddy = offset ^ (block.minNode << order);
+    if (!block.freeNodes[order].erase(buddy))
+      break;
+    offset = std::min(offset, buddy);
+    order++;
+  }
+  block.freeNodes[order].insert(offset);
+}
+
+DeviceMemoryAllocator::DeviceMemoryAllocator() = default;
+
+DeviceMemoryAllocator::~DeviceMemoryAllocator() { destroy(); }
+
+bool DeviceMemoryAllocator::init(VkPhysicalDevice physicalDevice,
+                                 VkDevice dev, VkDeviceSize size) {
+  device = dev;
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(physicalDevice, &props);
+  deviceLimits = props.limits;
+  blockSize = roundDownPow2(std::max(size, MIN_NODE_SIZE));
+  totals = DeviceMemoryStats();
+  return true;
+}
+
+void DeviceMemoryAllocator::destroy() {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto &block : blocks)
+    vkFreeMemory(device, block->memory, nullptr);
+  blocks.clear();
+  totals.blocks = 0;
+  totals.blockBytes = 0;
+  device = VK_NULL_HANDLE;
+}
+
+uint32_t
+DeviceMemoryAllocator::findMemoryType(uint32_t typeBits,
+                                      VkMemoryPropertyFlags required,
+                                      VkMemoryPropertyFlags preferred) const {
+  const VkMemoryPropertyFlags wanted[] = {required | preferred, required};
+  for (VkMemoryPropertyFlags flags : wanted) {
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+      if ((typeBits & (1u << i)) &&
+          (memoryProperties.memoryTypes[i].propertyFlags & flags) == flags)
+        return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+bool DeviceMemoryAllocator::allocate(const VkMemoryRequirements &requirements,
+                                     VkMemoryPropertyFlags required,
+                                     VkMemoryPropertyFlags preferred,
+                                     MemoryKind kind,
+                                     DeviceAllocation &allocation) {
+  uint32_t memoryType =
+      findMemoryType(requirements.memoryTypeBits, required, preferred);
+  if (memoryType == UINT32_MAX)
+    return false;
+  VkMemoryPropertyFlags flags =
+      memoryProperties.memoryTypes[memoryType].propertyFlags;
+  bool coherent = (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+  // Non-coherent nodes are whole flush atoms, so flushing one never
+  // touches its neighbours
+  VkDeviceSize minNode = MIN_NODE_SIZE;
+  if ((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !coherent)
+    minNode = std::max(minNode, roundUpPow2(deviceLimits.nonCoherentAtomSize));
+  // Small heaps (integrated GPUs, old phones) get smaller blocks
+  uint32_t heap = memoryProperties.memoryTypes[memoryType].heapIndex;
+  VkDeviceSize typeBlockSize = std::min(
+      blockSize,
+      std::max(roundDownPow2(memoryProperties.memoryHeaps[heap].size / 8),
+               minNode));
+  VkDeviceSize nodeSize = roundUpPow2(std::max(
+      {requirements.size, requirements.alignment, minNode}));
+
+  std::lock_guard<std::mutex> lock(mutex);
+  allocation = DeviceAllocation();
+  allocation.size = requirements.size;
+  allocation.memoryType = memoryType;
+  allocation.coherent = coherent;
+  if (nodeSize > typeBlockSize / 2)
+    return allocateDedicated(requirements.size, memoryType, allocation);
+
+  uint32_t order = orderOf(nodeSize, minNode);
+  VkDeviceSize offset = 0;
+  DeviceMemoryBlock *block = nullptr;
+  for (auto &candidate : blocks) {
+    if (candidate->memoryType == memoryType && candidate->kind == kind &&
+        takeNode(*candidate, order, offset)) {
+      block = candidate.get();
+      break;
+    }
+  }
+  if (!block) {
+    block = createBlock(memoryType, kind, minNode, typeBlockSize);
+    // Out of room for a whole block; the request alone may still fit
+    if (!block)
+      return allocateDedicated(requirements.size, memoryType, allocation);
+    if (!takeNode(*block, order, offset))
+      return false;
+  }
+
+  block->allocations++;
+  allocation.memory = block->memory;
+  allocation.offset = offset;
+  allocation.mapped = block->mapped ? block->mapped + offset : nullptr;
+  allocation.block = block;
+  allocation.order = order;
+  totals.allocations++;
+  totals.usedBytes += requirements.size;
+  totals.wastedBytes += nodeSize - requirements.size;
+  return true;
+}
+
+bool DeviceMemoryAllocator::allocateDedicated(VkDeviceSize size,
+                                              uint32_t memoryType,
+                                              DeviceAllocation &allocation) {
+  VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+  allocInfo.allocationSize = size;
+  allocInfo.memoryTypeIndex = memoryType;
+  if (vkAllocateMemory(device, &allocInfo, nullptr, &allocation.memory) !=
+      VK_SUCCESS)
+    return false;
+  allocation.mapped = mapMemory(allocation.memory, memoryType);
+  totals.dedicated++;
+  totals.dedicatedBytes += size;
+  totals.allocations++;
+  totals.usedBytes += size;
+  countMemoryObject();
+  return true;
+}
+
+DeviceMemoryBlock *DeviceMemoryAllocator::createBlock(uint32_t memoryType,
+                                                      MemoryKind kind,
+                                                      VkDeviceSize minNode,
+                                                      VkDeviceSize size) {
+  auto block = std::make_unique<DeviceMemoryBlock>();
+  block->memoryType = memoryType;
+  block->kind = kind;
+  block->minNode = minNode;
+  block->size = size;
+
+  VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+  allocInfo.allocationSize = block->size;
+  allocInfo.memoryTypeIndex = memoryType;
+  if (vkAllocateMemory(device, &allocInfo, nullptr, &block->memory) !=
+      VK_SUCCESS)
+    return nullptr;
+  block->mapped =
+      static_cast<uint8_t *>(mapMemory(block->memory, memoryType));
+  block->freeNodes.resize(orderOf(block->size, block->minNode) + 1);
+  block->freeNodes.back().insert(0);
+
+  totals.blocks++;
+  totals.blockBytes += block->size;
+  countMemoryObject();
+  blocks.push_back(std::move(block));
+  return blocks.back().get();
+}
+
+void DeviceMemoryAllocator::releaseBlock(DeviceMemoryBlock *block) {
+  vkFreeMemory(device, block->memory, nullptr);
+  totals.blocks--;
+  totals.blockBytes -= block->size;
+  blocks.erase(std::find_if(blocks.begin(), blocks.end(),
+                            [block](const auto &b) { return b.get() == block; }));
+}
+
+void *DeviceMemoryAllocator::mapMemory(VkDeviceMemory memory,
+                                       uint32_t memoryType) {
+  if (!(memoryProperties.memoryTypes[memoryType].propertyFlags &
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+    return nullptr;
+  void *ptr = nullptr;
+  if (vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &ptr) != VK_SUCCESS)
+    return nullptr;
+  return ptr;
+}
+
+void DeviceMemoryAllocator::countMemoryObject() {
+  totals.peakMemoryObjects =
+      std::max(totals.peakMemoryObjects, totals.memoryObjects());
+}
+
+void DeviceMemoryAllocator::free(DeviceAllocation &allocation) {
+  if (allocation.memory == VK_NULL_HANDLE)
+    return;
+  std::lock_guard<std::mutex> lock(mutex);
+  totals.allocations--;
+  totals.usedBytes -= allocation.size;
+  DeviceMemoryBlock *block = allocation.block;
+  if (!block) {
+    // Unmapped implicitly
+    vkFreeMemory(device, allocation.memory, nullptr);
+    totals.dedicated--;
+    totals.dedicatedBytes -= allocation.size;
+    allocation = DeviceAllocation();
+    return;
+  }
+
+  totals.wastedBytes -= (block->minNode << allocation.order) - allocation.size;
+  returnNode(*block, allocation.offset, allocation.order);
+  allocation = DeviceAllocation();
+  // An empty block goes back to the driver unless it is the last of its
+  // memory type and kind, so an allocation that comes and goes does not
+  // reach the driver every time
+  if (--block->allocations == 0) {
+    for (auto &other : blocks) {
+      if (other.get() != block && other->memoryType == block->memoryType &&
+          other->kind == block->kind) {
+        releaseBlock(block);
+        return;
+      }
+    }
+  }
+}
+
+bool DeviceMemoryAllocator::createBuffer(const VkBufferCreateInfo &info,
+                                         VkMemoryPropertyFlags required,
+                                         VkMemoryPropertyFlags preferred,
+                                         VkBuffer &buffer,
+                                         DeviceAllocation &allocation) {
+  if (vkCreateBuffer(device, &info, nullptr, &buffer) != VK_SUCCESS)
+    return false;
+  VkMemoryRequirements req;
+  vkGetBufferMemoryRequirements(device, buffer, &req);
+  if (allocate(req, required, preferred, MemoryKind::Linear, allocation) &&
+      vkBindBufferMemory(device, buffer, allocation.memory,
+                         allocation.offset) == VK_SUCCESS)
+    return true;
+  destroyBuffer(buffer, allocation);
+  return false;
+}
+
+bool DeviceMemoryAllocator::createImage(const VkImageCreateInfo &info,
+                                        VkMemoryPropertyFlags required,
+                                        VkMemoryPropertyFlags preferred,
+                                        VkImage &image,
+                                        DeviceAllocation &allocation) {
+  if (vkCreateImage(device, &info, nullptr, &image) != VK_SUCCESS)
+    return false;
+  VkMemoryRequirements req;
+  vkGetImageMemoryRequirements(device, image, &req);
+  MemoryKind kind = info.tiling == VK_IMAGE_TILING_OPTIMAL
+                        ? MemoryKind::Optimal
+                        : MemoryKind::Linear;
+  if (allocate(req, required, preferred, kind, allocation) &&
+      vkBindImageMemory(device, image, allocation.memory, allocation.offset) ==
+          VK_SUCCESS)
+    return true;
+  destroyImage(image, allocation);
+  return false;
+}
+
+void DeviceMemoryAllocator::destroyBuffer(VkBuffer &buffer,
+                                          DeviceAllocation &allocation) {
+  vkDestroyBuffer(device, buffer, nullptr);
+  buffer = VK_NULL_HANDLE;
+  free(allocation);
+}
+
+void DeviceMemoryAllocator::destroyImage(VkImage &image,
+                                         DeviceAllocation &allocation) {
+  vkDestroyImage(device, image, nullptr);
+  image = VK_NULL_HANDLE;
+  free(allocation);
+}
+
+void DeviceMemoryAllocator::flush(const DeviceAllocation &allocation,
+                                  VkDeviceSize offset,
+                                  VkDeviceSize size) const {
+  if (allocation.coherent || !allocation.mapped || size == 0)
+    return;
+  VkDeviceSize atom = std::max<VkDeviceSize>(deviceLimits.nonCoherentAtomSize,
+                                             1);
+  VkDeviceSize begin = (allocation.offset + offset) / atom * atom;
+  VkDeviceSize end =
+      (allocation.offset + offset + size + atom - 1) / atom * atom;
+  VkMappedMemoryRange range = {VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+  range.memory = allocation.memory;
+  range.offset = begin;
+  // Nodes of a block are whole atoms; a dedicated allocation may end
+  // mid-atom, where only VK_WHOLE_SIZE reaches its end
+  range.size = !allocation.block && end > allocation.size ? VK_WHOLE_SIZE
+                                                          : end - begin;
+  vkFlushMappedMemoryRanges(device, 1, &range);
+}
+
+DeviceMemoryStats DeviceMemoryAllocator::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return totals;
+}
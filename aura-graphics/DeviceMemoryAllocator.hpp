@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+struct DeviceMemoryBlock;
+
+// Resources that may share a block. Linear ones (buffers) and optimally
+// tiled images are kept in separate blocks so neighbours never have to be
+// padded to bufferImageGranularity.
+enum class MemoryKind : uint32_t { Linear = 0, Optimal = 1 };
+
+/**
+ * @brief A range of device memory handed out by DeviceMemoryAllocator.
+ */
+struct DeviceAllocation {
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  // As requested; the allocator may reserve more (see wastedBytes)
+  VkDeviceSize size = 0;
+  // Host address of `offset` when the memory is host visible (blocks stay
+  // mapped for their lifetime), else null
+  void *mapped = nullptr;
+  uint32_t memoryType = 0;
+  bool coherent = true;
+
+  // Owned by the allocator: the shared block (null for a dedicated
+  // VkDeviceMemory) and the buddy order of the node
+  DeviceMemoryBlock *block = nullptr;
+  uint32_t order = 0;
+};
+
+struct DeviceMemoryStats {
+  // Shared blocks and allocations with a VkDeviceMemory of their own; their
+  // sum is what counts against maxMemoryAllocationCount
+  uint32_t blocks = 0;
+  uint32_t dedicated = 0;
+  uint32_t peakMemoryObjects = 0;
+  // Live allocations, shared and dedicated
+  uint32_t allocations = 0;
+  // Bytes reserved by shared blocks and by dedicated allocations
+  VkDeviceSize blockBytes = 0;
+  VkDeviceSize dedicatedBytes = 0;
+  // Bytes requested by live allocations
+  VkDeviceSize usedBytes = 0;
+  // Bytes lost to rounding requests up to a buddy node
+  VkDeviceSize wastedBytes = 0;
+
+  uint32_t memoryObjects() const { return blocks + dedicated; }
+  // Block bytes no allocation holds
+  VkDeviceSize freeBytes() const {
+    return blockBytes + dedicatedBytes - usedBytes - wastedBytes;
+  }
+};
+
+/**
+ * @brief Sub-allocator for Vulkan device memory.
+ *
+ * Memory is taken from the driver in large blocks (DEFAULT_BLOCK_SIZE, or
+ * an eighth of a small heap) per memory type and MemoryKind, and split with
+ * a buddy allocator: requests round up to a power of two of at least
+ * MIN_NODE_SIZE, which also satisfies their alignment, and freed nodes
+ * merge with their buddy right away. Requests over half a block get a
+ * VkDeviceMemory of their own. Host-visible blocks are mapped once.
+ *
+ * Long-lived resources (rings, render targets, tile buffers) allocate here;
+ * per-frame upload data goes through a FrameUploadArena built on it.
+ * Written against the C API so the desktop app and the Android renderer
+ * share it. Thread-safe; allocations are expected at init and on resizes,
+ * not per frame.
+ */
+class DeviceMemoryAllocator {
+public:
+  static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull << 20;
+  static constexpr VkDeviceSize MIN_NODE_SIZE = 256;
+
+  DeviceMemoryAllocator();
+  ~DeviceMemoryAllocator();
+  DeviceMemoryAllocator(const DeviceMemoryAllocator &) = delete;
+  DeviceMemoryAllocator &operator=(const DeviceMemoryAllocator &) = delete;
+
+  // blockSize is rounded down to a power of two.
+  bool init(VkPhysicalDevice physicalDevice, VkDevice device,
+            VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+  // Every allocation must have been freed; releases the blocks.
+  void destroy();
+
+  // A memory type allowed by typeBits with all `required` flags, preferring
+  // one that also has `preferred`; UINT32_MAX if there is none.
+  uint32_t findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required,
+                          VkMemoryPropertyFlags preferred = 0) const;
+
+  bool allocate(const VkMemoryRequirements &requirements,
+                VkMemoryPropertyFlags required,
+                VkMemoryPropertyFlags preferred, MemoryKind kind,
+                DeviceAllocation &allocation);
+  // Returns the range to its block (or the dedicated memory to the driver)
+  // and resets `allocation`. The GPU must be done with it; defer the call
+  // through FrameTimeline::deferUntilRetired() otherwise.
+  void free(DeviceAllocation &allocation);
+
+  // vkCreateBuffer/vkCreateImage, allocate and bind in one step. On failure
+  // nothing is left behind.
+  bool createBuffer(const VkBufferCreateInfo &info,
+                    VkMemoryPropertyFlags required,
+                    VkMemoryPropertyFlags preferred, VkBuffer &buffer,
+                    DeviceAllocation &allocation);
+  bool createImage(const VkImageCreateInfo &info,
+                   VkMemoryPropertyFlags required,
+                   VkMemoryPropertyFlags preferred, VkImage &image,
+                   DeviceAllocation &allocation);
+  void destroyBuffer(VkBuffer &buffer, DeviceAllocation &allocation);
+  void destroyImage(VkImage &image, DeviceAllocation &allocation);
+
+  // Makes CPU writes to [offset, offset + size) of a mapped allocation
+  // visible; a no-op on coherent memory.
+  void flush(const DeviceAllocation &allocation, VkDeviceSize offset,
+             VkDeviceSize size) const;
+
+  DeviceMemoryStats stats() const;
+  const VkPhysicalDeviceLimits &limits() const { return deviceLimits; }
+  VkDevice deviceHandle() const { return device; }
+
+private:
+  bool allocateDedicated(VkDeviceSize size, uint32_t memoryType,
+                         DeviceAllocation &allocation);
+  DeviceMemoryBlock *createBlock(uint32_t memoryType, MemoryKind kind,
+                                 VkDeviceSize minNode, VkDeviceSize size);
+  void releaseBlock(DeviceMemoryBlock *block);
+  void *mapMemory(VkDeviceMemory memory, uint32_t memoryType);
+  void countMemoryObject();
+
+  VkDevice device = VK_NULL_HANDLE;
+  VkPhysicalDeviceMemoryProperties memoryProperties = {};
+  VkPhysicalDeviceLimits deviceLimits = {};
+  VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE;
+
+  mutable std::mutex mutex;
+  std::vector<std::unique_ptr<DeviceMemoryBlock>> blocks;
+  DeviceMemoryStats totals;
+};
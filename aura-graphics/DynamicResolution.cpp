@@ -0,0 +1,62 @@
+#include "DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+DynamicResolution::DynamicResolution(float scale,
+                                     DynamicResolutionSettings settings)
+    : settings(settings), current(quantize(scale)) {}
+
+float DynamicResolution::quantize(float scale) const {
+  float stepped = std::round(scale / settings.step) * settings.step;
+  return std::clamp(stepped, settings.minScale, settings.maxScale);
+}
+
+void DynamicResolution::reset(float scale) {
+  current = quantize(scale);
+  primed = false;
+  settling = overBudget = underBudget = 0;
+}
+
+void DynamicResolution::switchTo(float scale) {
+  current = scale;
+  changeCount++;
+  primed = false;
+  overBudget = underBudget = 0;
+  settling = settings.settleFrames;
+}
+
+bool DynamicResolution::addFrame(double frameCostMs) {
+  if (settling > 0) {
+    settling--;
+    return false;
+  }
+  if (!primed) {
+    average = frameCostMs;
+    primed = true;
+  } else {
+    average += settings.smoothing * (frameCostMs - average);
+  }
+  if (average <= 0.0)
+    return false;
+
+  double budget = settings.targetFrameMs;
+  overBudget = average > budget * settings.downshiftRatio ? overBudget + 1 : 0;
+  if (overBudget >= settings.downshiftFrames) {
+    // Cost ~ scale^2; round down so one correction is usually enough
+    double fit = current * std::sqrt(budget * settings.targetRatio / average);
+    float next = std::floor((float)fit / settings.step) * settings.step;
+    next = std::max(std::min(next, current - settings.step), settings.minScale);
+    if (next >= current)
+      return false;
+    switchTo(next);
+    return true;
+  }
+
+  underBudget = average < budget * settings.upshiftRatio ? underBudget + 1 : 0;
+  if (underBudget >= settings.settleFrames && !atMaximum()) {
+    switchTo(std::min(current + settings.step, settings.maxScale));
+    return true;
+  }
+  return false;
+}
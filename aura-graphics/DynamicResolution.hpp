@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Tuning of DynamicResolution; the defaults hold 120 fps.
+ */
+struct DynamicResolutionSettings {
+  double targetFrameMs = 1000.0 / 120.0;
+  // Shrink when the smoothed frame cost exceeds this share of the budget for
+  // downshiftFrames frames, grow back one step when it stays below the lower
+  // one for settleFrames.
+  double downshiftRatio = 0.9;
+  uint32_t downshiftFrames = 5;
+  double upshiftRatio = 0.6;
+  // Cost the shrink aims for, as a share of the budget.
+  double targetRatio = 0.75;
+  float minScale = 0.5f;
+  float maxScale = 1.0f;
+  // Scales are multiples of this, so small cost changes do not re-record.
+  float step = 1.0f / 16.0f;
+  // Frames ignored after a change while the new cost settles in.
+  uint32_t settleFrames = 30;
+  // Weight of the newest frame in the moving average.
+  double smoothing = 0.1;
+};
+
+/**
+ * @brief Picks the liquid layer's render scale from measured frame cost.
+ *
+ * The liquid's shading cost follows the pixel count, i.e. the square of the
+ * scale. Over budget, the scale drops at once to what that estimate says
+ * fits targetRatio of the budget; with plenty of headroom it climbs back
+ * one step per settle period, so it approaches the limit from below instead
+ * of oscillating around it. Pure CPU code, fed like QualityGovernor.
+ */
+class DynamicResolution {
+public:
+  explicit DynamicResolution(float scale = 1.0f,
+                             DynamicResolutionSettings settings = {});
+
+  // Returns true when the scale changed.
+  bool addFrame(double frameCostMs);
+  void reset(float scale);
+
+  float scale() const { return current; }
+  bool atMinimum() const { return current <= settings.minScale; }
+  bool atMaximum() const { return current >= settings.maxScale; }
+  double smoothedMs() const { return average; }
+  uint64_t changes() const { return changeCount; }
+
+private:
+  float quantize(float scale) const;
+  void switchTo(float scale);
+
+  DynamicResolutionSettings settings;
+  float current;
+  double average = 0.0;
+  bool primed = false;
+  uint32_t settling = 0;
+  uint32_t overBudget = 0;
+  uint32_t underBudget = 0;
+  uint64_t changeCount = 0;
+};
@@ -0,0 +1,77 @@
+#include "FramePresenter.hpp"
+
+bool FramePresenter::start(VkQueue presentQueue, uint32_t depth) {
+  if (worker.joinable())
+    return false;
+  queue = presentQueue;
+  maxPending = depth < 1 ? 1 : depth;
+  stopping = false;
+  result = VK_SUCCESS;
+  worker = std::thread(&FramePresenter::run, this);
+  return true;
+}
+
+void FramePresenter::stop() {
+  if (!worker.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  workReady.notify_one();
+  worker.join();
+}
+
+void FramePresenter::push(VkSwapchainKHR swapChain, uint32_t imageIndex,
+                          VkSemaphore waitSemaphore) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (pending.size() >= maxPending) {
+    stalls++;
+    spaceFree.wait(lock, [this] { return pending.size() < maxPending; });
+  }
+  pending.push_back({swapChain, imageIndex, waitSemaphore});
+  workReady.notify_one();
+}
+
+void FramePresenter::drain() {
+  std::unique_lock<std::mutex> lock(mutex);
+  spaceFree.wait(lock, [this] { return pending.empty(); });
+}
+
+VkResult FramePresenter::takeResult() {
+  std::lock_guard<std::mutex> lock(mutex);
+  VkResult taken = result;
+  result = VK_SUCCESS;
+  return taken;
+}
+
+void FramePresenter::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    workReady.wait(lock, [this] { return stopping || !pending.empty(); });
+    // Stop only once everything pushed has been presented
+    if (pending.empty())
+      break;
+    Present present = pending.front();
+    lock.unlock();
+
+    VkPresentInfoKHR presentInfo = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &present.waitSemaphore;
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &present.swapChain;
+    presentInfo.pImageIndices = &present.imageIndex;
+    VkResult presented;
+    {
+      std::lock_guard<std::mutex> queueGuard(queueLock);
+      presented = vkQueuePresentKHR(queue, &presentInfo);
+    }
+
+    lock.lock();
+    // Keep the first error; SUBOPTIMAL only until something worse arrives
+    if (presented < 0 ? result >= 0 : result == VK_SUCCESS)
+      result = presented;
+    pending.pop_front();
+    spaceFree.notify_all();
+  }
+}
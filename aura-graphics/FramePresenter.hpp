@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vulkan/vulkan.h>
+
+/**
+ * @brief Presents swapchain images on a thread of its own.
+ *
+ * Under FIFO, vkQueuePresentKHR may block until a vblank frees an image.
+ * When it runs on the render thread, that wait delays the next frame's
+ * simulation and recording. With a FramePresenter the render thread submits
+ * frame N, push()es its present and moves on to frame N + 1 while this
+ * thread presents N. The queue between the two is bounded: push() blocks
+ * once depth presents are outstanding, so the render thread cannot run away
+ * from the display.
+ *
+ * The present queue is usually the graphics queue, and Vulkan requires
+ * queue access to be externally synchronized. Hold queueMutex() around
+ * every other use of that queue (vkQueueSubmit*) while the presenter runs,
+ * and drain() before vkDeviceWaitIdle or before destroying a swapchain
+ * that has presents pending. Written against the C API so the desktop app
+ * and the Android renderer share it.
+ */
+class FramePresenter {
+public:
+  ~FramePresenter() { stop(); }
+
+  // depth: presents that may be queued or in progress, at least 1.
+  bool start(VkQueue queue, uint32_t depth);
+  // Presents what is still queued, then joins the thread.
+  void stop();
+  bool running() const { return worker.joinable(); }
+
+  // Queues a present of `imageIndex` once `waitSemaphore` is signaled.
+  // Blocks while depth presents are outstanding.
+  void push(VkSwapchainKHR swapChain, uint32_t imageIndex,
+            VkSemaphore waitSemaphore);
+  // Blocks until every pushed present has returned.
+  void drain();
+  // The first error since the last call, otherwise VK_SUBOPTIMAL_KHR if any
+  // present reported it, otherwise VK_SUCCESS. Resets it.
+  VkResult takeResult();
+
+  std::mutex &queueMutex() { return queueLock; }
+  // Pushes that found the queue full and had to wait.
+  uint64_t stalledPushes() const { return stalls; }
+
+private:
+  void run();
+
+  struct Present {
+    VkSwapchainKHR swapChain;
+    uint32_t imageIndex;
+    VkSemaphore waitSemaphore;
+  };
+
+  VkQueue queue = VK_NULL_HANDLE;
+  uint32_t maxPending = 1;
+  std::thread worker;
+  std::mutex queueLock;
+
+  // Guards everything below
+  std::mutex mutex;
+  std::condition_variable workReady;
+  std::condition_variable spaceFree;
+  // front() is the present in progress; it is popped once it returns
+  std::deque<Present> pending;
+  bool stopping = false;
+  VkResult result = VK_SUCCESS;
+  uint64_t stalls = 0;
+};
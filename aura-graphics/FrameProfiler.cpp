@@ -0,0 +1,268 @@
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+static const vk::QueryPipelineStatisticFlags kStatisticFlags =
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+static const uint32_t kStatisticCount = 3;
+static const uint32_t kQueriesPerSlot = GpuFrameStats::MAX_PASSES * 2;
+
+void FrameProfiler::init(vk::PhysicalDevice physicalDevice, vk::Device dev,
+                         uint32_t queueFamily, uint32_t frames,
+                         bool pipelineStatistics) {
+  device = dev;
+  framesInFlight = frames;
+  slots.assign(frames, SlotState{});
+  epochTime = Clock::now();
+
+  auto props = physicalDevice.getProperties();
+  auto families = physicalDevice.getQueueFamilyProperties();
+  uint32_t validBits = families[queueFamily].timestampValidBits;
+  timestampsSupported = validBits > 0 && props.limits.timestampPeriod > 0.0f;
+  if (!timestampsSupported) {
+    std::printf("[FrameProfiler] Timestamps unsupported on this queue, GPU "
+                "timing disabled.\n");
+    return;
+  }
+  timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+  nsPerTick = props.limits.timestampPeriod;
+
+  vk::QueryPoolCreateInfo timestampInfo({}, vk::QueryType::eTimestamp,
+                                        kQueriesPerSlot * framesInFlight);
+  timestampPool = device.createQueryPool(timestampInfo);
+
+  statisticsEnabled = pipelineStatistics;
+  if (statisticsEnabled) {
+    vk::QueryPoolCreateInfo statisticsInfo(
+        {}, vk::QueryType::ePipelineStatistics, framesInFlight,
+        kStatisticFlags);
+    statisticsPool = device.createQueryPool(statisticsInfo);
+  }
+}
+
+void FrameProfiler::calibrate(vk::Queue queue, vk::CommandPool commandPool) {
+  if (!timestampsSupported)
+    return;
+
+  // Write a single timestamp and wait for it; the GPU tick value is pinned
+  // to the midpoint of the CPU submit/complete window.
+  vk::CommandBufferAllocateInfo allocInfo(commandPool,
+                                          vk::CommandBufferLevel::ePrimary, 1);
+  vk::CommandBuffer cb = device.allocateCommandBuffers(allocInfo)[0];
+  vk::CommandBufferBeginInfo beginInfo(
+      vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+  cb.begin(beginInfo);
+  cb.resetQueryPool(timestampPool, 0, 1);
+  cb.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, timestampPool,
+                    0);
+  cb.end();
+
+  vk::Fence fence = device.createFence({});
+  vk::SubmitInfo submitInfo(0, nullptr, nullptr, 1, &cb);
+  auto before = Clock::now();
+  queue.submit(submitInfo, fence);
+  if (device.waitForFences(1, &fence, VK_TRUE, UINT64_MAX) !=
+      vk::Result::eSuccess)
+    throw std::runtime_error("failed to calibrate GPU timestamps!");
+  auto after = Clock::now();
+
+  uint64_t ticks = 0;
+  if (device.getQueryPoolResults(timestampPool, 0, 1, sizeof(ticks), &ticks,
+                                 sizeof(ticks),
+                                 vk::QueryResultFlagBits::e64 |
+                                     vk::QueryResultFlagBits::eWait) !=
+      vk::Result::eSuccess)
+    throw std::runtime_error("failed to read calibration timestamp!");
+
+  gpuAnchorTicks = ticks & timestampMask;
+  cpuAnchorMs = (sinceEpochMs(before) + sinceEpochMs(after)) * 0.5;
+  std::printf("[FrameProfiler] GPU/CPU clocks calibrated (+/- %.3f ms), "
+              "%.2f ns/tick.\n",
+              (sinceEpochMs(after) - sinceEpochMs(before)) * 0.5, nsPerTick);
+
+  device.destroyFence(fence);
+  device.freeCommandBuffers(commandPool, cb);
+}
+
+void FrameProfiler::destroy() {
+  if (timestampPool)
+    device.destroyQueryPool(timestampPool);
+  if (statisticsPool)
+    device.destroyQueryPool(statisticsPool);
+  timestampPool = nullptr;
+  statisticsPool = nullptr;
+}
+
+void FrameProfiler::beginFrame(vk::CommandBuffer cb, uint32_t frame) {
+  if (!timestampsSupported)
+    return;
+  SlotState &slot = slots[frame];
+  slot.passCount = 0;
+  slot.passOpen = false;
+
+  cb.resetQueryPool(timestampPool, frame * kQueriesPerSlot, kQueriesPerSlot);
+  if (statisticsEnabled) {
+    cb.resetQueryPool(statisticsPool, frame, 1);
+    cb.beginQuery(statisticsPool, frame, {});
+  }
+}
+
+void FrameProfiler::endFrame(vk::CommandBuffer cb, uint32_t frame) {
+  if (!timestampsSupported)
+    return;
+  if (slots[frame].passOpen)
+    endPass(cb, frame);
+  if (statisticsEnabled)
+    cb.endQuery(statisticsPool, frame);
+}
+
+void FrameProfiler::beginPass(vk::CommandBuffer cb, uint32_t frame,
+                              const char *name) {
+  if (!timestampsSupported)
+    return;
+  SlotState &slot = slots[frame];
+  if (slot.passOpen)
+    endPass(cb, frame);
+  if (slot.passCount >= GpuFrameStats::MAX_PASSES)
+    return;
+  slot.names[slot.passCount] = name;
+  slot.passOpen = true;
+  cb.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, timestampPool,
+                    frame * kQueriesPerSlot + slot.passCount * 2);
+}
+
+void FrameProfiler::endPass(vk::CommandBuffer cb, uint32_t frame) {
+  if (!timestampsSupported)
+    return;
+  SlotState &slot = slots[frame];
+  if (!slot.passOpen)
+    return;
+  cb.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, timestampPool,
+                    frame * kQueriesPerSlot + slot.passCount * 2 + 1);
+  slot.passOpen = false;
+  slot.passCount++;
+}
+
+void FrameProfiler::markSubmit(uint32_t frame, uint64_t frameNumber) {
+  if (!timestampsSupported)
+    return;
+  SlotState &slot = slots[frame];
+  slot.submitted = true;
+  slot.frameNumber = frameNumber;
+  slot.submitTime = Clock::now();
+}
+
+bool FrameProfiler::collect(uint32_t frame) {
+  if (!timestampsSupported)
+    return false;
+  SlotState &slot = slots[frame];
+  if (!slot.submitted || slot.passCount == 0)
+    return false;
+  slot.submitted = false;
+
+  // Each value is followed by its availability word.
+  std::array<uint64_t, kQueriesPerSlot * 2> data{};
+  uint32_t queryCount = slot.passCount * 2;
+  vk::Result result = device.getQueryPoolResults(
+      timestampPool, frame * kQueriesPerSlot, queryCount,
+      queryCount * 2 * sizeof(uint64_t), data.data(), 2 * sizeof(uint64_t),
+      vk::QueryResultFlagBits::e64 |
+          vk::QueryResultFlagBits::eWithAvailability);
+  if (result != vk::Result::eSuccess && result != vk::Result::eNotReady)
+    return false;
+  for (uint32_t q = 0; q < queryCount; q++) {
+    if (data[q * 2 + 1] == 0)
+      return false;
+  }
+
+  GpuFrameStats stats;
+  stats.valid = true;
+  stats.frameNumber = slot.frameNumber;
+  stats.cpuSubmitMs = sinceEpochMs(slot.submitTime);
+  stats.passCount = slot.passCount;
+  for (uint32_t p = 0; p < slot.passCount; p++) {
+    stats.passes[p].name = slot.names[p];
+    stats.passes[p].startMs = ticksToCpuMs(data[p * 4]);
+    stats.passes[p].endMs = ticksToCpuMs(data[p * 4 + 2]);
+  }
+
+  if (statisticsEnabled) {
+    std::array<uint64_t, kStatisticCount + 1> statData{};
+    result = device.getQueryPoolResults(
+        statisticsPool, frame, 1, sizeof(statData), statData.data(),
+        sizeof(statData),
+        vk::QueryResultFlagBits::e64 |
+            vk::QueryResultFlagBits::eWithAvailability);
+    if ((result == vk::Result::eSuccess || result == vk::Result::eNotReady) &&
+        statData[kStatisticCount] != 0) {
+      stats.hasPipelineStatistics = true;
+      stats.vertexInvocations = statData[0];
+      stats.clippingPrimitives = statData[1];
+      stats.fragmentInvocations = statData[2];
+    }
+  }
+
+  latestStats = stats;
+  framesCollected++;
+  frameGpuTotalMs += stats.gpuTimeMs();
+  queueLatencyTotalMs += stats.gpuStartMs() - stats.cpuSubmitMs;
+  fragmentTotal += stats.fragmentInvocations;
+  for (uint32_t p = 0; p < stats.passCount; p++) {
+    const GpuPassTiming &pass = stats.passes[p];
+    PassSummary *summary = nullptr;
+    for (auto &s : summaries) {
+      if (std::strcmp(s.name, pass.name) == 0)
+        summary = &s;
+    }
+    if (!summary) {
+      summaries.push_back({pass.name});
+      summary = &summaries.back();
+    }
+    double ms = pass.durationMs();
+    summary->count++;
+    summary->totalMs += ms;
+    summary->minMs = std::min(summary->minMs, ms);
+    summary->maxMs = std::max(summary->maxMs, ms);
+  }
+  return true;
+}
+
+void FrameProfiler::printSummary() const {
+  if (!timestampsSupported || framesCollected == 0)
+    return;
+  std::printf("------------------------------------------\n");
+  std::printf("  AURA OS | GPU FRAME PROFILE | %llu frames\n",
+              (unsigned long long)framesCollected);
+  std::printf("------------------------------------------\n");
+  std::printf("  GPU frame      avg %8.3f ms\n",
+              frameGpuTotalMs / framesCollected);
+  std::printf("  Submit->GPU    avg %8.3f ms\n",
+              queueLatencyTotalMs / framesCollected);
+  for (const auto &s : summaries) {
+    std::printf("  Pass %-10s avg %8.3f ms | min %8.3f | max %8.3f\n", s.name,
+                s.totalMs / s.count, s.minMs, s.maxMs);
+  }
+  if (statisticsEnabled) {
+    std::printf("  Fragment invocations avg %llu/frame\n",
+                (unsigned long long)(fragmentTotal / framesCollected));
+  }
+}
+
+double FrameProfiler::ticksToCpuMs(uint64_t ticks) const {
+  // Wrap-aware signed delta; handles counters narrower than 64 bits and
+  // timestamps taken before the calibration anchor.
+  uint64_t diff = ((ticks & timestampMask) - gpuAnchorTicks) & timestampMask;
+  int64_t delta = diff > (timestampMask >> 1)
+                      ? (int64_t)diff - (int64_t)timestampMask - 1
+                      : (int64_t)diff;
+  return cpuAnchorMs + delta * nsPerTick * 1e-6;
+}
+
+double FrameProfiler::sinceEpochMs(Clock::time_point t) const {
+  return std::chrono::duration<double, std::milli>(t - epochTime).count();
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+/**
+ * @brief GPU time of one bracketed pass, on the CPU steady_clock timeline
+ * (milliseconds since FrameProfiler::epoch()).
+ */
+struct GpuPassTiming {
+  const char *name = nullptr;
+  double startMs = 0.0;
+  double endMs = 0.0;
+  double durationMs() const { return endMs - startMs; }
+};
+
+/**
+ * @brief Everything the profiler knows about one retired frame.
+ */
+struct GpuFrameStats {
+  static constexpr uint32_t MAX_PASSES = 8;
+
+  bool valid = false;
+  uint64_t frameNumber = 0;
+  double cpuSubmitMs = 0.0;
+  uint32_t passCount = 0;
+  std::array<GpuPassTiming, MAX_PASSES> passes{};
+
+  // Only filled in when pipeline statistics are enabled and supported.
+  bool hasPipelineStatistics = false;
+  uint64_t vertexInvocations = 0;
+  uint64_t clippingPrimitives = 0;
+  uint64_t fragmentInvocations = 0;
+
+  double gpuStartMs() const { return passCount ? passes[0].startMs : 0.0; }
+  double gpuEndMs() const {
+    return passCount ? passes[passCount - 1].endMs : 0.0;
+  }
+  double gpuTimeMs() const { return gpuEndMs() - gpuStartMs(); }
+};
+
+/**
+ * @brief Per-frame GPU instrumentation using timestamp and pipeline-statistics
+ * queries.
+ *
+ * Query pools hold one slot per frame in flight. Each slot is reset at the
+ * start of its command buffer and read back only after that frame's fence has
+ * signaled, so results are fetched without VK_QUERY_RESULT_WAIT_BIT and never
+ * stall the CPU. GPU ticks are mapped onto the CPU steady_clock with a
+ * submit-and-wait calibration at startup.
+ */
+class FrameProfiler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  void init(vk::PhysicalDevice physicalDevice, vk::Device device,
+            uint32_t queueFamily, uint32_t framesInFlight,
+            bool pipelineStatistics);
+  void calibrate(vk::Queue queue, vk::CommandPool commandPool);
+  void destroy();
+
+  bool enabled() const { return timestampsSupported; }
+  Clock::time_point epoch() const { return epochTime; }
+
+  // Recording; call outside of a render pass.
+  void beginFrame(vk::CommandBuffer cb, uint32_t frame);
+  void endFrame(vk::CommandBuffer cb, uint32_t frame);
+  void beginPass(vk::CommandBuffer cb, uint32_t frame, const char *name);
+  void endPass(vk::CommandBuffer cb, uint32_t frame);
+
+  // Command buffers may be recorded once and resubmitted; results are only
+  // collected for slots submitted since the last collect().
+  void markSubmit(uint32_t frame, uint64_t frameNumber);
+
+  // Reads the slot's results; only call once the frame's fence is signaled.
+  bool collect(uint32_t frame);
+
+  const GpuFrameStats &latest() const { return latestStats; }
+  void printSummary() const;
+
+private:
+  struct PassSummary {
+    const char *name;
+    uint64_t count = 0;
+    double totalMs = 0.0;
+    double minMs = 1e30;
+    double maxMs = 0.0;
+  };
+
+  vk::Device device;
+  vk::QueryPool timestampPool;
+  vk::QueryPool statisticsPool;
+  bool timestampsSupported = false;
+  bool statisticsEnabled = false;
+  uint32_t framesInFlight = 0;
+  uint64_t timestampMask = ~0ull;
+  double nsPerTick = 1.0;
+
+  Clock::time_point epochTime;
+  uint64_t gpuAnchorTicks = 0;
+  double cpuAnchorMs = 0.0;
+
+  struct SlotState {
+    bool submitted = false;
+    uint64_t frameNumber = 0;
+    uint32_t passCount = 0;
+    bool passOpen = false;
+    std::array<const char *, GpuFrameStats::MAX_PASSES> names{};
+    Clock::time_point submitTime;
+  };
+  std::vector<SlotState> slots;
+
+  GpuFrameStats latestStats;
+  uint64_t framesCollected = 0;
+  uint64_t fragmentTotal = 0;
+  double queueLatencyTotalMs = 0.0;
+  double frameGpuTotalMs = 0.0;
+  std::vector<PassSummary> summaries;
+
+  double ticksToCpuMs(uint64_t ticks) const;
+  double sinceEpochMs(Clock::time_point t) const;
+};
@@ -0,0 +1,199 @@
+#include "FrameTimeline.hpp"
+
+bool FrameTimeline::supported(VkInstance instance,
+                              VkPhysicalDevice physicalDevice) {
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(physicalDevice, &props);
+  if (props.apiVersion < VK_API_VERSION_1_3)
+    return false;
+  auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2)vkGetInstanceProcAddr(
+      instance, "vkGetPhysicalDeviceFeatures2");
+  if (!getFeatures2)
+    return false;
+  VkPhysicalDeviceVulkan13Features features13 = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+  VkPhysicalDeviceVulkan12Features features12 = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, &features13};
+  VkPhysicalDeviceFeatures2 features = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, &features12};
+  getFeatures2(physicalDevice, &features);
+  return features12.timelineSemaphore && features13.synchronization2;
+}
+
+bool FrameTimeline::init(VkDevice dev, uint32_t depth, bool useTimeline) {
+  device = dev;
+  frameDepth = depth < 1 ? 1 : (depth > MAX_DEPTH ? MAX_DEPTH : depth);
+  nextFrame = 0;
+  retired = 0;
+
+  if (useTimeline) {
+    waitSemaphores = (PFN_vkWaitSemaphores)vkGetDeviceProcAddr(
+        device, "vkWaitSemaphores");
+    getSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValue)
+        vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValue");
+    queueSubmit2 =
+        (PFN_vkQueueSubmit2)vkGetDeviceProcAddr(device, "vkQueueSubmit2");
+    if (!waitSemaphores || !getSemaphoreCounterValue || !queueSubmit2)
+      return false;
+    VkSemaphoreTypeCreateInfo typeInfo = {
+        VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+    VkSemaphoreCreateInfo semaphoreInfo = {
+        VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &typeInfo};
+    return vkCreateSemaphore(device, &semaphoreInfo, nullptr, &timeline) ==
+           VK_SUCCESS;
+  }
+
+  fences.assign(frameDepth, VK_NULL_HANDLE);
+  fenceFrames.assign(frameDepth, UINT64_MAX);
+  VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+  for (auto &fence : fences) {
+    if (vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+      return false;
+  }
+  return true;
+}
+
+void FrameTimeline::destroy() {
+  if (device == VK_NULL_HANDLE)
+    return;
+  retired = nextFrame;
+  runDeferred();
+  if (timeline != VK_NULL_HANDLE)
+    vkDestroySemaphore(device, timeline, nullptr);
+  for (auto fence : fences)
+    vkDestroyFence(device, fence, nullptr);
+  timeline = VK_NULL_HANDLE;
+  fences.clear();
+  fenceFrames.clear();
+  device = VK_NULL_HANDLE;
+}
+
+uint64_t FrameTimeline::retiredFrames() {
+  if (timeline != VK_NULL_HANDLE) {
+    uint64_t value = 0;
+    if (getSemaphoreCounterValue(device, timeline, &value) == VK_SUCCESS &&
+        value > retired)
+      retired = value;
+  } else {
+    // One queue, so the fences signal in submission order
+    while (retired < nextFrame) {
+      uint32_t s = (uint32_t)(retired % frameDepth);
+      if (fenceFrames[s] != retired ||
+          vkGetFenceStatus(device, fences[s]) != VK_SUCCESS)
+        break;
+      retired++;
+    }
+  }
+  runDeferred();
+  return retired;
+}
+
+bool FrameTimeline::waitForFrame(uint64_t frame) {
+  if (frame < retired)
+    return true;
+  // Nothing would ever signal it
+  if (frame >= nextFrame)
+    return false;
+
+  if (timeline != VK_NULL_HANDLE) {
+    uint64_t value = frame + 1;
+    VkSemaphoreWaitInfo waitInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &timeline;
+    waitInfo.pValues = &value;
+    if (waitSemaphores(device, &waitInfo, UINT64_MAX) != VK_SUCCESS)
+      return false;
+  } else {
+    // A slot is only reused once its previous frame was waited for, so a
+    // fence that moved on means the frame already retired
+    uint32_t s = (uint32_t)(frame % frameDepth);
+    if (fenceFrames[s] == frame &&
+        vkWaitForFences(device, 1, &fences[s], VK_TRUE, UINT64_MAX) !=
+            VK_SUCCESS)
+      return false;
+  }
+  if (frame + 1 > retired)
+    retired = frame + 1;
+  runDeferred();
+  return true;
+}
+
+bool FrameTimeline::waitForSlot() {
+  return nextFrame < frameDepth || waitForFrame(nextFrame - frameDepth);
+}
+
+void FrameTimeline::deferUntilRetired(std::function<void()> work) {
+  if (retiredFrames() >= nextFrame) {
+    work();
+    return;
+  }
+  deferred.push_back({nextFrame, std::move(work)});
+}
+
+void FrameTimeline::runDeferred() {
+  while (!deferred.empty() && deferred.front().frames <= retired) {
+    // Popped first: the work may defer more work
+    std::function<void()> work = std::move(deferred.front().work);
+    deferred.pop_front();
+    work();
+  }
+}
+
+VkResult FrameTimeline::submit(VkQueue queue, VkCommandBuffer commandBuffer,
+                               VkSemaphore waitSemaphore,
+                               VkPipelineStageFlags2 waitStage,
+                               VkSemaphore signalSemaphore) {
+  VkResult result;
+  if (timeline != VK_NULL_HANDLE) {
+    VkSemaphoreSubmitInfo wait = {VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO};
+    wait.semaphore = waitSemaphore;
+    wait.stageMask = waitStage;
+    // The counter covers every command, so a retired frame's slot can be
+    // rewritten without further barriers
+    VkSemaphoreSubmitInfo signals[2] = {};
+    signals[0].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    signals[0].semaphore = timeline;
+    signals[0].value = nextFrame + 1;
+    signals[0].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    signals[1] = signals[0];
+    signals[1].semaphore = signalSemaphore;
+    signals[1].value = 0;
+    VkCommandBufferSubmitInfo commandInfo = {
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO};
+    commandInfo.commandBuffer = commandBuffer;
+
+    VkSubmitInfo2 submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO_2};
+    submitInfo.waitSemaphoreInfoCount = waitSemaphore != VK_NULL_HANDLE;
+    submitInfo.pWaitSemaphoreInfos = &wait;
+    submitInfo.commandBufferInfoCount = 1;
+    submitInfo.pCommandBufferInfos = &commandInfo;
+    submitInfo.signalSemaphoreInfoCount =
+        signalSemaphore != VK_NULL_HANDLE ? 2 : 1;
+    submitInfo.pSignalSemaphoreInfos = signals;
+    result = queueSubmit2(queue, 1, &submitInfo, VK_NULL_HANDLE);
+  } else {
+    uint32_t s = slot();
+    // Forget the old frame first so a failed submit cannot leave a wait on
+    // an unsignaled fence
+    fenceFrames[s] = UINT64_MAX;
+    vkResetFences(device, 1, &fences[s]);
+    // synchronization2 stage bits below bit 32 equal the legacy flags
+    VkPipelineStageFlags stage = (VkPipelineStageFlags)waitStage;
+    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.waitSemaphoreCount = waitSemaphore != VK_NULL_HANDLE;
+    submitInfo.pWaitSemaphores = &waitSemaphore;
+    submitInfo.pWaitDstStageMask = &stage;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = signalSemaphore != VK_NULL_HANDLE;
+    submitInfo.pSignalSemaphores = &signalSemaphore;
+    result = vkQueueSubmit(queue, 1, &submitInfo, fences[s]);
+    if (result == VK_SUCCESS)
+      fenceFrames[s] = nextFrame;
+  }
+  if (result == VK_SUCCESS)
+    nextFrame++;
+  return result;
+}
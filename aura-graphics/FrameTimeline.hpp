@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+/**
+ * @brief Frame pacing on a single timeline semaphore.
+ *
+ * Frames are numbered from 0 in submission order and the semaphore reaches
+ * N + 1 once frame N has finished on the GPU, so "is frame N retired" is a
+ * counter comparison and making room for the next frame is one host wait.
+ * Up to depth() frames are in flight (1 for lowest latency, 3 for
+ * throughput); frame N uses slot N % depth() of every per-frame resource.
+ *
+ * Submits go through vkQueueSubmit2 with synchronization2 stage masks. On
+ * devices without timelineSemaphore + synchronization2 (Vulkan 1.0/1.1
+ * Android) the same interface is backed by one fence per slot. Written
+ * against the C API so the desktop app and the Android renderer share it.
+ */
+class FrameTimeline {
+public:
+  static constexpr uint32_t MAX_DEPTH = 3;
+
+  // True when the device exposes Vulkan 1.3 with timelineSemaphore and
+  // synchronization2; the caller must enable both to init with useTimeline.
+  static bool supported(VkInstance instance, VkPhysicalDevice physicalDevice);
+
+  // depth is clamped to [1, MAX_DEPTH].
+  bool init(VkDevice device, uint32_t depth, bool useTimeline);
+  // The device must be idle; runs any work still deferred.
+  void destroy();
+
+  uint32_t depth() const { return frameDepth; }
+  bool usesTimeline() const { return timeline != VK_NULL_HANDLE; }
+  // The frame being prepared, i.e. the number the next submit() signals.
+  uint64_t frameNumber() const { return nextFrame; }
+  uint32_t slot() const { return (uint32_t)(nextFrame % frameDepth); }
+
+  // Frames 0 .. retiredFrames() - 1 have finished on the GPU. Non-blocking;
+  // also runs deferred work that became due.
+  uint64_t retiredFrames();
+  // Blocks until `frame` has retired; false if it was never submitted or
+  // the wait failed (device lost).
+  bool waitForFrame(uint64_t frame);
+  // Blocks until slot() is free, i.e. frame frameNumber() - depth() retired.
+  bool waitForSlot();
+  // Runs `work` once every frame submitted so far has retired (right away
+  // when none is in flight). Use it to release objects in-flight frames may
+  // still reference without idling the device.
+  void deferUntilRetired(std::function<void()> work);
+
+  // Submits frame frameNumber() and advances it. Waits on waitSemaphore (if
+  // any) at waitStage and signals signalSemaphore (if any) next to the frame
+  // counter. Call after waitForSlot().
+  VkResult submit(VkQueue queue, VkCommandBuffer commandBuffer,
+                  VkSemaphore waitSemaphore, VkPipelineStageFlags2 waitStage,
+                  VkSemaphore signalSemaphore);
+
+private:
+  void runDeferred();
+
+  VkDevice device = VK_NULL_HANDLE;
+  uint32_t frameDepth = 1;
+  uint64_t nextFrame = 0;
+  uint64_t retired = 0;
+
+  VkSemaphore timeline = VK_NULL_HANDLE;
+  // Loaded at init so neither platform needs Vulkan 1.2+ exports at link time
+  PFN_vkWaitSemaphores waitSemaphores = nullptr;
+  PFN_vkGetSemaphoreCounterValue getSemaphoreCounterValue = nullptr;
+  PFN_vkQueueSubmit2 queueSubmit2 = nullptr;
+
+  // Fallback: a fence per slot and the frame last submitted with it
+  std::vector<VkFence> fences;
+  std::vector<uint64_t> fenceFrames;
+
+  struct DeferredWork {
+    uint64_t frames; // due once retiredFrames() >= frames
+    std::function<void()> work;
+  };
+  std::deque<DeferredWork> deferred;
+};
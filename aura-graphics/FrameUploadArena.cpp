@@ -0,0 +1,50 @@
+#include "FrameUploadArena.hpp"
+
+bool FrameUploadArena::init(DeviceMemoryAllocator &alloc,
+                            VkDeviceSize bytesPerFrame, uint32_t slotCount,
+                            VkBufferUsageFlags usage) {
+  allocator = &alloc;
+  // Slot regions start on a flush atom and on every offset alignment the
+  // usages ask for
+  const VkPhysicalDeviceLimits &limits = alloc.limits();
+  alignment = limits.nonCoherentAtomSize;
+  if (limits.minUniformBufferOffsetAlignment > alignment)
+    alignment = limits.minUniformBufferOffsetAlignment;
+  if (limits.minStorageBufferOffsetAlignment > alignment)
+    alignment = limits.minStorageBufferOffsetAlignment;
+  if (alignment < 1)
+    alignment = 1;
+  slotSize = (bytesPerFrame + alignment - 1) / alignment * alignment;
+  slots = slotCount;
+  reserved = 0;
+
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = slotSize * slotCount;
+  bufferInfo.usage = usage;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  return alloc.createBuffer(bufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, arenaBuffer,
+                            memory) &&
+         memory.mapped;
+}
+
+void FrameUploadArena::destroy() {
+  if (!allocator)
+    return;
+  if (arenaBuffer != VK_NULL_HANDLE)
+    allocator->destroyBuffer(arenaBuffer, memory);
+  allocator = nullptr;
+}
+
+bool FrameUploadArena::reserve(VkDeviceSize size, VkDeviceSize &offset) {
+  VkDeviceSize rounded = (size + alignment - 1) / alignment * alignment;
+  if (reserved + rounded > slotSize)
+    return false;
+  offset = reserved;
+  reserved += rounded;
+  return true;
+}
+
+void FrameUploadArena::flush(VkDeviceSize offset, VkDeviceSize size) const {
+  allocator->flush(memory, offset, size);
+}
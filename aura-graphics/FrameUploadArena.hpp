@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "DeviceMemoryAllocator.hpp"
+
+/**
+ * @brief Per-frame-slot upload buffer for host-written frame data.
+ *
+ * One persistently mapped, host-visible buffer split into a region per
+ * frame slot. Per-frame data that command buffers recorded once bind at a
+ * fixed dynamic offset (UniformRing, IslandInstanceRing) reserve()s its
+ * space at the front of every slot before the first frame; frame N writes
+ * slot N % slotCount() once FrameTimeline::waitForSlot() has freed it, so
+ * data of frames still on the GPU is never overwritten. Long-lived resources
+ * go to the DeviceMemoryAllocator directly. Written against the C API so the
+ * desktop app and the Android renderer share it.
+ */
+class FrameUploadArena {
+public:
+  // Vulkan caps the offset and flush alignments a slot honours at 256 bytes;
+  // budget this much per reserve() for rounding when sizing the arena.
+  static constexpr VkDeviceSize MAX_ALIGNMENT = 256;
+
+  bool init(DeviceMemoryAllocator &allocator, VkDeviceSize bytesPerFrame,
+            uint32_t slotCount,
+            VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+  void destroy();
+
+  // Before the first frame: sets aside `size` bytes in every slot, aligned
+  // for dynamic offsets and flushes. Slot i's copy starts at
+  // offset + i * capacity() in buffer(). False when the slots are full.
+  bool reserve(VkDeviceSize size, VkDeviceSize &offset);
+  // Makes writes to [offset, offset + size) of buffer() visible; a no-op on
+  // coherent memory.
+  void flush(VkDeviceSize offset, VkDeviceSize size) const;
+
+  // Host address of byte `offset` of buffer()
+  void *mapped(VkDeviceSize offset) const {
+    return static_cast<uint8_t *>(memory.mapped) + offset;
+  }
+
+  VkBuffer buffer() const { return arenaBuffer; }
+  // Bytes per slot
+  VkDeviceSize capacity() const { return slotSize; }
+  VkDeviceSize reservedBytes() const { return reserved; }
+  uint32_t slotCount() const { return slots; }
+
+private:
+  DeviceMemoryAllocator *allocator = nullptr;
+  VkBuffer arenaBuffer = VK_NULL_HANDLE;
+  DeviceAllocation memory;
+  VkDeviceSize slotSize = 0;
+  VkDeviceSize alignment = 1;
+  VkDeviceSize reserved = 0;
+  uint32_t slots = 0;
+};
@@ -0,0 +1,86 @@
+#include "IslandInstanceRing.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "SpringBatch.hpp"
+
+bool IslandInstanceRing::init(DeviceMemoryAllocator &allocator,
+                              uint32_t capacity, uint32_t slotCount) {
+  islandCapacity = capacity;
+  return ring.init(allocator, slotSize(capacity), slotCount,
+                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                       VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+}
+
+bool IslandInstanceRing::init(FrameUploadArena &arena, uint32_t capacity) {
+  islandCapacity = capacity;
+  return ring.init(arena, slotSize(capacity));
+}
+
+void IslandInstanceRing::destroy() {
+  ring.destroy();
+  islandCapacity = 0;
+}
+
+uint32_t IslandInstanceRing::upload(uint32_t frame, const SpringBatch &springs,
+                                    const std::vector<IslandStyle> &styles,
+                                    float edgeWidth) {
+  auto *slot = static_cast<uint8_t *>(ring.slot(frame));
+  auto *instances = reinterpret_cast<LiquidIslandInstance *>(slot);
+  const IslandStyle defaultStyle;
+
+  lastShadedPixels = 0.0;
+  uint32_t count = springs.islandCount();
+  if (count > islandCapacity)
+    count = islandCapacity;
+  for (uint32_t i = 0; i < count; i++) {
+    IslandState state = springs.state(i);
+    const IslandStyle &style = i < styles.size() ? styles[i] : defaultStyle;
+    LiquidIslandInstance &out = instances[i];
+    out.rect[0] = state.x;
+    out.rect[1] = state.y;
+    out.rect[2] = state.width;
+    out.rect[3] = state.height;
+    out.shape[0] = state.cornerRadius;
+    out.shape[1] = style.warpAmplitude;
+    out.shape[2] = style.glowRadius;
+    out.shape[3] = style.phase;
+    std::memcpy(out.colorA, style.colorA, sizeof(out.colorA));
+    std::memcpy(out.colorB, style.colorB, sizeof(out.colorB));
+    lastShadedPixels += islandBounds(out, edgeWidth).area();
+  }
+
+  VkDrawIndirectCommand draw = {VERTICES_PER_ISLAND, count, 0, 0};
+  std::memcpy(slot + instancesRange(), &draw, sizeof(draw));
+  ring.flush(frame);
+  return count;
+}
+
+void IslandInstanceRing::recordDraw(VkCommandBuffer commandBuffer,
+                                    uint32_t frame) const {
+  vkCmdDrawIndirect(commandBuffer, ring.buffer(),
+                    ring.dynamicOffset(frame) + instancesRange(), 1,
+                    sizeof(VkDrawIndirectCommand));
+}
+
+IslandBounds islandBounds(const LiquidIslandInstance &island,
+                          float edgeWidth) {
+  const float sqrt2 = 1.41421356f;
+  float halfWidth = island.rect[2] * 0.5f;
+  float halfHeight = island.rect[3] * 0.5f;
+  float radius = std::min(island.shape[0], std::min(halfWidth, halfHeight));
+  float warp = island.shape[1];
+  float coverage = std::max(island.shape[2], edgeWidth);
+
+  IslandBounds bounds;
+  bounds.halfExtent[0] = halfWidth + warp + coverage;
+  bounds.halfExtent[1] = halfHeight + warp + coverage;
+  float reach = warp * sqrt2 + coverage;
+  float diagonal = (halfWidth - radius) + (halfHeight - radius) +
+                   (radius + reach) * sqrt2;
+  bounds.cut =
+      std::clamp(bounds.halfExtent[0] + bounds.halfExtent[1] - diagonal, 0.0f,
+                 std::min(bounds.halfExtent[0], bounds.halfExtent[1]));
+  return bounds;
+}
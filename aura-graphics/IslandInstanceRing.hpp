@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "LiquidUniforms.hpp"
+#include "UniformRing.hpp"
+
+class SpringBatch;
+
+/**
+ * @brief Per-frame island instances plus the indirect draw that renders them.
+ *
+ * Each frame slot holds `capacity` LiquidIslandInstance records (bound as a
+ * dynamic storage buffer) followed by one VkDrawIndirectCommand whose
+ * instanceCount is the number of islands written this frame. Command buffers
+ * recorded once therefore draw however many islands exist, in a single call,
+ * without being re-recorded. The vertex shader expands each instance into an
+ * octagon around the pixels the island can colour (18 vertices; see
+ * islandBounds()).
+ *
+ * Written against the C API so the desktop app and the Android renderer share
+ * it.
+ */
+class IslandInstanceRing {
+public:
+  static constexpr uint32_t VERTICES_PER_ISLAND = 18;
+
+  bool init(DeviceMemoryAllocator &allocator, uint32_t capacity,
+            uint32_t slotCount);
+  // In a reservation of every slot of `arena`, whose buffer must allow
+  // storage and indirect use (see UniformRing).
+  bool init(FrameUploadArena &arena, uint32_t capacity);
+  // Bytes of one frame slot: the instances and the draw.
+  static VkDeviceSize slotSize(uint32_t capacity) {
+    return capacity * sizeof(LiquidIslandInstance) +
+           sizeof(VkDrawIndirectCommand);
+  }
+  void destroy();
+
+  // Writes every island of `springs` (styles[i] or the default style) into a
+  // frame slot and updates its draw. Returns the number of islands drawn,
+  // which is clamped to capacity(). edgeWidth: see islandBounds().
+  uint32_t upload(uint32_t frame, const SpringBatch &springs,
+                  const std::vector<IslandStyle> &styles,
+                  float edgeWidth = 1.0f);
+
+  // Issues the slot's indirect draw; the pipeline and descriptor set
+  // (bound with dynamicOffset(frame)) must already be bound.
+  void recordDraw(VkCommandBuffer commandBuffer, uint32_t frame) const;
+
+  VkBuffer buffer() const { return ring.buffer(); }
+  // Descriptor range of the instance array.
+  VkDeviceSize instancesRange() const {
+    return islandCapacity * sizeof(LiquidIslandInstance);
+  }
+  uint32_t dynamicOffset(uint32_t frame) const {
+    return ring.dynamicOffset(frame);
+  }
+  uint32_t capacity() const { return islandCapacity; }
+  // The slot's instances as last uploaded (host-visible memory).
+  const LiquidIslandInstance *instances(uint32_t frame) const {
+    return ring.at<LiquidIslandInstance>(frame);
+  }
+  // Area of the octagons written by the last upload(), in pixels, before
+  // clipping to the framebuffer: the fragment work of the instanced draw.
+  double shadedPixels() const { return lastShadedPixels; }
+
+private:
+  UniformRing ring;
+  uint32_t islandCapacity = 0;
+  double lastShadedPixels = 0.0;
+};
+
+/**
+ * @brief Octagon bounding everything liquid.frag can draw for an island.
+ *
+ * C++ mirror of islandBounds() in shaders/liquid_common.glsl: a box of
+ * halfExtent around the centre with a right triangle of leg `cut` removed
+ * from each corner. edgeWidth is the shader's edgeWidth(): 1 natively,
+ * 1 / scale in a reduced-scale liquid layer.
+ */
+struct IslandBounds {
+  float halfExtent[2];
+  float cut;
+  double area() const {
+    return 4.0 * halfExtent[0] * halfExtent[1] - 2.0 * cut * cut;
+  }
+};
+
+IslandBounds islandBounds(const LiquidIslandInstance &island,
+                          float edgeWidth = 1.0f);
@@ -0,0 +1,20 @@
+#pragma once
+
+/**
+ * @brief Status geometri pulau untuk animasi spring physics (Standard Master
+ * Context).
+ *
+ * Shared by the desktop renderer, the Android LiquidRenderer and SpringBatch,
+ * which treats the five fields as consecutive spring channels. x, y is the
+ * island centre in pixels.
+ */
+struct IslandState {
+  float width;
+  float height;
+  float x;
+  float y;
+  float cornerRadius;
+};
+
+static_assert(sizeof(IslandState) == 5 * sizeof(float),
+              "SpringBatch reads IslandState as five packed floats");
@@ -0,0 +1,1878 @@
+#include "LiquidIslandApp.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#define GLFW_INCLUDE_VULKAN
+#include "aura_kernel.h"
+#include "aura_shaders.h"
+#include <GLFW/glfw3.h>
+
+const std::vector<const char *> deviceExtensions = {
+    VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+
+static double toMs(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// Buffer barrier written with synchronization2 masks; without it the legacy
+// barrier is used, which has the same bits for every stage and access here.
+static void bufferBarrier(vk::CommandBuffer commandBuffer, bool sync2,
+                          const vk::BufferMemoryBarrier2 &barrier) {
+  if (sync2) {
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo({}, 0, nullptr, 1, &barrier, 0, nullptr));
+    return;
+  }
+  vk::BufferMemoryBarrier legacy(
+      vk::AccessFlags((VkAccessFlags) static_cast<VkAccessFlags2>(
+          barrier.srcAccessMask)),
+      vk::AccessFlags((VkAccessFlags) static_cast<VkAccessFlags2>(
+          barrier.dstAccessMask)),
+      barrier.srcQueueFamilyIndex, barrier.dstQueueFamilyIndex, barrier.buffer,
+      barrier.offset, barrier.size);
+  commandBuffer.pipelineBarrier(
+      vk::PipelineStageFlags((VkPipelineStageFlags) static_cast<
+                             VkPipelineStageFlags2>(barrier.srcStageMask)),
+      vk::PipelineStageFlags((VkPipelineStageFlags) static_cast<
+                             VkPipelineStageFlags2>(barrier.dstStageMask)),
+      {}, nullptr, legacy, nullptr);
+}
+
+LiquidIslandApp::LiquidIslandApp(AppConfig config) : config(config) {
+  this->config.framesInFlight = std::clamp(config.framesInFlight, 1u,
+                                           FrameTimeline::MAX_DEPTH);
+  setFramebufferExtent(config.width, config.height);
+}
+
+void LiquidIslandApp::run() {
+  init();
+  mainLoop();
+  cleanup();
+}
+
+void LiquidIslandApp::init() {
+  startTime = Clock::now();
+  if (!config.headless)
+    initWindow();
+  initVulkan();
+}
+
+void LiquidIslandApp::shutdown() {
+  device.waitIdle();
+  cleanup();
+}
+
+void LiquidIslandApp::initWindow() {
+  glfwInit();
+  glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+  window = glfwCreateWindow(config.width, config.height,
+                            "Aura OS - Liquid Island", nullptr, nullptr);
+  glfwSetWindowUserPointer(window, this);
+  int width = 0, height = 0;
+  glfwGetFramebufferSize(window, &width, &height);
+  setFramebufferExtent((uint32_t)width, (uint32_t)height);
+  glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
+  glfwSetMouseButtonCallback(window, mouseButtonCallback);
+  glfwSetWindowRefreshCallback(window, windowRefreshCallback);
+}
+
+void LiquidIslandApp::framebufferResizeCallback(GLFWwindow *window,
+                                                int width, int height) {
+  auto *app =
+      reinterpret_cast<LiquidIslandApp *>(glfwGetWindowUserPointer(window));
+  app->setFramebufferExtent((uint32_t)width, (uint32_t)height);
+  app->swapChainOutdated = true;
+  app->wakeRenderThread();
+}
+
+void LiquidIslandApp::mouseButtonCallback(GLFWwindow *window, int button,
+                                          int action, int) {
+  if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS)
+    return;
+  // Click toggles the island between its compact and expanded shape
+  auto *app =
+      reinterpret_cast<LiquidIslandApp *>(glfwGetWindowUserPointer(window));
+  app->islandExpanded = !app->islandExpanded;
+  app->setIslandTarget(app->defaultIslandTarget());
+}
+
+void LiquidIslandApp::windowRefreshCallback(GLFWwindow *window) {
+  auto *app =
+      reinterpret_cast<LiquidIslandApp *>(glfwGetWindowUserPointer(window));
+  app->redrawRequested = true;
+  app->wakeRenderThread();
+}
+
+void LiquidIslandApp::setIslandTarget(const IslandState &target) {
+  targets.publish(target);
+  wakeRenderThread();
+}
+
+bool LiquidIslandApp::applyPendingTarget() {
+  IslandState target;
+  if (!targets.take(target))
+    return false;
+  springs.setTarget(island, target);
+  return true;
+}
+
+void LiquidIslandApp::stepAnimation(float dt) {
+  applyPendingTarget();
+  springs.step(dt);
+}
+
+void LiquidIslandApp::wakeRenderThread() {
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    wakePending = true;
+  }
+  wakeCondition.notify_one();
+}
+
+vk::Extent2D LiquidIslandApp::framebufferExtent() const {
+  uint64_t size = framebufferSize.load(std::memory_order_relaxed);
+  return {(uint32_t)size, (uint32_t)(size >> 32)};
+}
+
+void LiquidIslandApp::setFramebufferExtent(uint32_t width, uint32_t height) {
+  framebufferSize.store((uint64_t)width | ((uint64_t)height << 32),
+                        std::memory_order_relaxed);
+}
+
+void LiquidIslandApp::addStressIslands() {
+  // Small pills in a grid below the main island, each with its own phase,
+  // to exercise the instanced path (AppConfig::islandCount).
+  const float cellWidth = 140.0f, cellHeight = 56.0f, top = 180.0f;
+  uint32_t columns = std::max(1u, (uint32_t)(swapChainExtent.width /
+                                             cellWidth));
+  IslandStyle style;
+  style.warpAmplitude = 2.0f;
+  style.glowRadius = 6.0f;
+  for (uint32_t i = 1; i < config.islandCount; i++) {
+    uint32_t cell = i - 1;
+    float x = ((float)(cell % columns) + 0.5f) * cellWidth;
+    float y = top + (float)(cell / columns) * cellHeight;
+    springs.addIsland({120.0f, 32.0f, x, y, 16.0f});
+    style.phase = 0.37f * (float)i;
+    islandStyles.push_back(style);
+  }
+}
+
+IslandState LiquidIslandApp::defaultIslandTarget() const {
+  // Top-centred pill; the top edge stays put while it grows downwards.
+  // Called from the window thread too, so it reads the framebuffer size
+  // rather than the render thread's swapchain extent.
+  float centreX = (float)framebufferExtent().width * 0.5f;
+  if (islandExpanded)
+    return {360.0f, 120.0f, centreX, 90.0f, 40.0f};
+  return {200.0f, 40.0f, centreX, 50.0f, 20.0f};
+}
+
+void LiquidIslandApp::initVulkan() {
+  // Each step names the steps whose results it reads; independent chains
+  // (the kernel next to the device, the pipeline cache next to the
+  // swapchain, buffers next to render passes) run on separate threads.
+  bool progressive = config.progressiveStartup && !config.headless;
+  StartupGraph graph;
+  graph.add("kernel", [this] { initKernel(); });
+  auto deviceReady = graph.add("instance + device", [this] {
+    createInstance();
+    if (!config.headless)
+      createSurface();
+    pickPhysicalDevice();
+    createLogicalDevice();
+    if (!memoryAllocator.init((VkPhysicalDevice)physicalDevice,
+                              (VkDevice)device))
+      throw std::runtime_error("failed to create device memory allocator!");
+    if (config.tiledShading && !(physicalDevice.getQueueFamilyProperties()
+                                     [findQueueFamilies(physicalDevice)
+                                          .graphicsFamily.value()]
+                                         .queueFlags &
+                                 vk::QueueFlagBits::eCompute)) {
+      std::cout << "Tiled shading: graphics queue has no compute, using the "
+                   "instanced path"
+                << std::endl;
+      config.tiledShading = false;
+    }
+  });
+  auto swapchainReady = graph.add(
+      "swapchain",
+      [this] {
+        if (config.headless)
+          createOffscreenTargets();
+        else if (!createSwapChain())
+          throw std::runtime_error("window has no drawable area!");
+        createImageViews();
+        createRenderFinishedSemaphores();
+      },
+      {deviceReady});
+  auto cacheReady = graph.add("pipeline cache",
+                              [this] { createPipelineCache(); }, {deviceReady});
+  auto layoutsReady = graph.add("layouts",
+                                [this] { createDescriptorSetLayout(); },
+                                {deviceReady});
+  auto passesReady = graph.add(
+      "render passes",
+      [this] {
+        createRenderPass();
+        createLiquidLayerResources();
+      },
+      {swapchainReady, layoutsReady});
+  auto startupReady = graph.add(
+      "startup pipeline",
+      [this, progressive] {
+        if (progressive)
+          createStartupPipeline();
+      },
+      {passesReady, cacheReady});
+  auto pipelinesReadyTask = graph.add(
+      "liquid pipelines",
+      [this, progressive] {
+        if (progressive) {
+          startPipelineBuild();
+        } else {
+          createGraphicsPipeline(swapChainImageFormat);
+          fullPipelinesActive = true;
+        }
+      },
+      {startupReady});
+  auto targetsReady = graph.add(
+      "framebuffers",
+      [this] {
+        createFramebuffers();
+        createLiquidLayer();
+      },
+      {passesReady});
+  auto syncReady = graph.add(
+      "command pool + sync",
+      [this] {
+        createCommandPool();
+        createSyncObjects();
+        if (config.gpuProfiling) {
+          profiler.init(
+              physicalDevice, device,
+              findQueueFamilies(physicalDevice).graphicsFamily.value(),
+              config.framesInFlight, pipelineStatisticsEnabled);
+          profiler.calibrate(graphicsQueue, commandPool);
+        }
+      },
+      {deviceReady});
+  auto buffersReady = graph.add(
+      "buffers",
+      [this] {
+        createUniformRing();
+        if (config.tiledShading)
+          createTileBuffer();
+        createDescriptorSets();
+      },
+      {layoutsReady});
+  auto scenesReady = graph.add(
+      "islands",
+      [this] {
+        governor.reset(config.quality);
+        activeTier = governor.tier();
+        DynamicResolutionSettings scaleSettings;
+        scaleSettings.minScale = config.minRenderScale;
+        resolution = DynamicResolution(config.renderScale, scaleSettings);
+        activeScale = config.dynamicResolution ? resolution.scale()
+                                               : config.renderScale;
+        island = springs.addIsland(defaultIslandTarget());
+        islandStyles.resize(1);
+        addStressIslands();
+      },
+      {passesReady});
+  graph.add("command buffers", [this] { createCommandBuffers(); },
+            {pipelinesReadyTask, targetsReady, syncReady, buffersReady,
+             scenesReady});
+  uint32_t threads = std::clamp(std::thread::hardware_concurrency(), 2u, 4u);
+  try {
+    graph.run(threads);
+  } catch (...) {
+    // A step failed after the background build started; never leave it
+    // running behind the exception
+    if (pipelineBuilder.joinable())
+      pipelineBuilder.join();
+    throw;
+  }
+
+  std::cout << "Startup: " << graph.timings().size() << " steps, "
+            << graph.workMs() << " ms of work in " << graph.wallMs()
+            << " ms on " << threads << " threads" << std::endl;
+  std::cout << "Aura Graphics Engine: Ready to Render!"
+            << (config.headless ? " (headless)" : "") << std::endl;
+}
+
+void LiquidIslandApp::initKernel() {
+  // Touches no Vulkan state, so it overlaps instance and device creation
+  if (aura_kernel_init()) {
+    char *version = aura_kernel_get_version();
+    std::cout << "Aura Kernel FFI Linked! Version: " << version << std::endl;
+    aura_kernel_free_string(version);
+  }
+  kernelChannel = aura_kernel_channel_create();
+  if (!kernelChannel)
+    std::cerr << "Aura Kernel channel unavailable" << std::endl;
+  else if (config.powerSaving)
+    aura_kernel_channel_request_power_mode(kernelChannel,
+                                           AURA_POWER_EFFICIENT);
+  // The shaders evaluate the intensity curve per island from these
+  AuraFluidCurve curve = {};
+  aura_kernel_get_fluid_curve(&curve);
+  fluidCurve[0] = curve.ripple_frequency;
+  fluidCurve[1] = curve.ripple_amplitude;
+  fluidCurve[2] = curve.wave_frequency;
+  fluidCurve[3] = curve.wave_amplitude;
+}
+
+void LiquidIslandApp::createInstance() {
+  vk::ApplicationInfo appInfo("Aura Graphics", VK_MAKE_VERSION(1, 0, 0),
+                              "Aura Engine", VK_MAKE_VERSION(1, 0, 0),
+                              VK_API_VERSION_1_3);
+  std::vector<const char *> extensions;
+  if (!config.headless) {
+    uint32_t glfwExtensionCount = 0;
+    const char **glfwExtensions =
+        glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+  }
+  vk::InstanceCreateInfo createInfo({}, &appInfo, 0, nullptr,
+                                    (uint32_t)extensions.size(),
+                                    extensions.data());
+  instance = vk::createInstance(createInfo);
+}
+
+void LiquidIslandApp::createSurface() {
+  VkSurfaceKHR rawSurface;
+  if (glfwCreateWindowSurface((VkInstance)instance, window, nullptr,
+                              &rawSurface) != VK_SUCCESS)
+    throw std::runtime_error("failed to create surface!");
+  surface = rawSurface;
+}
+
+void LiquidIslandApp::pickPhysicalDevice() {
+  auto devices = instance.enumeratePhysicalDevices();
+  for (const auto &d : devices) {
+    if (!isDeviceSuitable(d))
+      continue;
+    bool isSoftware =
+        d.getProperties().deviceType == vk::PhysicalDeviceType::eCpu;
+    if (!physicalDevice || (config.preferSoftwareDevice && isSoftware)) {
+      physicalDevice = d;
+      if (!config.preferSoftwareDevice || isSoftware)
+        break;
+    }
+  }
+  if (!physicalDevice)
+    throw std::runtime_error("failed to find suitable GPU!");
+  deviceNameStr = physicalDevice.getProperties().deviceName.data();
+  std::cout << "Using GPU: " << deviceNameStr << std::endl;
+}
+
+bool LiquidIslandApp::isDeviceSuitable(vk::PhysicalDevice d) {
+  if (config.headless)
+    return findQueueFamilies(d).isComplete(false);
+  return checkDeviceExtensionSupport(d) && findQueueFamilies(d).isComplete();
+}
+
+bool LiquidIslandApp::checkDeviceExtensionSupport(vk::PhysicalDevice d) {
+  auto availableExtensions = d.enumerateDeviceExtensionProperties();
+  std::set<std::string> required(deviceExtensions.begin(),
+                                 deviceExtensions.end());
+  for (const auto &ext : availableExtensions) {
+    required.erase(ext.extensionName);
+  }
+  return required.empty();
+}
+
+bool LiquidIslandApp::supportsDynamicRendering(vk::PhysicalDevice d) {
+  if (d.getProperties().apiVersion < VK_API_VERSION_1_3)
+    return false;
+  auto chain = d.getFeatures2<vk::PhysicalDeviceFeatures2,
+                              vk::PhysicalDeviceVulkan13Features>();
+  return chain.get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering;
+}
+
+LiquidIslandApp::Float16Support
+LiquidIslandApp::float16Support(vk::PhysicalDevice d) {
+  uint32_t apiVersion = d.getProperties().apiVersion;
+  if (apiVersion >= VK_API_VERSION_1_2) {
+    auto chain = d.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                vk::PhysicalDeviceVulkan12Features>();
+    return chain.get<vk::PhysicalDeviceVulkan12Features>().shaderFloat16
+               ? Float16Support::Core
+               : Float16Support::None;
+  }
+  if (apiVersion < VK_API_VERSION_1_1)
+    return Float16Support::None;
+  bool hasExtension = false;
+  for (const auto &ext : d.enumerateDeviceExtensionProperties())
+    if (std::strcmp(ext.extensionName,
+                    VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME) == 0)
+      hasExtension = true;
+  if (!hasExtension)
+    return Float16Support::None;
+  auto chain = d.getFeatures2<vk::PhysicalDeviceFeatures2,
+                              vk::PhysicalDeviceShaderFloat16Int8Features>();
+  return chain.get<vk::PhysicalDeviceShaderFloat16Int8Features>()
+                 .shaderFloat16
+             ? Float16Support::Extension
+             : Float16Support::None;
+}
+
+QueueFamilyIndices LiquidIslandApp::findQueueFamilies(vk::PhysicalDevice d) {
+  QueueFamilyIndices indices;
+  auto families = d.getQueueFamilyProperties();
+  uint32_t i = 0;
+  for (const auto &f : families) {
+    if (f.queueFlags & vk::QueueFlagBits::eGraphics)
+      indices.graphicsFamily = i;
+    if (surface && d.getSurfaceSupportKHR(i, surface))
+      indices.presentFamily = i;
+    if (indices.isComplete(bool(surface)))
+      break;
+    i++;
+  }
+  return indices;
+}
+
+void LiquidIslandApp::createLogicalDevice() {
+  QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+  if (config.headless)
+    indices.presentFamily = indices.graphicsFamily;
+  float priority = 1.0f;
+  std::vector<vk::DeviceQueueCreateInfo> queues = {
+      {{}, indices.graphicsFamily.value(), 1, &priority}};
+  if (indices.graphicsFamily != indices.presentFamily)
+    queues.push_back({{}, indices.presentFamily.value(), 1, &priority});
+
+  std::vector<const char *> extensions;
+  if (!config.headless)
+    extensions = deviceExtensions;
+
+  vk::PhysicalDeviceFeatures features;
+  pipelineStatisticsEnabled =
+      config.pipelineStatistics &&
+      physicalDevice.getFeatures().pipelineStatisticsQuery;
+  features.pipelineStatisticsQuery = pipelineStatisticsEnabled;
+
+  // The frame timeline (timeline semaphore + synchronization2) and dynamic
+  // rendering are core in Vulkan 1.3; older devices pace frames with fences
+  // and keep render passes
+  synchronization2Enabled = FrameTimeline::supported(
+      (VkInstance)instance, (VkPhysicalDevice)physicalDevice);
+  vk::PhysicalDeviceVulkan12Features features12;
+  features12.timelineSemaphore = synchronization2Enabled;
+  vk::PhysicalDeviceVulkan13Features features13;
+  features13.pNext = &features12;
+  features13.synchronization2 = synchronization2Enabled;
+  // Its layout transitions are written with synchronization2 barriers
+  dynamicRenderingEnabled = config.dynamicRendering &&
+                            synchronization2Enabled &&
+                            supportsDynamicRendering(physicalDevice);
+  features13.dynamicRendering = dynamicRenderingEnabled;
+  std::cout << "Rendering backend: "
+            << (dynamicRenderingEnabled ? "dynamic rendering (Vulkan 1.3)"
+                                        : "render pass + framebuffers")
+            << std::endl;
+  // liquid_fast.frag declares the Float16 capability; without the feature
+  // its module may not even be created
+  Float16Support float16 = config.fastMath ? float16Support(physicalDevice)
+                                           : Float16Support::None;
+  fastMathEnabled = float16 != Float16Support::None;
+  features12.shaderFloat16 = float16 == Float16Support::Core;
+  vk::PhysicalDeviceShaderFloat16Int8Features float16Features;
+  float16Features.shaderFloat16 = float16 == Float16Support::Extension;
+  if (float16 == Float16Support::Extension)
+    extensions.push_back(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME);
+  if (config.fastMath)
+    std::cout << "Liquid shader: "
+              << (fastMathEnabled ? "fast math (fp16, polynomial sin/cos)"
+                                  : "full precision (no shaderFloat16)")
+              << std::endl;
+
+  vk::DeviceCreateInfo createInfo(
+      {}, (uint32_t)queues.size(), queues.data(), 0, nullptr,
+      (uint32_t)extensions.size(), extensions.data(), &features);
+  if (synchronization2Enabled)
+    createInfo.pNext = &features13;
+  else if (float16 == Float16Support::Core)
+    createInfo.pNext = &features12;
+  // Only below Vulkan 1.2, so never alongside features12/13
+  else if (float16 == Float16Support::Extension)
+    createInfo.pNext = &float16Features;
+  device = physicalDevice.createDevice(createInfo);
+  graphicsQueue = device.getQueue(indices.graphicsFamily.value(), 0);
+  presentQueue = device.getQueue(indices.presentFamily.value(), 0);
+}
+
+bool LiquidIslandApp::createSwapChain(vk::SwapchainKHR oldSwapChain) {
+  vk::Extent2D framebuffer = framebufferExtent();
+  SwapchainSettings settings;
+  if (!querySwapchainSettings(
+          (VkPhysicalDevice)physicalDevice, (VkSurfaceKHR)surface,
+          config.presentPreference, {framebuffer.width, framebuffer.height},
+          (VkFormat)swapChainImageFormat, settings))
+    throw std::runtime_error("failed to query surface capabilities!");
+  // Minimised: keep the current swapchain until there is something to show.
+  if (settings.extent.width == 0 || settings.extent.height == 0)
+    return false;
+  // Render pass and pipeline are built for one format; it must not change.
+  if (oldSwapChain &&
+      (vk::Format)settings.format.format != swapChainImageFormat)
+    throw std::runtime_error("surface format changed during resize!");
+
+  swapChainImageFormat = (vk::Format)settings.format.format;
+  swapChainExtent = vk::Extent2D{settings.extent.width, settings.extent.height};
+  vk::SwapchainCreateInfoKHR createInfo(
+      {}, surface, settings.imageCount, swapChainImageFormat,
+      (vk::ColorSpaceKHR)settings.format.colorSpace, swapChainExtent, 1,
+      vk::ImageUsageFlagBits::eColorAttachment);
+  createInfo.preTransform =
+      (vk::SurfaceTransformFlagBitsKHR)settings.preTransform;
+  createInfo.compositeAlpha =
+      (vk::CompositeAlphaFlagBitsKHR)settings.compositeAlpha;
+  createInfo.presentMode = (vk::PresentModeKHR)settings.presentMode;
+  createInfo.clipped = VK_TRUE;
+  // Lets the driver hand over resources from the swapchain being replaced.
+  createInfo.oldSwapchain = oldSwapChain;
+
+  QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+  uint32_t queueIndices[] = {indices.graphicsFamily.value(),
+                             indices.presentFamily.value()};
+  if (indices.graphicsFamily != indices.presentFamily) {
+    createInfo.imageSharingMode = vk::SharingMode::eConcurrent;
+    createInfo.queueFamilyIndexCount = 2;
+    createInfo.pQueueFamilyIndices = queueIndices;
+  } else {
+    createInfo.imageSharingMode = vk::SharingMode::eExclusive;
+  }
+
+  swapChain = device.createSwapchainKHR(createInfo);
+  swapChainImages = device.getSwapchainImagesKHR(swapChain);
+  std::cout << "Swapchain: " << swapChainExtent.width << "x"
+            << swapChainExtent.height << ", " << swapChainImages.size()
+            << " images, " << presentModeName(settings.presentMode)
+            << std::endl;
+  return true;
+}
+
+bool LiquidIslandApp::recreateSwapChain() {
+  auto start = Clock::now();
+  // Queued presents still name the old swapchain and its semaphores
+  if (presenter.running())
+    presenter.drain();
+  RetiredSwapchain retired;
+  retired.swapChain = swapChain;
+  if (!createSwapChain(swapChain))
+    return false;
+
+  // No waitIdle: the old objects are released once every frame submitted so
+  // far has retired.
+  retired.imageViews = std::move(swapChainImageViews);
+  retired.framebuffers = std::move(swapChainFramebuffers);
+  retired.renderFinishedSemaphores = std::move(renderFinishedSemaphores);
+  if (config.recordOnce)
+    retired.commandBuffers = std::move(commandBuffers);
+  // Older frames still sample their slot's layer through these sets
+  retired.liquidLayer = std::move(liquidLayer);
+  frameTimeline.deferUntilRetired(
+      [this, retired = std::move(retired)]() mutable {
+        destroyRetiredSwapchain(retired);
+      });
+
+  createImageViews();
+  createRenderFinishedSemaphores();
+  createFramebuffers();
+  createLiquidLayer();
+  if (config.recordOnce)
+    createCommandBuffers();
+  springs.setTarget(island, defaultIslandTarget());
+  std::cout << "Swapchain recreated in " << toMs(Clock::now() - start)
+            << " ms" << std::endl;
+  return true;
+}
+
+void LiquidIslandApp::destroyRetiredSwapchain(RetiredSwapchain &retired) {
+  if (!retired.commandBuffers.empty())
+    device.freeCommandBuffers(commandPool, retired.commandBuffers);
+  for (auto framebuffer : retired.framebuffers)
+    device.destroyFramebuffer(framebuffer);
+  for (auto imageView : retired.imageViews)
+    device.destroyImageView(imageView);
+  for (auto semaphore : retired.renderFinishedSemaphores)
+    device.destroySemaphore(semaphore);
+  destroyLiquidLayer(retired.liquidLayer);
+  device.destroySwapchainKHR(retired.swapChain);
+}
+
+void LiquidIslandApp::createOffscreenTargets() {
+  // Same format and extent the swapchain would use, plus TRANSFER_SRC so
+  // frames can be read back for inspection.
+  swapChainImageFormat = vk::Format::eB8G8R8A8Unorm;
+  swapChainExtent = vk::Extent2D{config.width, config.height};
+
+  swapChainImages.resize(config.framesInFlight);
+  offscreenMemory.resize(config.framesInFlight);
+  for (size_t i = 0; i < swapChainImages.size(); i++) {
+    vk::ImageCreateInfo imageInfo(
+        {}, vk::ImageType::e2D, swapChainImageFormat,
+        vk::Extent3D{swapChainExtent.width, swapChainExtent.height, 1}, 1, 1,
+        vk::SampleCountFlagBits::e1, vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eColorAttachment |
+            vk::ImageUsageFlagBits::eTransferSrc,
+        vk::SharingMode::eExclusive);
+    swapChainImages[i] = createDeviceImage(imageInfo, offscreenMemory[i]);
+  }
+}
+
+void LiquidIslandApp::createImageViews() {
+  swapChainImageViews.resize(swapChainImages.size());
+  for (size_t i = 0; i < swapChainImages.size(); i++) {
+    vk::ImageViewCreateInfo createInfo(
+        {}, swapChainImages[i], vk::ImageViewType::e2D, swapChainImageFormat,
+        {}, {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
+    swapChainImageViews[i] = device.createImageView(createInfo);
+  }
+}
+
+void LiquidIslandApp::createRenderFinishedSemaphores() {
+  // One per swapchain image: a present only releases its semaphore once that
+  // image is acquired again, which frame slots cannot track
+  if (config.headless)
+    return;
+  renderFinishedSemaphores.resize(swapChainImages.size());
+  for (auto &semaphore : renderFinishedSemaphores)
+    semaphore = device.createSemaphore(vk::SemaphoreCreateInfo());
+}
+
+void LiquidIslandApp::createRenderPass() {
+  if (dynamicRenderingEnabled)
+    return;
+  vk::ImageLayout finalLayout = config.headless
+                                    ? vk::ImageLayout::eTransferSrcOptimal
+                                    : vk::ImageLayout::ePresentSrcKHR;
+  vk::AttachmentDescription colorAttachment(
+      {}, swapChainImageFormat, vk::SampleCountFlagBits::e1,
+      vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
+      vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+      vk::ImageLayout::eUndefined, finalLayout);
+  vk::AttachmentReference colorRef(0, vk::ImageLayout::eColorAttachmentOptimal);
+  vk::SubpassDescription subpass({}, vk::PipelineBindPoint::eGraphics, 0,
+                                 nullptr, 1, &colorRef);
+  vk::RenderPassCreateInfo createInfo({}, 1, &colorAttachment, 1, &subpass);
+  renderPass = device.createRenderPass(createInfo);
+}
+
+void LiquidIslandApp::createDescriptorSetLayout() {
+  vk::ShaderStageFlags stages =
+      vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+  if (config.tiledShading)
+    stages |= vk::ShaderStageFlagBits::eCompute;
+  // Binding 2 (tile lists) only exists on the tiled path
+  vk::DescriptorSetLayoutBinding bindings[] = {
+      {0, vk::DescriptorType::eUniformBufferDynamic, 1, stages},
+      {1, vk::DescriptorType::eStorageBufferDynamic, 1, stages},
+      {2, vk::DescriptorType::eStorageBufferDynamic, 1,
+       vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eCompute}};
+  vk::DescriptorSetLayoutCreateInfo layoutInfo(
+      {}, config.tiledShading ? 3 : 2, bindings);
+  descriptorSetLayout = device.createDescriptorSetLayout(layoutInfo);
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo({}, 1, &descriptorSetLayout,
+                                                  0, nullptr);
+  pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+}
+
+void LiquidIslandApp::createPipelineCache() {
+  if (config.pipelineCachePath.empty())
+    return;
+  if (!pipelineCache.load((VkPhysicalDevice)physicalDevice, (VkDevice)device,
+                          config.pipelineCachePath))
+    throw std::runtime_error("failed to create pipeline cache!");
+}
+
+vk::Pipeline LiquidIslandApp::buildGraphicsPipeline(
+    vk::Format colorFormat, const uint32_t *vertCode, size_t vertSize,
+    const uint32_t *fragCode, size_t fragSize,
+    const vk::SpecializationInfo *fragSpecialization,
+    const vk::SpecializationInfo *vertSpecialization,
+    vk::PipelineLayout layout) {
+  vk::ShaderModule vertModule =
+      device.createShaderModule({{}, vertSize, vertCode});
+  vk::ShaderModule fragModule =
+      device.createShaderModule({{}, fragSize, fragCode});
+
+  vk::PipelineShaderStageCreateInfo stages[] = {
+      {{}, vk::ShaderStageFlagBits::eVertex, vertModule, "main",
+       vertSpecialization},
+      {{}, vk::ShaderStageFlagBits::eFragment, fragModule, "main",
+       fragSpecialization}};
+
+  vk::PipelineVertexInputStateCreateInfo vertexInput({}, 0, nullptr, 0,
+                                                     nullptr);
+  vk::PipelineInputAssemblyStateCreateInfo inputAssembly(
+      {}, vk::PrimitiveTopology::eTriangleList, VK_FALSE);
+  // Viewport and scissor are dynamic so a resize never rebuilds the pipeline
+  vk::PipelineViewportStateCreateInfo viewportState({}, 1, nullptr, 1,
+                                                    nullptr);
+  vk::DynamicState dynamicStates[] = {vk::DynamicState::eViewport,
+                                      vk::DynamicState::eScissor};
+  vk::PipelineDynamicStateCreateInfo dynamicState({}, 2, dynamicStates);
+  vk::PipelineRasterizationStateCreateInfo rasterizer(
+      {}, VK_FALSE, VK_FALSE, vk::PolygonMode::eFill,
+      vk::CullModeFlagBits::eBack, vk::FrontFace::eClockwise, VK_FALSE, 0.0f,
+      0.0f, 0.0f, 1.0f);
+  vk::PipelineMultisampleStateCreateInfo multisampling(
+      {}, vk::SampleCountFlagBits::e1, VK_FALSE);
+  // Premultiplied alpha so overlapping islands and glows composite
+  vk::PipelineColorBlendAttachmentState colorBlendAttachment(
+      VK_TRUE, vk::BlendFactor::eOne, vk::BlendFactor::eOneMinusSrcAlpha,
+      vk::BlendOp::eAdd, vk::BlendFactor::eOne,
+      vk::BlendFactor::eOneMinusSrcAlpha, vk::BlendOp::eAdd,
+      vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+          vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+  vk::PipelineColorBlendStateCreateInfo colorBlending(
+      {}, VK_FALSE, vk::LogicOp::eCopy, 1, &colorBlendAttachment);
+
+  vk::GraphicsPipelineCreateInfo pipelineInfo(
+      {}, 2, stages, &vertexInput, &inputAssembly, nullptr, &viewportState,
+      &rasterizer, &multisampling, nullptr, &colorBlending, &dynamicState,
+      layout ? layout : pipelineLayout, renderPass, 0);
+  // Dynamic rendering: only the attachment format is baked in, so neither a
+  // resize nor a new swapchain ever needs a new pipeline
+  vk::PipelineRenderingCreateInfo renderingInfo(0, 1, &colorFormat);
+  if (dynamicRenderingEnabled)
+    pipelineInfo.pNext = &renderingInfo;
+  auto result = device.createGraphicsPipeline(
+      vk::PipelineCache(pipelineCache.handle()), pipelineInfo);
+
+  device.destroyShaderModule(fragModule);
+  device.destroyShaderModule(vertModule);
+  if (result.result != vk::Result::eSuccess)
+    throw std::runtime_error("failed to create pipeline!");
+  return result.value;
+}
+
+void LiquidIslandApp::createGraphicsPipeline(vk::Format colorFormat) {
+  // SPIR-V is compiled at build time and embedded (see cmake/AuraShaders.cmake)
+  auto buildStart = Clock::now();
+  // Every quality tier up front: the governor switches by binding another
+  // pipeline, never by compiling one mid-animation
+  vk::SpecializationMapEntry qualityEntries[] = {
+      {1, offsetof(LiquidQualitySpec, warpIterations), sizeof(int32_t)},
+      {2, offsetof(LiquidQualitySpec, glow), sizeof(VkBool32)},
+      {3, offsetof(LiquidQualitySpec, highlight), sizeof(VkBool32)}};
+  // tile.vert reads the edge list (front) or the interior list (back)
+  vk::SpecializationMapEntry listEntry(0, 0, sizeof(VkBool32));
+  VkBool32 interiorList = VK_FALSE;
+  vk::SpecializationInfo listSpecialization(1, &listEntry, sizeof(VkBool32),
+                                            &interiorList);
+  const uint32_t *liquidFrag = fastMathEnabled ? aura_shaders::liquid_fast_frag
+                                               : aura_shaders::liquid_frag;
+  size_t liquidFragSize = fastMathEnabled ? aura_shaders::liquid_fast_frag_size
+                                          : aura_shaders::liquid_frag_size;
+  for (uint32_t tier = 0; tier < QUALITY_TIER_COUNT; tier++) {
+    LiquidQualitySpec spec = liquidQualitySpec((QualityTier)tier);
+    vk::SpecializationInfo qualitySpecialization(3, qualityEntries,
+                                                 sizeof(spec), &spec);
+    graphicsPipelines[tier] = buildGraphicsPipeline(
+        colorFormat, aura_shaders::shader_vert, aura_shaders::shader_vert_size,
+        liquidFrag, liquidFragSize, &qualitySpecialization);
+    // The upscale reads GLOW to tell glow from the edge ramp
+    if (liquidLayerEnabled)
+      upscalePipelines[tier] = buildGraphicsPipeline(
+          colorFormat, aura_shaders::shader_vert,
+          aura_shaders::shader_vert_size, aura_shaders::upscale_frag,
+          aura_shaders::upscale_frag_size, &qualitySpecialization, nullptr,
+          upscalePipelineLayout);
+    if (!config.tiledShading)
+      continue;
+    interiorList = VK_FALSE;
+    tileEdgePipelines[tier] = buildGraphicsPipeline(
+        colorFormat, aura_shaders::tile_vert, aura_shaders::tile_vert_size,
+        liquidFrag, liquidFragSize, &qualitySpecialization,
+        &listSpecialization);
+    interiorList = VK_TRUE;
+    tileInteriorPipelines[tier] = buildGraphicsPipeline(
+        colorFormat, aura_shaders::tile_vert, aura_shaders::tile_vert_size,
+        aura_shaders::liquid_fill_frag, aura_shaders::liquid_fill_frag_size,
+        &qualitySpecialization, &listSpecialization);
+  }
+
+  if (config.tiledShading) {
+
+    vk::ShaderModule compModule = device.createShaderModule(
+        {{}, aura_shaders::tile_classify_comp_size,
+         aura_shaders::tile_classify_comp});
+    vk::ComputePipelineCreateInfo computeInfo(
+        {}, {{}, vk::ShaderStageFlagBits::eCompute, compModule, "main"},
+        pipelineLayout);
+    auto result = device.createComputePipeline(
+        vk::PipelineCache(pipelineCache.handle()), computeInfo);
+    device.destroyShaderModule(compModule);
+    if (result.result != vk::Result::eSuccess)
+      throw std::runtime_error("failed to create tile classification pipeline!");
+    tileClassifyPipeline = result.value;
+  }
+  double buildMs = toMs(Clock::now() - buildStart);
+
+  if (pipelineCache.handle()) {
+    pipelineCache.recordBuildTime(buildMs);
+    std::cout << "Pipeline cache: " << pipelineCache.statusString()
+              << ", pipelines built in " << buildMs << " ms";
+    if (pipelineCache.hit())
+      std::cout << " (saved " << pipelineCache.timeSavedMs()
+                << " ms vs cold compile)";
+    std::cout << std::endl;
+  }
+}
+
+void LiquidIslandApp::createStartupPipeline() {
+  auto buildStart = Clock::now();
+  startupPipeline = buildGraphicsPipeline(
+      swapChainImageFormat, aura_shaders::shader_vert,
+      aura_shaders::shader_vert_size, aura_shaders::startup_frag,
+      aura_shaders::startup_frag_size, nullptr);
+  std::cout << "Startup pipeline built in " << toMs(Clock::now() - buildStart)
+            << " ms" << std::endl;
+}
+
+void LiquidIslandApp::startPipelineBuild() {
+  // Reads only objects that outlive it (device, layouts, render passes,
+  // cache). recreateSwapChain rewrites swapChainImageFormat on the render
+  // thread, so the builder gets its own copy
+  vk::Format colorFormat = swapChainImageFormat;
+  pipelineBuilder = std::thread([this, colorFormat] {
+    try {
+      createGraphicsPipeline(colorFormat);
+    } catch (...) {
+      pipelineBuildError = std::current_exception();
+    }
+    pipelinesReady.store(true, std::memory_order_release);
+    wakeRenderThread();
+  });
+}
+
+void LiquidIslandApp::activateFullPipelines() {
+  pipelineBuilder.join();
+  if (pipelineBuildError)
+    std::rethrow_exception(pipelineBuildError);
+  fullPipelinesActive = true;
+  std::cout << "Startup: full-quality liquid after "
+            << toMs(Clock::now() - startTime) << " ms" << std::endl;
+}
+
+void LiquidIslandApp::createFramebuffers() {
+  // Dynamic rendering binds image views directly
+  if (dynamicRenderingEnabled)
+    return;
+  swapChainFramebuffers.resize(swapChainImageViews.size());
+  for (size_t i = 0; i < swapChainImageViews.size(); i++) {
+    vk::ImageView attachments[] = {swapChainImageViews[i]};
+    vk::FramebufferCreateInfo framebufferInfo({}, renderPass, 1, attachments,
+                                              swapChainExtent.width,
+                                              swapChainExtent.height, 1);
+    swapChainFramebuffers[i] = device.createFramebuffer(framebufferInfo);
+  }
+}
+
+void LiquidIslandApp::createLiquidLayerResources() {
+  config.renderScale = std::clamp(config.renderScale, 0.25f, 1.0f);
+  config.minRenderScale = std::clamp(config.minRenderScale, 0.25f, 1.0f);
+  liquidLayerEnabled = config.dynamicResolution || config.renderScale < 1.0f;
+  if (!liquidLayerEnabled)
+    return;
+
+  vk::DescriptorSetLayoutBinding binding(
+      0, vk::DescriptorType::eCombinedImageSampler, 1,
+      vk::ShaderStageFlagBits::eFragment);
+  liquidLayerSetLayout = device.createDescriptorSetLayout({{}, 1, &binding});
+  vk::DescriptorSetLayout setLayouts[] = {descriptorSetLayout,
+                                          liquidLayerSetLayout};
+  upscalePipelineLayout = device.createPipelineLayout({{}, 2, setLayouts});
+
+  vk::SamplerCreateInfo samplerInfo(
+      {}, vk::Filter::eLinear, vk::Filter::eLinear,
+      vk::SamplerMipmapMode::eNearest, vk::SamplerAddressMode::eClampToEdge,
+      vk::SamplerAddressMode::eClampToEdge,
+      vk::SamplerAddressMode::eClampToEdge);
+  liquidLayerSampler = device.createSampler(samplerInfo);
+
+  if (dynamicRenderingEnabled)
+    return;
+  // Cleared to transparent so the upscale sees coverage, and left ready to
+  // be sampled by the upscale pass that follows
+  vk::AttachmentDescription colorAttachment(
+      {}, swapChainImageFormat, vk::SampleCountFlagBits::e1,
+      vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
+      vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+      vk::ImageLayout::eUndefined, vk::ImageLayout::eShaderReadOnlyOptimal);
+  vk::AttachmentReference colorRef(0, vk::ImageLayout::eColorAttachmentOptimal);
+  vk::SubpassDescription subpass({}, vk::PipelineBindPoint::eGraphics, 0,
+                                 nullptr, 1, &colorRef);
+  vk::SubpassDependency toUpscale(
+      0, VK_SUBPASS_EXTERNAL, vk::PipelineStageFlagBits::eColorAttachmentOutput,
+      vk::PipelineStageFlagBits::eFragmentShader,
+      vk::AccessFlagBits::eColorAttachmentWrite,
+      vk::AccessFlagBits::eShaderRead);
+  vk::RenderPassCreateInfo createInfo({}, 1, &colorAttachment, 1, &subpass, 1,
+                                      &toUpscale);
+  liquidLayerRenderPass = device.createRenderPass(createInfo);
+}
+
+void LiquidIslandApp::createLiquidLayer() {
+  if (!liquidLayerEnabled)
+    return;
+  // Full size: any scale fits, so a new one only needs re-recording
+  uint32_t count = config.framesInFlight;
+  LiquidLayer layer;
+  layer.images.resize(count);
+  layer.memory.resize(count);
+  layer.views.resize(count);
+  for (uint32_t i = 0; i < count; i++) {
+    vk::ImageCreateInfo imageInfo(
+        {}, vk::ImageType::e2D, swapChainImageFormat,
+        vk::Extent3D{swapChainExtent.width, swapChainExtent.height, 1}, 1, 1,
+        vk::SampleCountFlagBits::e1, vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eColorAttachment |
+            vk::ImageUsageFlagBits::eSampled,
+        vk::SharingMode::eExclusive);
+    layer.images[i] = createDeviceImage(imageInfo, layer.memory[i]);
+    layer.views[i] = device.createImageView(
+        {{}, layer.images[i], vk::ImageViewType::e2D, swapChainImageFormat,
+         {}, {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}});
+    if (!dynamicRenderingEnabled)
+      layer.framebuffers.push_back(device.createFramebuffer(
+          {{}, liquidLayerRenderPass, 1, &layer.views[i],
+           swapChainExtent.width, swapChainExtent.height, 1}));
+  }
+
+  // A pool per generation: the sets of a retired layer may still be bound
+  // by frames in flight, so they are never updated, only freed with it
+  vk::DescriptorPoolSize poolSize(vk::DescriptorType::eCombinedImageSampler,
+                                  count);
+  layer.descriptorPool = device.createDescriptorPool({{}, count, 1, &poolSize});
+  std::vector<vk::DescriptorSetLayout> layouts(count, liquidLayerSetLayout);
+  layer.descriptorSets = device.allocateDescriptorSets(
+      {layer.descriptorPool, count, layouts.data()});
+  for (uint32_t i = 0; i < count; i++) {
+    vk::DescriptorImageInfo imageInfo(liquidLayerSampler, layer.views[i],
+                                      vk::ImageLayout::eShaderReadOnlyOptimal);
+    vk::WriteDescriptorSet write(layer.descriptorSets[i], 0, 0, 1,
+                                 vk::DescriptorType::eCombinedImageSampler,
+                                 &imageInfo);
+    device.updateDescriptorSets(write, nullptr);
+  }
+  liquidLayer = std::move(layer);
+}
+
+void LiquidIslandApp::destroyLiquidLayer(LiquidLayer &layer) {
+  // The sets go with their pool
+  device.destroyDescriptorPool(layer.descriptorPool);
+  for (auto framebuffer : layer.framebuffers)
+    device.destroyFramebuffer(framebuffer);
+  for (auto view : layer.views)
+    device.destroyImageView(view);
+  for (size_t i = 0; i < layer.images.size(); i++)
+    destroyDeviceImage(layer.images[i], layer.memory[i]);
+  layer = LiquidLayer();
+}
+
+vk::Extent2D LiquidIslandApp::liquidLayerExtent(float scale) const {
+  // Same rounding as upscale.frag's layerSize
+  float width = std::ceil((float)swapChainExtent.width * scale);
+  float height = std::ceil((float)swapChainExtent.height * scale);
+  return vk::Extent2D{std::max(1u, (uint32_t)width),
+                      std::max(1u, (uint32_t)height)};
+}
+
+void LiquidIslandApp::createCommandPool() {
+  QueueFamilyIndices queueFamilyIndices = findQueueFamilies(physicalDevice);
+  vk::CommandPoolCreateInfo poolInfo(
+      vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+      queueFamilyIndices.graphicsFamily.value());
+  commandPool = device.createCommandPool(poolInfo);
+}
+
+void LiquidIslandApp::createUniformRing() {
+  // Both rings are reservations at the front of every arena slot, so a
+  // frame's uniforms and instances are written into the slot its fence
+  // just freed
+  uint32_t islands = std::max(config.islandCount, 1u);
+  vk::DeviceSize perFrame = sizeof(LiquidFrameUniforms) +
+                            IslandInstanceRing::slotSize(islands) +
+                            2 * FrameUploadArena::MAX_ALIGNMENT;
+  if (!uploadArena.init(memoryAllocator, perFrame, config.framesInFlight,
+                        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
+    throw std::runtime_error("failed to create upload arena!");
+  if (!uniformRing.init(uploadArena, sizeof(LiquidFrameUniforms)))
+    throw std::runtime_error("failed to create uniform ring!");
+  if (!islandRing.init(uploadArena, islands))
+    throw std::runtime_error("failed to create island instance ring!");
+}
+
+void LiquidIslandApp::createTileBuffer() {
+  // Fixed size, so a resize never has to touch the descriptor set while
+  // frames are in flight. A 360x120 island covers ~300 tiles, a 120x32 pill
+  // ~40.
+  tileCapacity = config.tileListCapacity
+                     ? config.tileListCapacity
+                     : std::max(8192u, islandRing.capacity() * 128u);
+  vk::DeviceSize alignment = physicalDevice.getProperties()
+                                 .limits.minStorageBufferOffsetAlignment;
+  vk::DeviceSize slotSize =
+      TILE_LIST_HEADER_SIZE + (vk::DeviceSize)tileCapacity * 2 * sizeof(uint32_t);
+  tileSlotStride = (slotSize + alignment - 1) / alignment * alignment;
+
+  vk::BufferCreateInfo bufferInfo(
+      {}, tileSlotStride * config.framesInFlight,
+      vk::BufferUsageFlagBits::eStorageBuffer |
+          vk::BufferUsageFlagBits::eIndirectBuffer |
+          vk::BufferUsageFlagBits::eTransferDst,
+      vk::SharingMode::eExclusive);
+  tileBuffer = createDeviceBuffer(bufferInfo,
+                                  vk::MemoryPropertyFlagBits::eDeviceLocal, {},
+                                  tileMemory);
+}
+
+void LiquidIslandApp::recordTileClassification(vk::CommandBuffer commandBuffer,
+                                               uint32_t frame) {
+  vk::DeviceSize slotOffset = tileSlotStride * frame;
+  // Two empty VkDrawIndirectCommands (6 vertices per tile) and used = 0
+  const uint32_t header[TILE_LIST_HEADER_SIZE / sizeof(uint32_t)] = {
+      6, 0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0};
+  commandBuffer.updateBuffer(tileBuffer, slotOffset, sizeof(header), header);
+  bufferBarrier(commandBuffer, synchronization2Enabled,
+                {vk::PipelineStageFlagBits2::eTransfer,
+                 vk::AccessFlagBits2::eTransferWrite,
+                 vk::PipelineStageFlagBits2::eComputeShader,
+                 vk::AccessFlagBits2::eShaderRead |
+                     vk::AccessFlagBits2::eShaderWrite,
+                 VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, tileBuffer,
+                 slotOffset, tileSlotStride});
+
+  commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
+                             tileClassifyPipeline);
+  uint32_t dynamicOffsets[] = {uniformRing.dynamicOffset(frame),
+                                islandRing.dynamicOffset(frame),
+                                (uint32_t)slotOffset};
+  commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                   pipelineLayout, 0, 1, &descriptorSet, 3,
+                                   dynamicOffsets);
+  // One workgroup per island slot; slots past this frame's count exit early
+  commandBuffer.dispatch(islandRing.capacity(), 1, 1);
+
+  bufferBarrier(commandBuffer, synchronization2Enabled,
+                {vk::PipelineStageFlagBits2::eComputeShader,
+                 vk::AccessFlagBits2::eShaderWrite,
+                 vk::PipelineStageFlagBits2::eDrawIndirect |
+                     vk::PipelineStageFlagBits2::eVertexShader,
+                 vk::AccessFlagBits2::eIndirectCommandRead |
+                     vk::AccessFlagBits2::eShaderRead,
+                 VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, tileBuffer,
+                 slotOffset, tileSlotStride});
+}
+
+void LiquidIslandApp::createDescriptorSets() {
+  vk::DescriptorPoolSize poolSizes[] = {
+      {vk::DescriptorType::eUniformBufferDynamic, 1},
+      {vk::DescriptorType::eStorageBufferDynamic, 2}};
+  vk::DescriptorPoolCreateInfo poolInfo({}, 1, 2, poolSizes);
+  descriptorPool = device.createDescriptorPool(poolInfo);
+
+  vk::DescriptorSetAllocateInfo allocInfo(descriptorPool, 1,
+                                          &descriptorSetLayout);
+  descriptorSet = device.allocateDescriptorSets(allocInfo)[0];
+
+  vk::DescriptorBufferInfo frameInfo(uniformRing.buffer(), 0,
+                                     uniformRing.elementSize());
+  vk::DescriptorBufferInfo islandInfo(islandRing.buffer(), 0,
+                                      islandRing.instancesRange());
+  vk::DescriptorBufferInfo tileInfo(tileBuffer, 0, tileSlotStride);
+  vk::WriteDescriptorSet writes[] = {
+      {descriptorSet, 0, 0, 1, vk::DescriptorType::eUniformBufferDynamic,
+       nullptr, &frameInfo},
+      {descriptorSet, 1, 0, 1, vk::DescriptorType::eStorageBufferDynamic,
+       nullptr, &islandInfo},
+      {descriptorSet, 2, 0, 1, vk::DescriptorType::eStorageBufferDynamic,
+       nullptr, &tileInfo}};
+  device.updateDescriptorSets(
+      vk::ArrayProxy<const vk::WriteDescriptorSet>(
+          config.tiledShading ? 3 : 2, writes),
+      nullptr);
+}
+
+void LiquidIslandApp::createCommandBuffers() {
+  uint32_t imageCount = (uint32_t)swapChainImages.size();
+  uint32_t count = config.recordOnce ? config.framesInFlight * imageCount
+                                     : config.framesInFlight;
+  vk::CommandBufferAllocateInfo allocInfo(
+      commandPool, vk::CommandBufferLevel::ePrimary, count);
+  commandBuffers = device.allocateCommandBuffers(allocInfo);
+
+  if (config.recordOnce) {
+    // Everything that changes per frame lives in the uniform ring, so these
+    // stay valid until the swapchain (and its framebuffers) are recreated
+    // or the quality tier changes.
+    recordedTiers.assign(config.framesInFlight, activeTier);
+    recordedScales.assign(config.framesInFlight, activeScale);
+    recordedFullPipelines.assign(config.framesInFlight, fullPipelinesActive);
+    for (uint32_t frame = 0; frame < config.framesInFlight; frame++)
+      recordFrameSlot(frame);
+  }
+}
+
+void LiquidIslandApp::recordFrameSlot(uint32_t frame) {
+  uint32_t imageCount = (uint32_t)swapChainImages.size();
+  for (uint32_t image = 0; image < imageCount; image++) {
+    vk::CommandBuffer commandBuffer = commandBuffers[frame * imageCount + image];
+    commandBuffer.reset();
+    recordCommandBuffer(commandBuffer, frame, image);
+  }
+  recordedTiers[frame] = activeTier;
+  recordedScales[frame] = activeScale;
+  recordedFullPipelines[frame] = fullPipelinesActive;
+}
+
+void LiquidIslandApp::recordCommandBuffer(vk::CommandBuffer commandBuffer,
+                                          uint32_t frame, uint32_t imageIndex) {
+  vk::CommandBufferBeginInfo beginInfo;
+  commandBuffer.begin(beginInfo);
+  profiler.beginFrame(commandBuffer, frame);
+  // Until the liquid pipelines are in, startup frames draw flat pills
+  // straight into the framebuffer (recordIslandDraws)
+  if (config.tiledShading && fullPipelinesActive) {
+    profiler.beginPass(commandBuffer, frame, "tile classify");
+    recordTileClassification(commandBuffer, frame);
+    profiler.endPass(commandBuffer, frame);
+  }
+
+  if (activeScale < 1.0f && fullPipelinesActive) {
+    // Shade the islands into the slot's liquid layer at activeScale, then
+    // upscale it over the island octagons at full resolution
+    vk::Extent2D layerExtent = liquidLayerExtent(activeScale);
+    profiler.beginPass(commandBuffer, frame, "liquid layer");
+    beginLiquidLayer(commandBuffer, frame, layerExtent);
+    recordIslandDraws(commandBuffer, frame, layerExtent);
+    endLiquidLayer(commandBuffer, frame);
+    profiler.endPass(commandBuffer, frame);
+
+    profiler.beginPass(commandBuffer, frame, "upscale");
+    beginLiquidRendering(commandBuffer, imageIndex);
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics,
+                               upscalePipelines[(uint32_t)activeTier]);
+    vk::Viewport viewport(0.0f, 0.0f, (float)swapChainExtent.width,
+                          (float)swapChainExtent.height, 0.0f, 1.0f);
+    commandBuffer.setViewport(0, viewport);
+    commandBuffer.setScissor(0, vk::Rect2D({0, 0}, swapChainExtent));
+    uint32_t dynamicOffsets[] = {uniformRing.dynamicOffset(frame),
+                                  islandRing.dynamicOffset(frame),
+                                  (uint32_t)(tileSlotStride * frame)};
+    vk::DescriptorSet sets[] = {descriptorSet,
+                                liquidLayer.descriptorSets[frame]};
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+                                     upscalePipelineLayout, 0, 2, sets,
+                                     config.tiledShading ? 3 : 2,
+                                     dynamicOffsets);
+    islandRing.recordDraw(commandBuffer, frame);
+    endLiquidRendering(commandBuffer, imageIndex);
+    profiler.endPass(commandBuffer, frame);
+  } else {
+    profiler.beginPass(commandBuffer, frame, "liquid");
+    beginLiquidRendering(commandBuffer, imageIndex);
+    recordIslandDraws(commandBuffer, frame, swapChainExtent);
+    endLiquidRendering(commandBuffer, imageIndex);
+    profiler.endPass(commandBuffer, frame);
+  }
+  profiler.endFrame(commandBuffer, frame);
+  commandBuffer.end();
+}
+
+void LiquidIslandApp::recordIslandDraws(vk::CommandBuffer commandBuffer,
+                                        uint32_t frame, vk::Extent2D extent) {
+  uint32_t tier = (uint32_t)activeTier;
+  commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics,
+                             fullPipelinesActive ? graphicsPipelines[tier]
+                                                 : startupPipeline);
+  // Island geometry is in framebuffer pixels mapped to NDC, so a smaller
+  // viewport renders the same scene at a lower resolution
+  vk::Viewport viewport(0.0f, 0.0f, (float)extent.width,
+                        (float)extent.height, 0.0f, 1.0f);
+  vk::Rect2D scissor({0, 0}, extent);
+  commandBuffer.setViewport(0, viewport);
+  commandBuffer.setScissor(0, scissor);
+
+  uint32_t dynamicOffsets[] = {uniformRing.dynamicOffset(frame),
+                                islandRing.dynamicOffset(frame),
+                                (uint32_t)(tileSlotStride * frame)};
+  commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+                                   pipelineLayout, 0, 1, &descriptorSet,
+                                   config.tiledShading ? 3 : 2,
+                                   dynamicOffsets);
+
+  if (config.tiledShading && fullPipelinesActive) {
+    // Edge tiles get the full warp, interior tiles a flat fill; the counts
+    // were written by the classification pass
+    vk::DeviceSize slotOffset = tileSlotStride * frame;
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics,
+                               tileEdgePipelines[tier]);
+    commandBuffer.drawIndirect(tileBuffer, slotOffset, 1,
+                               sizeof(VkDrawIndirectCommand));
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics,
+                               tileInteriorPipelines[tier]);
+    commandBuffer.drawIndirect(tileBuffer,
+                               slotOffset + sizeof(VkDrawIndirectCommand), 1,
+                               sizeof(VkDrawIndirectCommand));
+  } else {
+    // Every island in one instanced draw; the count lives in the island ring
+    islandRing.recordDraw(commandBuffer, frame);
+  }
+}
+
+void LiquidIslandApp::beginLiquidLayer(vk::CommandBuffer commandBuffer,
+                                       uint32_t frame, vk::Extent2D extent) {
+  vk::ClearValue transparent(
+      vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f}));
+  vk::Rect2D renderArea({0, 0}, extent);
+  if (!dynamicRenderingEnabled) {
+    vk::RenderPassBeginInfo renderPassInfo(
+        liquidLayerRenderPass, liquidLayer.framebuffers[frame], renderArea, 1,
+        &transparent);
+    commandBuffer.beginRenderPass(renderPassInfo,
+                                  vk::SubpassContents::eInline);
+    return;
+  }
+
+  // The slot's previous upscale read it before that frame retired
+  vk::ImageMemoryBarrier2 toAttachment(
+      vk::PipelineStageFlagBits2::eColorAttachmentOutput, {},
+      vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+      vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eUndefined,
+      vk::ImageLayout::eColorAttachmentOptimal, VK_QUEUE_FAMILY_IGNORED,
+      VK_QUEUE_FAMILY_IGNORED, liquidLayer.images[frame],
+      {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
+  commandBuffer.pipelineBarrier2(
+      vk::DependencyInfo({}, 0, nullptr, 0, nullptr, 1, &toAttachment));
+
+  vk::RenderingAttachmentInfo colorAttachment(
+      liquidLayer.views[frame], vk::ImageLayout::eColorAttachmentOptimal,
+      vk::ResolveModeFlagBits::eNone, {}, vk::ImageLayout::eUndefined,
+      vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
+      transparent);
+  vk::RenderingInfo renderingInfo({}, renderArea, 1, 0, 1, &colorAttachment);
+  commandBuffer.beginRendering(renderingInfo);
+}
+
+void LiquidIslandApp::endLiquidLayer(vk::CommandBuffer commandBuffer,
+                                     uint32_t frame) {
+  if (!dynamicRenderingEnabled) {
+    commandBuffer.endRenderPass();
+    return;
+  }
+  commandBuffer.endRendering();
+
+  // The render pass path does this with its final layout and dependency
+  vk::ImageMemoryBarrier2 toSampled(
+      vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+      vk::AccessFlagBits2::eColorAttachmentWrite,
+      vk::PipelineStageFlagBits2::eFragmentShader,
+      vk::AccessFlagBits2::eShaderSampledRead,
+      vk::ImageLayout::eColorAttachmentOptimal,
+      vk::ImageLayout::eShaderReadOnlyOptimal, VK_QUEUE_FAMILY_IGNORED,
+      VK_QUEUE_FAMILY_IGNORED, liquidLayer.images[frame],
+      {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
+  commandBuffer.pipelineBarrier2(
+      vk::DependencyInfo({}, 0, nullptr, 0, nullptr, 1, &toSampled));
+}
+
+void LiquidIslandApp::beginLiquidRendering(vk::CommandBuffer commandBuffer,
+                                           uint32_t imageIndex) {
+  vk::ClearValue clearColor(
+      vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f}));
+  vk::Rect2D renderArea({0, 0}, swapChainExtent);
+  if (!dynamicRenderingEnabled) {
+    vk::RenderPassBeginInfo renderPassInfo(
+        renderPass, swapChainFramebuffers[imageIndex], renderArea, 1,
+        &clearColor);
+    commandBuffer.beginRenderPass(renderPassInfo,
+                                  vk::SubpassContents::eInline);
+    return;
+  }
+
+  // What the render pass did implicitly: discard the old contents and move
+  // the image into attachment layout. The source stage matches the stage
+  // that waits on the acquire semaphore.
+  vk::ImageMemoryBarrier2 toAttachment(
+      vk::PipelineStageFlagBits2::eColorAttachmentOutput, {},
+      vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+      vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eUndefined,
+      vk::ImageLayout::eColorAttachmentOptimal, VK_QUEUE_FAMILY_IGNORED,
+      VK_QUEUE_FAMILY_IGNORED, swapChainImages[imageIndex],
+      {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
+  commandBuffer.pipelineBarrier2(
+      vk::DependencyInfo({}, 0, nullptr, 0, nullptr, 1, &toAttachment));
+
+  vk::RenderingAttachmentInfo colorAttachment(
+      swapChainImageViews[imageIndex], vk::ImageLayout::eColorAttachmentOptimal,
+      vk::ResolveModeFlagBits::eNone, {}, vk::ImageLayout::eUndefined,
+      vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, clearColor);
+  vk::RenderingInfo renderingInfo({}, renderArea, 1, 0, 1, &colorAttachment);
+  commandBuffer.beginRendering(renderingInfo);
+}
+
+void LiquidIslandApp::endLiquidRendering(vk::CommandBuffer commandBuffer,
+                                         uint32_t imageIndex) {
+  if (!dynamicRenderingEnabled) {
+    commandBuffer.endRenderPass();
+    return;
+  }
+  commandBuffer.endRendering();
+
+  // Headless frames stay readable by transfers, swapchain images go to the
+  // presentation engine, which waits on the render-finished semaphore
+  // signaled after all commands
+  bool headless = config.headless;
+  vk::ImageMemoryBarrier2 toFinal(
+      vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+      vk::AccessFlagBits2::eColorAttachmentWrite,
+      headless ? vk::PipelineStageFlagBits2::eTransfer
+               : vk::PipelineStageFlagBits2::eNone,
+      headless ? vk::AccessFlagBits2::eTransferRead : vk::AccessFlags2(),
+      vk::ImageLayout::eColorAttachmentOptimal,
+      headless ? vk::ImageLayout::eTransferSrcOptimal
+               : vk::ImageLayout::ePresentSrcKHR,
+      VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+      swapChainImages[imageIndex],
+      {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
+  commandBuffer.pipelineBarrier2(
+      vk::DependencyInfo({}, 0, nullptr, 0, nullptr, 1, &toFinal));
+}
+
+void LiquidIslandApp::updateUniforms(uint32_t frame) {
+  LiquidFrameUniforms *u = uniformRing.at<LiquidFrameUniforms>(frame);
+  // Headless runs are driven by drawFrame() alone and use wall time, unless
+  // pinned for image comparisons
+  float time = animationTime;
+  if (config.headless)
+    time = config.shaderTime >= 0.0f ? config.shaderTime : elapsedSeconds();
+  float width = (float)swapChainExtent.width;
+  float height = (float)swapChainExtent.height;
+  u->timing[0] = time;
+  u->timing[1] = activeScale;
+  std::copy(fluidCurve, fluidCurve + 4, u->fluidCurve);
+  u->resolution[0] = width;
+  u->resolution[1] = height;
+  u->resolution[2] = 1.0f / width;
+  u->resolution[3] = 1.0f / height;
+  // Matches edgeWidth() in the shaders
+  float edgeWidth = activeScale < 1.0f ? 1.0f / activeScale : 1.0f;
+  u->counts[0] = islandRing.upload(frame, springs, islandStyles, edgeWidth);
+  timings.shadedPixels =
+      islandRing.shadedPixels() * activeScale * activeScale;
+  u->counts[1] = tileCapacity;
+  uniformRing.flush(frame);
+}
+
+void LiquidIslandApp::readbackFrame(std::vector<uint8_t> &pixels) {
+  if (!config.headless)
+    throw std::runtime_error("frame readback needs a headless target!");
+  // Every frame leaves its image in TRANSFER_SRC_OPTIMAL (endLiquidRendering
+  // or the render pass's final layout)
+  device.waitIdle();
+  vk::DeviceSize size =
+      (vk::DeviceSize)swapChainExtent.width * swapChainExtent.height * 4;
+  DeviceAllocation memory;
+  vk::Buffer buffer = createDeviceBuffer(
+      {{}, size, vk::BufferUsageFlagBits::eTransferDst,
+       vk::SharingMode::eExclusive},
+      vk::MemoryPropertyFlagBits::eHostVisible |
+          vk::MemoryPropertyFlagBits::eHostCoherent,
+      {}, memory);
+
+  vk::CommandBuffer commandBuffer = device.allocateCommandBuffers(
+      {commandPool, vk::CommandBufferLevel::ePrimary, 1})[0];
+  commandBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+  vk::BufferImageCopy region(
+      0, 0, 0, {vk::ImageAspectFlagBits::eColor, 0, 0, 1}, {0, 0, 0},
+      vk::Extent3D{swapChainExtent.width, swapChainExtent.height, 1});
+  commandBuffer.copyImageToBuffer(swapChainImages[lastOffscreenImage],
+                                  vk::ImageLayout::eTransferSrcOptimal, buffer,
+                                  region);
+  commandBuffer.end();
+  graphicsQueue.submit(vk::SubmitInfo(0, nullptr, nullptr, 1, &commandBuffer));
+  graphicsQueue.waitIdle();
+
+  pixels.resize((size_t)size);
+  std::memcpy(pixels.data(), memory.mapped, (size_t)size);
+  device.freeCommandBuffers(commandPool, commandBuffer);
+  destroyDeviceBuffer(buffer, memory);
+}
+
+void LiquidIslandApp::lastFrameInputs(
+    LiquidFrameUniforms &uniforms,
+    std::vector<LiquidIslandInstance> &islands) const {
+  if (!config.headless)
+    throw std::runtime_error("frame inputs need a headless target!");
+  // Headless frames render into the image of their frame slot
+  uniforms = *uniformRing.at<LiquidFrameUniforms>(lastOffscreenImage);
+  const LiquidIslandInstance *first = islandRing.instances(lastOffscreenImage);
+  islands.assign(first, first + uniforms.counts[0]);
+}
+
+void LiquidIslandApp::createSyncObjects() {
+  if (!frameTimeline.init((VkDevice)device, config.framesInFlight,
+                          synchronization2Enabled))
+    throw std::runtime_error("failed to create frame timeline!");
+  std::cout << "Frame pacing: "
+            << (frameTimeline.usesTimeline() ? "timeline semaphore"
+                                             : "fence per frame slot")
+            << ", " << frameTimeline.depth() << " frame(s) in flight"
+            << std::endl;
+
+  imageAvailableSemaphores.resize(config.framesInFlight);
+  submitTimes.resize(config.framesInFlight);
+  submitPending.assign(config.framesInFlight, false);
+  for (auto &semaphore : imageAvailableSemaphores)
+    semaphore = device.createSemaphore(vk::SemaphoreCreateInfo());
+}
+
+void LiquidIslandApp::collectRetiredFrame(uint32_t frame) {
+  if (submitPending[frame]) {
+    timings.submitToFenceMs = toMs(Clock::now() - submitTimes[frame]);
+    submitPending[frame] = false;
+  }
+  if (profiler.collect(frame)) {
+    const GpuFrameStats &stats = profiler.latest();
+    timings.gpuMs = stats.gpuTimeMs();
+    timings.fragmentInvocations = stats.fragmentInvocations;
+  }
+}
+
+void LiquidIslandApp::pollKernelEvents() {
+  if (!kernelChannel)
+    return;
+  AuraKernelEvent event;
+  while (aura_kernel_channel_poll_event(kernelChannel, &event)) {
+    switch (event.kind) {
+    case AURA_EVENT_POWER_MODE:
+      kernel.powerMode = event.value;
+      std::cout << "Kernel: power mode " << event.value << " (x"
+                << event.factor << ")" << std::endl;
+      // Power saving trades the liquid's finest detail for battery
+      governor.setCeiling(event.value == AURA_POWER_EFFICIENT
+                              ? QualityTier::Medium
+                              : QualityTier::High);
+      break;
+    case AURA_EVENT_MEMORY_USAGE:
+      kernel.memoryUsed = event.data[0];
+      kernel.memoryCapacity = event.data[1];
+      break;
+    }
+  }
+}
+
+void LiquidIslandApp::pushFrameTelemetry(uint64_t frameNumber) {
+  if (!kernelChannel)
+    return;
+  AuraFrameTelemetry telemetry = {};
+  telemetry.frame_number = frameNumber;
+  telemetry.cpu_frame_ms = (float)timings.frameMs;
+  telemetry.gpu_frame_ms = (float)timings.gpuMs;
+  telemetry.present_ms = (float)timings.presentMs;
+  telemetry.island_count = springs.islandCount();
+  if (!aura_kernel_channel_push_telemetry(kernelChannel, &telemetry))
+    kernel.telemetryDropped++;
+}
+
+void LiquidIslandApp::updateQuality() {
+  // GPU time when timestamps are available; otherwise the CPU frame minus
+  // the waits on the swapchain, which the shader cost does not drive
+  double cost = timings.gpuMs > 0.0
+                    ? timings.gpuMs
+                    : timings.frameMs - timings.acquireMs - timings.presentMs;
+  if (config.dynamicResolution) {
+    if (resolution.addFrame(cost))
+      std::cout << "Render scale: " << resolution.scale() << " ("
+                << resolution.smoothedMs() << " ms per frame)" << std::endl;
+    // Resolution is the cheaper loss on a smooth effect: tiers only move
+    // once it is pinned at either end of its range
+    if (!resolution.atMinimum() && !resolution.atMaximum())
+      return;
+  }
+  if (!config.adaptiveQuality)
+    return;
+  if (governor.addFrame(cost))
+    std::cout << "Quality: " << qualityTierName(governor.tier()) << " ("
+              << governor.smoothedMs() << " ms per frame)" << std::endl;
+}
+
+void LiquidIslandApp::drawFrame() {
+  auto frameStart = Clock::now();
+  pollKernelEvents();
+  // Frame N reuses the slot of frame N - framesInFlight; a single host wait
+  // on the timeline frees it (and runs any release that became due)
+  if (!frameTimeline.waitForSlot())
+    throw std::runtime_error("failed to wait for frame timeline!");
+  uint32_t frame = frameTimeline.slot();
+  collectRetiredFrame(frame);
+  // The liquid pipelines finished in the background; slots switch to them
+  // as they come up, like a tier change
+  if (!fullPipelinesActive && pipelinesReady.load(std::memory_order_acquire))
+    activateFullPipelines();
+  timings.fenceWaitMs = toMs(Clock::now() - frameStart);
+  // A new tier takes effect at a slot boundary; the slot's buffers are
+  // free again now that its previous frame retired
+  activeTier = governor.tier();
+  timings.quality = activeTier;
+  if (config.dynamicResolution)
+    activeScale = resolution.scale();
+  timings.renderScale = activeScale;
+
+  // Offscreen targets are indexed by frame slot, which the wait just freed.
+  uint32_t imageIndex = frame;
+  if (!config.headless) {
+    if (presenter.running()) {
+      VkResult presented = presenter.takeResult();
+      if (presented == VK_SUBOPTIMAL_KHR ||
+          presented == VK_ERROR_OUT_OF_DATE_KHR)
+        swapChainOutdated = true;
+      else if (presented != VK_SUCCESS)
+        throw std::runtime_error("failed to present frame!");
+    }
+    if (swapChainOutdated) {
+      if (!recreateSwapChain())
+        return;
+      swapChainOutdated = false;
+    }
+    auto acquireStart = Clock::now();
+    try {
+      auto result = device.acquireNextImageKHR(
+          swapChain, UINT64_MAX, imageAvailableSemaphores[frame], nullptr);
+      imageIndex = result.value;
+      // Still presentable; finish this frame and recreate on the next one.
+      if (result.result == vk::Result::eSuboptimalKHR)
+        swapChainOutdated = true;
+    } catch (const vk::OutOfDateKHRError &) {
+      // Nothing was acquired or submitted, so the frame number stays put:
+      // retry next frame on a fresh swapchain.
+      swapChainOutdated = true;
+      return;
+    }
+    timings.acquireMs = toMs(Clock::now() - acquireStart);
+  }
+
+  auto recordStart = Clock::now();
+  updateUniforms(frame);
+  vk::CommandBuffer commandBuffer;
+  if (config.recordOnce) {
+    if (recordedTiers[frame] != activeTier ||
+        recordedScales[frame] != activeScale ||
+        recordedFullPipelines[frame] != fullPipelinesActive)
+      recordFrameSlot(frame);
+    commandBuffer = commandBuffers[frame * swapChainImages.size() + imageIndex];
+  } else {
+    commandBuffer = commandBuffers[frame];
+    commandBuffer.reset();
+    recordCommandBuffer(commandBuffer, frame, imageIndex);
+  }
+  timings.recordMs = toMs(Clock::now() - recordStart);
+
+  // Windowed frames wait for the acquire and signal the image's present
+  // semaphore; every frame signals its number on the timeline
+  vk::Semaphore acquired, rendered;
+  if (!config.headless) {
+    acquired = imageAvailableSemaphores[frame];
+    rendered = renderFinishedSemaphores[imageIndex];
+  }
+  uint64_t frameNumber = frameTimeline.frameNumber();
+  VkResult submitted;
+  {
+    std::lock_guard<std::mutex> queueLock(presenter.queueMutex());
+    submitted = frameTimeline.submit(
+        (VkQueue)graphicsQueue, (VkCommandBuffer)commandBuffer,
+        (VkSemaphore)acquired, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        (VkSemaphore)rendered);
+  }
+  if (submitted != VK_SUCCESS)
+    throw std::runtime_error("failed to submit frame!");
+  profiler.markSubmit(frame, frameNumber);
+  submitTimes[frame] = Clock::now();
+  submitPending[frame] = true;
+  if (!firstFrameLogged) {
+    std::cout << "Startup: first frame after "
+              << toMs(submitTimes[frame] - startTime) << " ms"
+              << (fullPipelinesActive ? "" : " (flat pills)") << std::endl;
+    firstFrameLogged = true;
+  }
+
+  if (config.headless) {
+    lastOffscreenImage = imageIndex;
+    if (config.waitEachFrame) {
+      if (!frameTimeline.waitForFrame(frameNumber))
+        throw std::runtime_error("failed to wait for frame timeline!");
+      collectRetiredFrame(frame);
+    }
+  } else if (presenter.running()) {
+    // The present thread takes it from here; this thread moves on to the
+    // next frame's simulation and recording.
+    auto presentStart = Clock::now();
+    uint64_t stalls = presenter.stalledPushes();
+    presenter.push((VkSwapchainKHR)swapChain, imageIndex,
+                   (VkSemaphore)rendered);
+    loop.presentStalls += presenter.stalledPushes() - stalls;
+    timings.presentMs = toMs(Clock::now() - presentStart);
+  } else {
+    auto presentStart = Clock::now();
+    vk::SwapchainKHR swapChains[] = {swapChain};
+    vk::PresentInfoKHR presentInfo(1, &rendered, 1, swapChains, &imageIndex);
+    try {
+      if (presentQueue.presentKHR(presentInfo) == vk::Result::eSuboptimalKHR)
+        swapChainOutdated = true;
+    } catch (const vk::OutOfDateKHRError &) {
+      swapChainOutdated = true;
+    }
+    timings.presentMs = toMs(Clock::now() - presentStart);
+  }
+
+  timings.frameMs = toMs(Clock::now() - frameStart);
+  updateQuality();
+  pushFrameTelemetry(frameNumber);
+}
+
+void LiquidIslandApp::mainLoop() {
+  // The window thread only pumps events; acquire, record, submit and present
+  // happen on the render thread, so input is never stuck behind a GPU wait.
+  std::exception_ptr renderError;
+  std::thread renderer([this, &renderError] {
+    try {
+      renderLoop();
+    } catch (...) {
+      renderError = std::current_exception();
+      glfwSetWindowShouldClose(window, GLFW_TRUE);
+      glfwPostEmptyEvent();
+    }
+  });
+  while (!glfwWindowShouldClose(window))
+    glfwWaitEvents();
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    renderStopRequested = true;
+  }
+  wakeCondition.notify_one();
+  renderer.join();
+  if (renderError)
+    std::rethrow_exception(renderError);
+  printLoopStats();
+}
+
+void LiquidIslandApp::renderLoop() {
+  if (config.pipelinedPresent)
+    presenter.start((VkQueue)presentQueue, config.framesInFlight);
+  auto loopStart = Clock::now();
+  auto lastTick = loopStart;
+  while (true) {
+    bool newTarget = applyPendingTarget();
+    vk::Extent2D framebuffer = framebufferExtent();
+    bool minimised = framebuffer.width == 0 || framebuffer.height == 0;
+    // A finished background pipeline build still has to reach the screen
+    bool pipelineSwapPending =
+        !fullPipelinesActive && pipelinesReady.load(std::memory_order_acquire);
+    bool idle = minimised ||
+                (config.renderOnDemand && !newTarget && springs.allAtRest() &&
+                 !swapChainOutdated && !redrawRequested &&
+                 !pipelineSwapPending);
+    {
+      std::unique_lock<std::mutex> lock(wakeMutex);
+      if (renderStopRequested)
+        break;
+      if (idle) {
+        // Nothing on screen will change: sleep until input, a resize or an
+        // expose event. The wake flag covers events posted since the check.
+        auto waitStart = Clock::now();
+        wakeCondition.wait(
+            lock, [this] { return wakePending || renderStopRequested; });
+        wakePending = false;
+        lastTick = Clock::now();
+        loop.idleSeconds += toMs(lastTick - waitStart) / 1000.0;
+        loop.idleWakeups++;
+        continue;
+      }
+      wakePending = false;
+    }
+
+    auto now = Clock::now();
+    float dt = std::chrono::duration<float>(now - lastTick).count();
+    lastTick = now;
+    // The step that lets the island settle still draws, so the snapped final
+    // shape reaches the screen.
+    springs.step(dt);
+    animationTime += dt;
+    redrawRequested = false;
+    drawFrame();
+    loop.activeFrames++;
+  }
+  loop.totalSeconds = toMs(Clock::now() - loopStart) / 1000.0;
+  // Presents still queued go out first; waitIdle needs every queue to itself
+  presenter.stop();
+  device.waitIdle();
+}
+
+void LiquidIslandApp::printLoopStats() const {
+  double activeSeconds = loop.totalSeconds - loop.idleSeconds;
+  std::cout << "Presents: "
+            << (config.pipelinedPresent ? "pipelined, " : "inline, ")
+            << loop.presentStalls << " stalls, "
+            << (activeSeconds > 0.0 ? loop.activeFrames / activeSeconds : 0.0)
+            << " frames/sec while rendering" << std::endl;
+  std::cout << "Quality: " << qualityTierName(governor.tier());
+  if (config.adaptiveQuality)
+    std::cout << " (adaptive, " << governor.downshifts() << " down, "
+              << governor.upshifts() << " up)";
+  if (liquidLayerEnabled)
+    std::cout << ", render scale " << activeScale;
+  if (config.dynamicResolution)
+    std::cout << " (dynamic, " << resolution.changes() << " changes)";
+  std::cout << std::endl;
+  if (!config.renderOnDemand)
+    return;
+  double idlePercent =
+      loop.totalSeconds > 0.0 ? 100.0 * loop.idleSeconds / loop.totalSeconds
+                              : 0.0;
+  std::cout << "Render on demand: " << loop.activeFrames << " frames rendered, "
+            << loop.idleWakeups << " idle wakeups, " << loop.idleSeconds
+            << " s of " << loop.totalSeconds << " s idle (" << idlePercent
+            << "%)" << std::endl;
+}
+
+void LiquidIslandApp::cleanup() {
+  // A window closed during startup may beat the background pipeline build
+  if (pipelineBuilder.joinable())
+    pipelineBuilder.join();
+  printMemoryStats();
+  aura_kernel_channel_destroy(kernelChannel);
+  kernelChannel = nullptr;
+  profiler.printSummary();
+  profiler.destroy();
+  // Device is idle: releases still deferred (retired swapchains) run now
+  frameTimeline.destroy();
+  for (auto semaphore : renderFinishedSemaphores)
+    device.destroySemaphore(semaphore);
+  for (auto semaphore : imageAvailableSemaphores)
+    device.destroySemaphore(semaphore);
+  device.destroyCommandPool(commandPool);
+  device.destroyDescriptorPool(descriptorPool);
+  uniformRing.destroy();
+  islandRing.destroy();
+  uploadArena.destroy();
+  for (auto framebuffer : swapChainFramebuffers)
+    device.destroyFramebuffer(framebuffer);
+  if (liquidLayerEnabled) {
+    destroyLiquidLayer(liquidLayer);
+    device.destroySampler(liquidLayerSampler);
+    device.destroyRenderPass(liquidLayerRenderPass);
+    device.destroyPipelineLayout(upscalePipelineLayout);
+    device.destroyDescriptorSetLayout(liquidLayerSetLayout);
+  }
+  device.destroyPipeline(startupPipeline);
+  for (uint32_t tier = 0; tier < QUALITY_TIER_COUNT; tier++) {
+    device.destroyPipeline(graphicsPipelines[tier]);
+    device.destroyPipeline(upscalePipelines[tier]);
+    if (config.tiledShading) {
+      device.destroyPipeline(tileEdgePipelines[tier]);
+      device.destroyPipeline(tileInteriorPipelines[tier]);
+    }
+  }
+  if (config.tiledShading) {
+    device.destroyPipeline(tileClassifyPipeline);
+    destroyDeviceBuffer(tileBuffer, tileMemory);
+  }
+  if (pipelineCache.handle() && !pipelineCache.save())
+    std::cerr << "Pipeline cache: failed to write "
+              << config.pipelineCachePath << std::endl;
+  pipelineCache.destroy();
+  device.destroyPipelineLayout(pipelineLayout);
+  device.destroyDescriptorSetLayout(descriptorSetLayout);
+  device.destroyRenderPass(renderPass);
+  for (auto imageView : swapChainImageViews)
+    device.destroyImageView(imageView);
+  if (config.headless) {
+    for (size_t i = 0; i < swapChainImages.size(); i++)
+      destroyDeviceImage(swapChainImages[i], offscreenMemory[i]);
+  } else {
+    device.destroySwapchainKHR(swapChain);
+  }
+  memoryAllocator.destroy();
+  device.destroy();
+  if (surface)
+    instance.destroySurfaceKHR(surface);
+  instance.destroy();
+  if (window) {
+    glfwDestroyWindow(window);
+    glfwTerminate();
+  }
+}
+
+vk::Image LiquidIslandApp::createDeviceImage(const vk::ImageCreateInfo &info,
+                                             DeviceAllocation &allocation) {
+  VkImage image;
+  if (!memoryAllocator.createImage(
+          info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, image, allocation))
+    throw std::runtime_error("failed to allocate image memory!");
+  return image;
+}
+
+vk::Buffer LiquidIslandApp::createDeviceBuffer(
+    const vk::BufferCreateInfo &info, vk::MemoryPropertyFlags required,
+    vk::MemoryPropertyFlags preferred, DeviceAllocation &allocation) {
+  VkBuffer buffer;
+  if (!memoryAllocator.createBuffer(info, (VkMemoryPropertyFlags)required,
+                                    (VkMemoryPropertyFlags)preferred, buffer,
+                                    allocation))
+    throw std::runtime_error("failed to allocate buffer memory!");
+  return buffer;
+}
+
+void LiquidIslandApp::destroyDeviceImage(vk::Image image,
+                                         DeviceAllocation &allocation) {
+  VkImage raw = image;
+  memoryAllocator.destroyImage(raw, allocation);
+}
+
+void LiquidIslandApp::destroyDeviceBuffer(vk::Buffer buffer,
+                                          DeviceAllocation &allocation) {
+  VkBuffer raw = buffer;
+  memoryAllocator.destroyBuffer(raw, allocation);
+}
+
+void LiquidIslandApp::printMemoryStats() const {
+  DeviceMemoryStats stats = memoryAllocator.stats();
+  auto mib = [](VkDeviceSize bytes) { return (double)bytes / (1 << 20); };
+  // Formatted locally so std::cout keeps its own precision
+  std::ostringstream line;
+  line << std::fixed << std::setprecision(1) << "Device memory: "
+       << stats.allocations << " allocations in " << stats.blocks
+       << " blocks + " << stats.dedicated << " dedicated (peak "
+       << stats.peakMemoryObjects << " VkDeviceMemory), "
+       << mib(stats.usedBytes) << " MiB used, " << mib(stats.wastedBytes)
+       << " MiB rounding, " << mib(stats.freeBytes())
+       << " MiB free; upload arena " << uploadArena.reservedBytes() / 1024
+       << " of " << uploadArena.capacity() / 1024 << " KiB per frame";
+  std::cout << line.str() << std::endl;
+}
+
+float LiquidIslandApp::elapsedSeconds() const {
+  return std::chrono::duration<float>(Clock::now() - startTime).count();
+}
@@ -0,0 +1,512 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "DeviceMemoryAllocator.hpp"
+#include "DynamicResolution.hpp"
+#include "FramePresenter.hpp"
+#include "FrameProfiler.hpp"
+#include "FrameTimeline.hpp"
+#include "FrameUploadArena.hpp"
+#include "IslandInstanceRing.hpp"
+#include "LiquidUniforms.hpp"
+#include "PipelineCache.hpp"
+#include "QualityGovernor.hpp"
+#include "SpringBatch.hpp"
+#include "StartupGraph.hpp"
+#include "StateMailbox.hpp"
+#include "SwapchainSupport.hpp"
+#include "UniformRing.hpp"
+
+struct GLFWwindow;
+struct AuraKernelChannel;
+
+const uint32_t WIDTH = 800;
+const uint32_t HEIGHT = 600;
+
+/**
+ * @brief Runtime configuration for LiquidIslandApp.
+ *
+ * In headless mode no window, surface or swapchain is created; frames are
+ * rendered into offscreen VkImages so the pipeline can run on a software
+ * Vulkan driver (lavapipe, SwiftShader) on machines without a display.
+ */
+struct AppConfig {
+  bool headless = false;
+  // Prefer a CPU (software) Vulkan device when several are available.
+  bool preferSoftwareDevice = false;
+  // Frames the CPU may run ahead of the GPU, 1 to FrameTimeline::MAX_DEPTH:
+  // 1 for the lowest input latency, 3 for throughput.
+  uint32_t framesInFlight = 2;
+  // Headless only: wait for each frame to retire right after submit so the
+  // submit-to-fence latency is measured exactly instead of pipelined.
+  bool waitEachFrame = false;
+  // Bracket each pass with GPU timestamps (see FrameProfiler).
+  bool gpuProfiling = true;
+  // Also collect vertex/fragment invocation counts when the device supports
+  // pipelineStatisticsQuery.
+  bool pipelineStatistics = false;
+  // Record one command buffer per (frame in flight, swapchain image) pair at
+  // swapchain creation and only stream per-frame data through the uniform
+  // ring afterwards. When false, command buffers are re-recorded each frame.
+  bool recordOnce = true;
+  // On-disk VkPipelineCache, loaded at startup and saved at shutdown. Empty
+  // disables it.
+  std::string pipelineCachePath = "aura_pipeline_cache.bin";
+  // Present mode policy; the window can be resized at any time and the
+  // swapchain follows within a frame or two.
+  PresentPreference presentPreference = PresentPreference::Balanced;
+  // Windowed only: once every island is at rest, the render thread stops
+  // acquiring, submitting and presenting and sleeps until input, a resize or
+  // an expose event wakes it. The liquid's ambient motion pauses with it.
+  bool renderOnDemand = true;
+  // Windowed only: present on a FramePresenter thread so a blocking
+  // vkQueuePresentKHR (FIFO) overlaps the next frame's simulation and
+  // recording instead of delaying them.
+  bool pipelinedPresent = true;
+  // Islands drawn per frame: the main island plus islandCount - 1 small ones
+  // in a grid. All of them go out in a single instanced draw.
+  uint32_t islandCount = 1;
+  // Run a compute pre-pass that sorts 16x16 screen tiles under each island
+  // into empty (skipped), interior (flat fill) and edge (full liquid warp)
+  // instead of shading every pixel of each island's quad with the warp.
+  bool tiledShading = false;
+  // (tile, island) entries per frame for the tiled path; entries past it are
+  // dropped. 0 sizes it from islandCount.
+  uint32_t tileListCapacity = 0;
+  // Render with vkCmdBeginRendering (no VkRenderPass or VkFramebuffers) when
+  // the device supports Vulkan 1.3; otherwise, or when false, use a render
+  // pass with one framebuffer per swapchain image.
+  bool dynamicRendering = true;
+  // Quality tier of the liquid shader (warp octaves, glow, highlight). Every
+  // tier is a pipeline built at startup, so switching costs no compile.
+  QualityTier quality = QualityTier::High;
+  // Start at `quality` and let a QualityGovernor move between tiers to hold
+  // 120 fps: down when frames run close to the budget, back up when there
+  // is headroom. When false the tier stays at `quality`. Either way the
+  // kernel's power-saving mode caps it at Medium.
+  bool adaptiveQuality = true;
+  // Share of the framebuffer size the liquid layer is shaded at, 0.25 to 1.
+  // Below 1 the islands are rendered into a smaller offscreen target and
+  // upscaled into the framebuffer with their edge rebuilt at full
+  // resolution (shaders/upscale.frag); 1 renders them directly.
+  float renderScale = 1.0f;
+  // Let a DynamicResolution controller move the scale between
+  // minRenderScale and 1 from frame cost, starting at renderScale. The
+  // quality governor then only steps tiers at either end of that range.
+  bool dynamicResolution = false;
+  float minRenderScale = 0.5f;
+  // Shade with shaders/liquid_fast.frag (fp16 arithmetic, polynomial
+  // sin/cos) when the device supports shaderFloat16; otherwise, or when
+  // false, with the full-precision liquid.frag.
+  bool fastMath = false;
+  // Headless only: pin the liquid's shader time to this many seconds
+  // instead of the wall clock, so runs render identical frames. Negative
+  // keeps the wall clock.
+  float shaderTime = -1.0f;
+  // Windowed only: run startup as a dependency graph and draw the islands
+  // as flat pills (shaders/startup.frag) while the liquid pipelines compile
+  // on a background thread, swapping them in once ready. When false, or
+  // headless, the first frame waits for every pipeline.
+  bool progressiveStartup = true;
+  // Switch the kernel to its power-saving mode at startup, as the Android
+  // battery saver does; the kernel's answer caps the quality tier at Medium.
+  bool powerSaving = false;
+  // Initial window (or offscreen target) size.
+  uint32_t width = WIDTH;
+  uint32_t height = HEIGHT;
+};
+
+/**
+ * @brief CPU-side timings of the most recent drawFrame(), in milliseconds.
+ */
+struct FrameTimings {
+  // Host wait on the frame timeline for a free frame slot.
+  double fenceWaitMs = 0.0;
+  // Windowed only: vkAcquireNextImageKHR.
+  double acquireMs = 0.0;
+  double recordMs = 0.0;
+  // Time from queue submit until the frame was observed retired.
+  // When frames are pipelined this is reported one frame late and is an
+  // upper bound; with AppConfig::waitEachFrame it is exact.
+  double submitToFenceMs = 0.0;
+  double frameMs = 0.0;
+  // vkQueuePresentKHR when presenting inline; with pipelined presents only
+  // the wait for room in the present queue.
+  double presentMs = 0.0;
+  // GPU results of the most recently retired frame (framesInFlight behind
+  // the CPU); zero until the first frame retires or if unsupported.
+  double gpuMs = 0.0;
+  uint64_t fragmentInvocations = 0;
+  // Area covered by this frame's island octagons (instanced path), in
+  // pixels; compare with the framebuffer size.
+  double shadedPixels = 0.0;
+  // Liquid shader quality and liquid layer scale this frame was drawn at.
+  QualityTier quality = QualityTier::High;
+  float renderScale = 1.0f;
+};
+
+struct QueueFamilyIndices {
+  std::optional<uint32_t> graphicsFamily;
+  std::optional<uint32_t> presentFamily;
+  bool isComplete(bool needPresent = true) const {
+    return graphicsFamily.has_value() &&
+           (!needPresent || presentFamily.has_value());
+  }
+};
+
+/**
+ * @brief Latest kernel state received over the kernel channel
+ * (aura_kernel_channel_*), applied at the start of each frame.
+ */
+struct KernelStatus {
+  uint32_t powerMode = 1; // AURA_POWER_BALANCED
+  uint64_t memoryUsed = 0;
+  uint64_t memoryCapacity = 0;
+  // Frames whose telemetry found the ring full.
+  uint64_t telemetryDropped = 0;
+};
+
+/**
+ * @brief Render-loop counters for render-on-demand.
+ */
+struct LoopStats {
+  uint64_t activeFrames = 0;
+  // Times the render thread went to sleep with nothing to redraw.
+  uint64_t idleWakeups = 0;
+  double idleSeconds = 0.0;
+  double totalSeconds = 0.0;
+  // Frames whose present had to wait for the present thread to catch up.
+  uint64_t presentStalls = 0;
+};
+
+/**
+ * @brief Reduced-scale liquid layer: one target per frame slot, sized to the
+ * full framebuffer so the scale can change without reallocating, and the
+ * descriptor sets that sample them (set 1 of the upscale pipelines). It
+ * follows the swapchain and is retired with it.
+ */
+struct LiquidLayer {
+  std::vector<vk::Image> images;
+  std::vector<DeviceAllocation> memory;
+  std::vector<vk::ImageView> views;
+  // Null with dynamic rendering.
+  std::vector<vk::Framebuffer> framebuffers;
+  vk::DescriptorPool descriptorPool;
+  std::vector<vk::DescriptorSet> descriptorSets;
+};
+
+/**
+ * @brief Swapchain objects replaced by a resize.
+ *
+ * Frames still in flight may reference them, so they are handed to
+ * FrameTimeline::deferUntilRetired and destroyed once every frame submitted
+ * before the swap has retired; the device is never idled for a resize.
+ */
+struct RetiredSwapchain {
+  vk::SwapchainKHR swapChain;
+  std::vector<vk::ImageView> imageViews;
+  std::vector<vk::Framebuffer> framebuffers;
+  std::vector<vk::CommandBuffer> commandBuffers;
+  std::vector<vk::Semaphore> renderFinishedSemaphores;
+  LiquidLayer liquidLayer;
+};
+
+/**
+ * @brief Desktop Vulkan renderer for the Aura liquid islands.
+ */
+class LiquidIslandApp {
+public:
+  explicit LiquidIslandApp(AppConfig config = {});
+
+  void run();
+
+  // Lower-level entry points used by run() and by the headless benchmark.
+  void init();
+  void drawFrame();
+  void shutdown();
+
+  const FrameTimings &lastFrameTimings() const { return timings; }
+  const char *deviceName() const { return deviceNameStr.c_str(); }
+  const GpuFrameStats &lastGpuStats() const { return profiler.latest(); }
+  const LoopStats &loopStats() const { return loop; }
+  const KernelStatus &kernelStatus() const { return kernel; }
+  const QualityGovernor &qualityGovernor() const { return governor; }
+  const DynamicResolution &dynamicResolution() const { return resolution; }
+  // Whether the liquid runs on liquid_fast.frag (AppConfig::fastMath and
+  // device support).
+  bool fastMathActive() const { return fastMathEnabled; }
+  // Headless only: waits for the GPU and copies the most recently drawn
+  // frame into `pixels`, tightly packed B8G8R8A8 rows. For image tests, not
+  // for use while measuring.
+  void readbackFrame(std::vector<uint8_t> &pixels);
+  // Headless only: the uniforms and island instances the most recent frame
+  // was drawn from, e.g. to render it again with SoftwareLiquidRenderer.
+  void lastFrameInputs(LiquidFrameUniforms &uniforms,
+                       std::vector<LiquidIslandInstance> &islands) const;
+  // Frame numbers and retirement; other subsystems defer releases of
+  // per-frame objects through it instead of idling the device.
+  FrameTimeline &timeline() { return frameTimeline; }
+
+  // Animates the island towards a new shape and wakes an idle render
+  // thread. Never blocks: targets go through a latest-wins mailbox, so only
+  // one thread (the window/UI thread) may call it.
+  void setIslandTarget(const IslandState &target);
+  // Applies the newest posted target and steps the springs; the render loop
+  // does this itself, headless callers driving drawFrame() call it.
+  void stepAnimation(float dt);
+  const StateMailbox<IslandState> &targetMailbox() const { return targets; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  AppConfig config;
+  Clock::time_point startTime;
+
+  GLFWwindow *window = nullptr;
+  vk::Instance instance;
+  vk::SurfaceKHR surface;
+  vk::PhysicalDevice physicalDevice;
+  std::string deviceNameStr;
+  vk::Device device;
+  // Every image and buffer the app creates sub-allocates from here; torn
+  // down right before the device.
+  DeviceMemoryAllocator memoryAllocator;
+  vk::Queue graphicsQueue;
+  vk::Queue presentQueue;
+
+  vk::SwapchainKHR swapChain;
+  std::vector<vk::Image> swapChainImages;
+  vk::Format swapChainImageFormat = vk::Format::eUndefined;
+  vk::Extent2D swapChainExtent;
+  std::vector<vk::ImageView> swapChainImageViews;
+  std::vector<vk::Framebuffer> swapChainFramebuffers;
+  // Set by the framebuffer-size callback and by SUBOPTIMAL/OUT_OF_DATE
+  // results; the next drawFrame() recreates the swapchain.
+  std::atomic<bool> swapChainOutdated{false};
+  // Latest framebuffer size from the window thread (width | height << 32);
+  // GLFW may only be queried there.
+  std::atomic<uint64_t> framebufferSize{0};
+
+  // Headless render targets; stand in for swapchain images, one per frame
+  // slot so the slot wait also guards the image.
+  std::vector<DeviceAllocation> offscreenMemory;
+  // Image of the most recent headless frame, for readbackFrame()
+  uint32_t lastOffscreenImage = 0;
+
+  // Null with dynamic rendering, as are the framebuffers.
+  vk::RenderPass renderPass;
+  bool dynamicRenderingEnabled = false;
+  // liquid_fast.frag instead of liquid.frag (shaderFloat16 enabled)
+  bool fastMathEnabled = false;
+  vk::DescriptorSetLayout descriptorSetLayout;
+  PipelineCache pipelineCache;
+  vk::PipelineLayout pipelineLayout;
+  // One pipeline per QualityTier (liquidQualitySpec), indexed by tier
+  vk::Pipeline graphicsPipelines[QUALITY_TIER_COUNT];
+  // Progressive startup: flat pills drawn until the pipelines above (and
+  // the upscale and tiled ones) are built by pipelineBuilder. pipelinesReady
+  // is set by that thread; the render thread joins it at a frame slot
+  // boundary and flips fullPipelinesActive, re-recording slot by slot.
+  vk::Pipeline startupPipeline;
+  std::thread pipelineBuilder;
+  std::exception_ptr pipelineBuildError;
+  std::atomic<bool> pipelinesReady{false};
+  bool fullPipelinesActive = false;
+  bool firstFrameLogged = false;
+
+  vk::CommandPool commandPool;
+  // recordOnce: framesInFlight * image count buffers, indexed
+  // [frame * imageCount + image]; otherwise one per frame in flight.
+  std::vector<vk::CommandBuffer> commandBuffers;
+  // recordOnce: tier each frame slot's buffers were recorded with; a slot
+  // is re-recorded once its frame retires after the governor switched.
+  std::vector<QualityTier> recordedTiers;
+  std::vector<float> recordedScales;
+  std::vector<bool> recordedFullPipelines;
+  // Render thread only: pick the tier and liquid layer scale of the next
+  // frame slot to start.
+  QualityGovernor governor;
+  QualityTier activeTier = QualityTier::High;
+  DynamicResolution resolution;
+  float activeScale = 1.0f;
+
+  // Liquid layer (AppConfig::renderScale, dynamicResolution). The islands'
+  // pipelines render into it unchanged (same format); the upscale pipelines
+  // draw the island octagons again and sample it through set 1.
+  bool liquidLayerEnabled = false;
+  LiquidLayer liquidLayer;
+  vk::RenderPass liquidLayerRenderPass;
+  vk::DescriptorSetLayout liquidLayerSetLayout;
+  vk::Sampler liquidLayerSampler;
+  vk::PipelineLayout upscalePipelineLayout;
+  vk::Pipeline upscalePipelines[QUALITY_TIER_COUNT];
+
+  // Per-frame LiquidFrameUniforms, bound with a dynamic offset per frame slot.
+  UniformRing uniformRing;
+  vk::DescriptorPool descriptorPool;
+  vk::DescriptorSet descriptorSet;
+  // Per-frame island instances and their indirect draw (binding 1).
+  IslandInstanceRing islandRing;
+  // Backs uniformRing and islandRing, one slot per frame in flight.
+  FrameUploadArena uploadArena;
+
+  // Tiled path: per frame slot, the edge and interior VkDrawIndirectCommands,
+  // a use counter and the (tile, island) lists (binding 2; see
+  // shaders/tile_classify.comp).
+  static constexpr vk::DeviceSize TILE_LIST_HEADER_SIZE = 48;
+  vk::Buffer tileBuffer;
+  DeviceAllocation tileMemory;
+  vk::DeviceSize tileSlotStride = 0;
+  uint32_t tileCapacity = 0;
+  vk::Pipeline tileClassifyPipeline;
+  vk::Pipeline tileEdgePipelines[QUALITY_TIER_COUNT];
+  vk::Pipeline tileInteriorPipelines[QUALITY_TIER_COUNT];
+
+  // One timeline semaphore paces every frame (see FrameTimeline); the
+  // binary semaphores only talk to the swapchain. Acquire semaphores are per
+  // frame slot, present semaphores per swapchain image.
+  FrameTimeline frameTimeline;
+  // Owns the present thread; its queue mutex guards graphicsQueue (usually
+  // the same queue) while it runs.
+  FramePresenter presenter;
+  bool synchronization2Enabled = false;
+  std::vector<vk::Semaphore> imageAvailableSemaphores;
+  std::vector<vk::Semaphore> renderFinishedSemaphores;
+
+  FrameProfiler profiler;
+  bool pipelineStatisticsEnabled = false;
+  FrameTimings timings;
+  std::vector<Clock::time_point> submitTimes;
+  std::vector<bool> submitPending;
+
+  // Owned by the render thread; other threads only post targets.
+  SpringBatch springs;
+  std::vector<IslandStyle> islandStyles;
+  uint32_t island = 0;
+  StateMailbox<IslandState> targets;
+  std::atomic<bool> islandExpanded{false};
+  // Shader time; only advances while frames are produced, so the ambient
+  // motion resumes where it paused instead of jumping.
+  float animationTime = 0.0f;
+  // AuraFluidCurve from the kernel, copied into every frame's uniforms
+  float fluidCurve[4] = {};
+  std::atomic<bool> redrawRequested{true};
+  LoopStats loop;
+
+  // Rings to and from the Rust kernel; drawFrame() is the renderer end of
+  // both, so only the thread drawing frames touches them.
+  AuraKernelChannel *kernelChannel = nullptr;
+  KernelStatus kernel;
+
+  // Wakes the render thread when it sleeps at rest. Held only around the
+  // flags, never across GPU work.
+  std::mutex wakeMutex;
+  std::condition_variable wakeCondition;
+  bool wakePending = false;
+  bool renderStopRequested = false;
+
+  static void framebufferResizeCallback(GLFWwindow *window, int width,
+                                        int height);
+  static void mouseButtonCallback(GLFWwindow *window, int button, int action,
+                                  int mods);
+  static void windowRefreshCallback(GLFWwindow *window);
+  void initWindow();
+  void initVulkan();
+  void initKernel();
+  void mainLoop();
+  void renderLoop();
+  void wakeRenderThread();
+  bool applyPendingTarget();
+  vk::Extent2D framebufferExtent() const;
+  void setFramebufferExtent(uint32_t width, uint32_t height);
+  void cleanup();
+
+  void createInstance();
+  void createSurface();
+  void pickPhysicalDevice();
+  bool isDeviceSuitable(vk::PhysicalDevice d);
+  bool checkDeviceExtensionSupport(vk::PhysicalDevice d);
+  QueueFamilyIndices findQueueFamilies(vk::PhysicalDevice d);
+  static bool supportsDynamicRendering(vk::PhysicalDevice d);
+  // shaderFloat16 is core in Vulkan 1.2; Vulkan 1.1 devices may expose it
+  // through VK_KHR_shader_float16_int8, which must then be enabled too.
+  enum class Float16Support { None, Core, Extension };
+  static Float16Support float16Support(vk::PhysicalDevice d);
+  void createLogicalDevice();
+  bool createSwapChain(vk::SwapchainKHR oldSwapChain = {});
+  bool recreateSwapChain();
+  void destroyRetiredSwapchain(RetiredSwapchain &retired);
+  void createOffscreenTargets();
+  void createImageViews();
+  void createRenderFinishedSemaphores();
+  void createRenderPass();
+  void createDescriptorSetLayout();
+  void createPipelineCache();
+  void createGraphicsPipeline(vk::Format colorFormat);
+  void createStartupPipeline();
+  void startPipelineBuild();
+  void activateFullPipelines();
+  vk::Pipeline
+  buildGraphicsPipeline(vk::Format colorFormat, const uint32_t *vertCode,
+                        size_t vertSize, const uint32_t *fragCode,
+                        size_t fragSize,
+                        const vk::SpecializationInfo *fragSpecialization,
+                        const vk::SpecializationInfo *vertSpecialization =
+                            nullptr,
+                        vk::PipelineLayout layout = nullptr);
+  void createTileBuffer();
+  void recordTileClassification(vk::CommandBuffer commandBuffer,
+                                uint32_t frame);
+  void createFramebuffers();
+  void createCommandPool();
+  void createUniformRing();
+  void createDescriptorSets();
+  void createCommandBuffers();
+  void recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t frame,
+                           uint32_t imageIndex);
+  void recordFrameSlot(uint32_t frame);
+  void recordIslandDraws(vk::CommandBuffer commandBuffer, uint32_t frame,
+                         vk::Extent2D extent);
+  void createLiquidLayerResources();
+  void createLiquidLayer();
+  void destroyLiquidLayer(LiquidLayer &layer);
+  vk::Extent2D liquidLayerExtent(float scale) const;
+  void beginLiquidLayer(vk::CommandBuffer commandBuffer, uint32_t frame,
+                        vk::Extent2D extent);
+  void endLiquidLayer(vk::CommandBuffer commandBuffer, uint32_t frame);
+  void updateQuality();
+  void beginLiquidRendering(vk::CommandBuffer commandBuffer,
+                            uint32_t imageIndex);
+  void endLiquidRendering(vk::CommandBuffer commandBuffer, uint32_t imageIndex);
+  void createSyncObjects();
+  void updateUniforms(uint32_t frame);
+  IslandState defaultIslandTarget() const;
+  void addStressIslands();
+  void printLoopStats() const;
+  void pollKernelEvents();
+  void pushFrameTelemetry(uint64_t frameNumber);
+
+  vk::Image createDeviceImage(const vk::ImageCreateInfo &info,
+                              DeviceAllocation &allocation);
+  vk::Buffer createDeviceBuffer(const vk::BufferCreateInfo &info,
+                                vk::MemoryPropertyFlags required,
+                                vk::MemoryPropertyFlags preferred,
+                                DeviceAllocation &allocation);
+  void destroyDeviceImage(vk::Image image, DeviceAllocation &allocation);
+  void destroyDeviceBuffer(vk::Buffer buffer, DeviceAllocation &allocation);
+  void printMemoryStats() const;
+  float elapsedSeconds() const;
+  void collectRetiredFrame(uint32_t frame);
+};
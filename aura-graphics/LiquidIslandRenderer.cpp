@@ -9,8 +9,8 @@ LiquidIslandRenderer::LiquidIslandRenderer(vk::Instance instance,
       surface(surface) {
 
   // Inisialisasi state awal (Pusat layar, bentuk kecil)
-  currentState = {200.0f, 40.0f, 400.0f, 50.0f, 20.0f};
-  currentVelocity = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  island = springs.addIsland({200.0f, 40.0f, 400.0f, 50.0f, 20.0f}, stiffness,
+                             damping);
 }
 
 LiquidIslandRenderer::~LiquidIslandRenderer() {
@@ -25,30 +25,14 @@ LiquidIslandRenderer::~LiquidIslandRenderer() {
 void LiquidIslandRenderer::updateState(const IslandState &targetState,
                                        float deltaTime) {
   // Logika Spring Physics: a = -k*(x - target) - d*v
-  // Diterapkan pada setiap atribut untuk animasi "Gooey" yang sinkron
-
-  auto calculateSpring = [&](float current, float target,
-                             float &velocity) -> float {
-    float force = -stiffness * (current - target) - damping * velocity;
-    velocity += force * deltaTime;
-    return current + velocity * deltaTime;
-  };
-
-  currentState.width = calculateSpring(currentState.width, targetState.width,
-                                       currentVelocity.width);
-  currentState.height = calculateSpring(currentState.height, targetState.height,
-                                        currentVelocity.height);
-  currentState.x =
-      calculateSpring(currentState.x, targetState.x, currentVelocity.x);
-  currentState.y =
-      calculateSpring(currentState.y, targetState.y, currentVelocity.y);
-  currentState.cornerRadius =
-      calculateSpring(currentState.cornerRadius, targetState.cornerRadius,
-                      currentVelocity.cornerRadius);
+  // Semua atribut dihitung sekaligus oleh SpringBatch (SIMD), dengan solusi
+  // analitik sehingga deltaTime besar setelah hitch tetap stabil
+  springs.setTarget(island, targetState);
+  springs.step(deltaTime);
 
   // Logging performa (Opsional untuk debug 120fps)
-  // std::cout << "[LiquidIsland] Morphing: Width=" << currentState.width <<
-  // std::endl;
+  // std::cout << "[LiquidIsland] Morphing: Width="
+  //           << springs.state(island).width << std::endl;
 }
 
 void LiquidIslandRenderer::createRenderPass() {
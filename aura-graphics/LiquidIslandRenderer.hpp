@@ -4,16 +4,8 @@
 #include <vector>
 #include <iostream>
 
-/**
- * @brief Struct untuk menyimpan status geometri dari Liquid Island.
- */
-struct IslandState {
-    float width;
-    float height;
-    float x;
-    float y;
-    float cornerRadius;
-};
+#include "IslandState.hpp"
+#include "SpringBatch.hpp"
 
 /**
  * @brief LiquidIslandRenderer mengelola siklus hidup grafis Vulkan untuk UI Aura OS.
@@ -31,6 +23,12 @@ public:
      */
     void updateState(const IslandState& targetState, float deltaTime);
 
+    /**
+     * @brief True setelah pulau mencapai target (lihat SpringBatch::atRest);
+     * rendering boleh berhenti sampai target berubah lagi.
+     */
+    bool isAtRest() const { return springs.atRest(island); }
+
     /**
      * @brief Menyiapkan swapchain dan render pass transparan.
      */
@@ -52,9 +50,9 @@ private:
     std::vector<vk::Image> swapChainImages;
     vk::Format swapChainImageFormat;
     
-    // Status Arsitektur Spring Physics
-    IslandState currentState;
-    IslandState currentVelocity;
+    // Status Arsitektur Spring Physics (SoA, lihat SpringBatch)
+    SpringBatch springs;
+    uint32_t island = 0;
     
     // Konstanta Pegas (Dapat dituning untuk feel organik)
     const float stiffness = 150.0f;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "QualityGovernor.hpp"
+#include <cstdint>
+
+/**
+ * @brief Per-frame data read by the liquid shaders (set 0, binding 0).
+ *
+ * Mirrors the std140 `FrameData` block in shaders/liquid_common.glsl; every
+ * member is a 16-byte vector so the C++ and GLSL layouts cannot drift apart.
+ * Shared by the desktop app and the Android LiquidRenderer.
+ */
+struct LiquidFrameUniforms {
+  // x = seconds since start, y = scale of the liquid layer relative to the
+  // framebuffer (1 = rendered directly, see AppConfig::renderScale), zw
+  // reserved
+  float timing[4];
+  // xy = framebuffer size in pixels, zw = 1 / size
+  float resolution[4];
+  // x = islands drawn this frame, y = tile list capacity (tiled path), zw
+  // reserved
+  uint32_t counts[4];
+  // The Rust kernel's fluid-intensity curve (AuraFluidCurve: ripple
+  // frequency/amplitude, wave frequency/amplitude); the shaders evaluate it
+  // per island at seconds + phase.
+  float fluidCurve[4];
+};
+
+static_assert(sizeof(LiquidFrameUniforms) == 64,
+              "LiquidFrameUniforms must match the std140 FrameData block");
+
+/**
+ * @brief Look of one island; geometry comes from its IslandState.
+ */
+struct IslandStyle {
+  // RGB gradient ends; alpha unused.
+  float colorA[4] = {0.1f, 0.5f, 1.0f, 1.0f};  // Aura Blue
+  float colorB[4] = {0.6f, 0.2f, 1.0f, 1.0f};  // Cosmic Purple
+  // Maximum edge displacement of the liquid warp, in pixels.
+  float warpAmplitude = 4.0f;
+  // Distance over which the glow fades out past the edge, in pixels.
+  float glowRadius = 12.0f;
+  // Added to the shader time so neighbouring islands do not wobble in sync.
+  float phase = 0.0f;
+};
+
+/**
+ * @brief One element of the std430 `Islands` storage buffer (set 0,
+ * binding 1); one instance of the island draw each.
+ */
+struct LiquidIslandInstance {
+  // xy = centre, zw = width/height (pixels)
+  float rect[4];
+  // x = corner radius, y = warp amplitude, z = glow radius (pixels),
+  // w = time phase
+  float shape[4];
+  float colorA[4];
+  float colorB[4];
+};
+
+static_assert(sizeof(LiquidIslandInstance) == 64,
+              "LiquidIslandInstance must match the std430 Island struct");
+
+/**
+ * @brief Fragment-stage specialization constants of one quality tier
+ * (constant_id 1-3 in shaders/liquid_common.glsl).
+ */
+struct LiquidQualitySpec {
+  // Octaves of the liquid warp loop in liquid.frag
+  int32_t warpIterations;
+  // VkBool32: glow past the island edge
+  uint32_t glow;
+  // VkBool32: cyan highlight at the island centre
+  uint32_t highlight;
+};
+
+inline LiquidQualitySpec liquidQualitySpec(QualityTier tier) {
+  switch (tier) {
+  case QualityTier::Low:
+    return {1, 0, 0};
+  case QualityTier::Medium:
+    return {2, 1, 0};
+  case QualityTier::High:
+  default:
+    return {3, 1, 1};
+  }
+}
@@ -0,0 +1,176 @@
+#include "PipelineCache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const char kMagic[8] = {'A', 'U', 'R', 'A', 'P', 'S', 'O', '1'};
+
+struct CacheFileHeader {
+  char magic[8];
+  uint32_t headerSize;
+  uint32_t vendorID;
+  uint32_t deviceID;
+  uint32_t driverVersion;
+  uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+  uint64_t dataSize;
+  uint64_t checksum;
+  double coldBuildMs;
+};
+
+uint64_t fnv1a(const uint8_t *data, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Validates the header the driver itself puts in front of the blob.
+bool driverHeaderMatches(const std::vector<uint8_t> &blob,
+                         const VkPhysicalDeviceProperties &props) {
+  const size_t headerSize = 16 + VK_UUID_SIZE;
+  if (blob.size() < headerSize)
+    return false;
+  uint32_t fields[4];
+  std::memcpy(fields, blob.data(), sizeof(fields));
+  return fields[0] >= headerSize && fields[0] <= blob.size() &&
+         fields[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         fields[2] == props.vendorID && fields[3] == props.deviceID &&
+         std::memcmp(blob.data() + 16, props.pipelineCacheUUID,
+                     VK_UUID_SIZE) == 0;
+}
+
+} // namespace
+
+bool PipelineCache::load(VkPhysicalDevice physicalDevice, VkDevice dev,
+                         const std::string &path) {
+  device = dev;
+  filePath = path;
+  vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+  std::vector<uint8_t> blob;
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    loadStatus = Status::Empty;
+  } else {
+    size_t fileSize = (size_t)file.tellg();
+    file.seekg(0);
+    CacheFileHeader header = {};
+    if (fileSize < sizeof(header) ||
+        !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.headerSize != sizeof(header) ||
+        header.dataSize != fileSize - sizeof(header)) {
+      loadStatus = Status::Corrupt;
+    } else if (header.vendorID != props.vendorID ||
+               header.deviceID != props.deviceID ||
+               header.driverVersion != props.driverVersion ||
+               std::memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID,
+                           VK_UUID_SIZE) != 0) {
+      loadStatus = Status::Stale;
+    } else {
+      blob.resize(header.dataSize);
+      if (!file.read(reinterpret_cast<char *>(blob.data()), blob.size()) ||
+          fnv1a(blob.data(), blob.size()) != header.checksum) {
+        loadStatus = Status::Corrupt;
+      } else if (!driverHeaderMatches(blob, props)) {
+        loadStatus = Status::Stale;
+      } else {
+        loadStatus = Status::Hit;
+        coldMs = header.coldBuildMs;
+      }
+    }
+  }
+  if (loadStatus != Status::Hit)
+    blob.clear();
+
+  VkPipelineCacheCreateInfo createInfo = {};
+  createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  createInfo.initialDataSize = blob.size();
+  createInfo.pInitialData = blob.empty() ? nullptr : blob.data();
+  if (vkCreatePipelineCache(device, &createInfo, nullptr, &cache) ==
+      VK_SUCCESS)
+    return true;
+
+  // The driver rejected the blob after all; fall back to an empty cache.
+  loadStatus = Status::Corrupt;
+  createInfo.initialDataSize = 0;
+  createInfo.pInitialData = nullptr;
+  return vkCreatePipelineCache(device, &createInfo, nullptr, &cache) ==
+         VK_SUCCESS;
+}
+
+bool PipelineCache::save() {
+  if (cache == VK_NULL_HANDLE || filePath.empty())
+    return false;
+
+  size_t dataSize = 0;
+  if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS)
+    return false;
+  std::vector<uint8_t> blob(dataSize);
+  if (vkGetPipelineCacheData(device, cache, &dataSize, blob.data()) !=
+      VK_SUCCESS)
+    return false;
+  blob.resize(dataSize);
+
+  CacheFileHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.headerSize = sizeof(header);
+  header.vendorID = props.vendorID;
+  header.deviceID = props.deviceID;
+  header.driverVersion = props.driverVersion;
+  std::memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID,
+              VK_UUID_SIZE);
+  header.dataSize = blob.size();
+  header.checksum = fnv1a(blob.data(), blob.size());
+  header.coldBuildMs = coldMs;
+
+  std::string tmpPath = filePath + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+      return false;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(blob.data()), blob.size());
+    if (!out)
+      return false;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, filePath, ec);
+  return !ec;
+}
+
+void PipelineCache::destroy() {
+  if (cache != VK_NULL_HANDLE)
+    vkDestroyPipelineCache(device, cache, nullptr);
+  cache = VK_NULL_HANDLE;
+}
+
+const char *PipelineCache::statusString() const {
+  switch (loadStatus) {
+  case Status::Hit:
+    return "hit";
+  case Status::Stale:
+    return "miss (stale: device or driver changed)";
+  case Status::Corrupt:
+    return "miss (corrupt file discarded)";
+  case Status::Empty:
+  default:
+    return "miss (no cache file)";
+  }
+}
+
+void PipelineCache::recordBuildTime(double milliseconds) {
+  buildMs = milliseconds;
+  if (!hit())
+    coldMs = milliseconds;
+}
+
+double PipelineCache::timeSavedMs() const {
+  return hit() && coldMs > buildMs ? coldMs - buildMs : 0.0;
+}
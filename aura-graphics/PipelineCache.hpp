@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vulkan/vulkan.h>
+
+/**
+ * @brief VkPipelineCache persisted to disk between launches.
+ *
+ * The driver blob is stored behind a small Aura header carrying the device's
+ * vendor/device ID, driver version, pipelineCacheUUID, the blob size and a
+ * checksum. On load the file is discarded (and an empty cache created) if any
+ * of these no longer match, so a driver update or a truncated write can never
+ * feed stale data to the driver. Written against the C API so the desktop app
+ * and the Android renderer share it; callers do their own logging via
+ * statusString().
+ */
+class PipelineCache {
+public:
+  enum class Status {
+    Empty,   // no file on disk yet
+    Hit,     // blob loaded and accepted
+    Stale,   // written by another device or driver version
+    Corrupt, // truncated, bad magic or checksum mismatch
+  };
+
+  // Always leaves a usable VkPipelineCache behind unless Vulkan itself fails.
+  bool load(VkPhysicalDevice physicalDevice, VkDevice device,
+            const std::string &path);
+  // Writes atomically (temp file + rename). Safe to call more than once.
+  bool save();
+  void destroy();
+
+  VkPipelineCache handle() const { return cache; }
+  Status status() const { return loadStatus; }
+  bool hit() const { return loadStatus == Status::Hit; }
+  const char *statusString() const;
+
+  // Pipeline build time of this run; on a miss it is stored in the file as
+  // the cold-compile reference, on a hit it yields the time saved.
+  void recordBuildTime(double milliseconds);
+  double coldBuildMs() const { return coldMs; }
+  double timeSavedMs() const;
+
+private:
+  VkDevice device = VK_NULL_HANDLE;
+  VkPipelineCache cache = VK_NULL_HANDLE;
+  VkPhysicalDeviceProperties props = {};
+  std::string filePath;
+  Status loadStatus = Status::Empty;
+  double coldMs = 0.0;
+  double buildMs = 0.0;
+};
@@ -0,0 +1,70 @@
+#include "QualityGovernor.hpp"
+
+const char *qualityTierName(QualityTier tier) {
+  switch (tier) {
+  case QualityTier::Low:
+    return "low";
+  case QualityTier::Medium:
+    return "medium";
+  case QualityTier::High:
+    return "high";
+  }
+  return "unknown";
+}
+
+QualityGovernor::QualityGovernor(QualityTier start,
+                                 QualityGovernorSettings settings)
+    : settings(settings), current(start) {}
+
+void QualityGovernor::reset(QualityTier tier) {
+  current = tier > maxTier ? maxTier : tier;
+  primed = false;
+  overBudget = underBudget = settling = 0;
+}
+
+void QualityGovernor::switchTo(QualityTier tier) {
+  if (tier < current)
+    downCount++;
+  else
+    upCount++;
+  current = tier;
+  // Measurements of the old tier say nothing about the new one
+  primed = false;
+  overBudget = underBudget = 0;
+  settling = settings.settleFrames;
+}
+
+bool QualityGovernor::setCeiling(QualityTier tier) {
+  maxTier = tier;
+  if (current <= maxTier)
+    return false;
+  switchTo(maxTier);
+  return true;
+}
+
+bool QualityGovernor::addFrame(double frameCostMs) {
+  if (settling > 0) {
+    settling--;
+    return false;
+  }
+  if (!primed) {
+    average = frameCostMs;
+    primed = true;
+  } else {
+    average += settings.smoothing * (frameCostMs - average);
+  }
+
+  double budget = settings.targetFrameMs;
+  overBudget = average > budget * settings.downshiftRatio ? overBudget + 1 : 0;
+  underBudget = average < budget * settings.upshiftRatio ? underBudget + 1 : 0;
+
+  if (overBudget >= settings.downshiftFrames && current > QualityTier::Low) {
+    switchTo((QualityTier)((uint32_t)current - 1));
+    return true;
+  }
+  if (underBudget >= settings.upshiftFrames && current < maxTier) {
+    switchTo((QualityTier)((uint32_t)current + 1));
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+// Detail levels of the liquid shader, cheapest first (see
+// liquidQualitySpec() in LiquidUniforms.hpp).
+enum class QualityTier : uint32_t { Low = 0, Medium = 1, High = 2 };
+
+static const uint32_t QUALITY_TIER_COUNT = 3;
+
+const char *qualityTierName(QualityTier tier);
+
+/**
+ * @brief Tuning of the QualityGovernor; the defaults hold 120 fps.
+ */
+struct QualityGovernorSettings {
+  double targetFrameMs = 1000.0 / 120.0;
+  // Drop a tier once the smoothed frame cost stays above this share of the
+  // budget for downshiftFrames frames in a row...
+  double downshiftRatio = 0.9;
+  uint32_t downshiftFrames = 15;
+  // ...and only climb back once it stays below this share for upshiftFrames.
+  // The gap between the two ratios and the much longer upshift window are
+  // the hysteresis: a tier that only just fits is kept, not retried.
+  double upshiftRatio = 0.6;
+  uint32_t upshiftFrames = 240;
+  // Frames ignored after a switch while the new pipeline's costs settle.
+  uint32_t settleFrames = 30;
+  // Weight of the newest frame in the moving average.
+  double smoothing = 0.1;
+};
+
+/**
+ * @brief Picks the liquid shader's quality tier from measured frame cost.
+ *
+ * Fed one cost per frame - GPU time where timestamps are available,
+ * otherwise the CPU frame time minus the waits for a swapchain image and a
+ * present - it keeps an exponential moving average and steps one tier down
+ * when that runs close to the frame budget, one tier up when there is ample
+ * headroom. Low-end GPUs thus hold frame rate by losing detail instead of
+ * frames. Pure CPU code; shared by the desktop app and the Android renderer.
+ */
+class QualityGovernor {
+public:
+  explicit QualityGovernor(QualityTier start = QualityTier::High,
+                           QualityGovernorSettings settings = {});
+
+  // Returns true when the tier changed; the caller then switches pipelines.
+  bool addFrame(double frameCostMs);
+  // Highest tier allowed, e.g. Medium while the kernel is in power-saving
+  // mode; lowers the current tier at once if needed.
+  bool setCeiling(QualityTier tier);
+  void reset(QualityTier tier);
+
+  QualityTier tier() const { return current; }
+  QualityTier ceiling() const { return maxTier; }
+  double smoothedMs() const { return average; }
+  uint64_t downshifts() const { return downCount; }
+  uint64_t upshifts() const { return upCount; }
+
+private:
+  void switchTo(QualityTier tier);
+
+  QualityGovernorSettings settings;
+  QualityTier current;
+  QualityTier maxTier = QualityTier::High;
+  double average = 0.0;
+  bool primed = false;
+  uint32_t overBudget = 0;
+  uint32_t underBudget = 0;
+  uint32_t settling = 0;
+  uint64_t downCount = 0;
+  uint64_t upCount = 0;
+};
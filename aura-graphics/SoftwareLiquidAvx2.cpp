@@ -0,0 +1,85 @@
+// AVX2 instantiation of the software liquid kernel. Built with -mavx2 (see
+// CMakeLists.txt) and only called after SoftwareLiquidRenderer checked the
+// CPU, so it includes nothing but intrinsics and the kernel template.
+
+#include "SoftwareLiquidKernel.hpp"
+
+#include <immintrin.h>
+
+namespace aura_software {
+namespace {
+
+struct Avx2 {
+  static constexpr uint32_t WIDTH = 8;
+  __m256 v;
+
+  Avx2(__m256 value) : v(value) {}
+  Avx2(float value) : v(_mm256_set1_ps(value)) {}
+
+  // base, base + 1, ..., base + 7
+  static Avx2 ramp(float base) {
+    return _mm256_add_ps(_mm256_set1_ps(base),
+                         _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7));
+  }
+  void store(float *out) const { _mm256_storeu_ps(out, v); }
+};
+
+Avx2 operator+(Avx2 a, Avx2 b) { return _mm256_add_ps(a.v, b.v); }
+Avx2 operator-(Avx2 a, Avx2 b) { return _mm256_sub_ps(a.v, b.v); }
+Avx2 operator*(Avx2 a, Avx2 b) { return _mm256_mul_ps(a.v, b.v); }
+Avx2 operator/(Avx2 a, Avx2 b) { return _mm256_div_ps(a.v, b.v); }
+Avx2 min(Avx2 a, Avx2 b) { return _mm256_min_ps(a.v, b.v); }
+Avx2 max(Avx2 a, Avx2 b) { return _mm256_max_ps(a.v, b.v); }
+Avx2 sqrt(Avx2 a) { return _mm256_sqrt_ps(a.v); }
+Avx2 abs(Avx2 a) {
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v);
+}
+
+// sin(x + quadrant * pi / 2). Cody-Waite reduction by pi/2 into
+// [-pi/4, pi/4] (exact while |x| / (pi/2) < 2^13), then Cephes' sinf and
+// cosf polynomials there; about 1e-7 from libm for the kernel's angles.
+Avx2 sinQuadrant(Avx2 x, int quadrant) {
+  __m256 j = _mm256_round_ps(
+      _mm256_mul_ps(x.v, _mm256_set1_ps(0.636619772f)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256 r = _mm256_sub_ps(x.v, _mm256_mul_ps(j, _mm256_set1_ps(1.5703125f)));
+  r = _mm256_sub_ps(r,
+                    _mm256_mul_ps(j, _mm256_set1_ps(4.837512969970703125e-4f)));
+  r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(7.549789954891882e-8f)));
+  __m256i q = _mm256_add_epi32(_mm256_cvtps_epi32(j),
+                               _mm256_set1_epi32(quadrant));
+
+  __m256 r2 = _mm256_mul_ps(r, r);
+  __m256 s = _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(-1.9515295891e-4f)),
+                           _mm256_set1_ps(8.3321608736e-3f));
+  s = _mm256_add_ps(_mm256_mul_ps(s, r2), _mm256_set1_ps(-1.6666654611e-1f));
+  s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, r2), r), r);
+  __m256 c = _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(2.443315711809948e-5f)),
+                           _mm256_set1_ps(-1.388731625493765e-3f));
+  c = _mm256_add_ps(_mm256_mul_ps(c, r2), _mm256_set1_ps(4.166664568298827e-2f));
+  c = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(c, r2), r2),
+                    _mm256_sub_ps(_mm256_set1_ps(1.0f),
+                                  _mm256_mul_ps(r2, _mm256_set1_ps(0.5f))));
+
+  // Odd quadrants take the cosine, quadrants 2 and 3 flip the sign
+  __m256i one = _mm256_set1_epi32(1);
+  __m256 odd = _mm256_castsi256_ps(
+      _mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+  __m256 value = _mm256_blendv_ps(s, c, odd);
+  __m256 sign = _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+  return _mm256_xor_ps(value, sign);
+}
+
+Avx2 sin(Avx2 x) { return sinQuadrant(x, 0); }
+Avx2 cos(Avx2 x) { return sinQuadrant(x, 1); }
+
+} // namespace
+
+void shadeSpanAvx2(const IslandShading &island, uint32_t y, uint32_t x0,
+                   uint32_t count, float *red, float *green, float *blue,
+                   float *alpha) {
+  shadeSpan<Avx2>(island, y, x0, count, red, green, blue, alpha);
+}
+
+} // namespace aura_software
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+
+// shaders/liquid.frag transcribed for SoftwareLiquidRenderer. The kernel is
+// written once over a lane pack V of V::WIDTH pixels: one float for the
+// scalar reference, 8 lanes of AVX2 or 4 of NEON. V converts from float,
+// supplies + - * / and store(), and min, max, abs, sqrt, sin and cos as free
+// functions found by argument-dependent lookup.
+//
+// Each lane type lives in an anonymous namespace of the file instantiating
+// the kernel with it. The AVX2 file is compiled with -mavx2, so nothing it
+// instantiates may be shared with (and chosen by the linker for) callers on
+// CPUs without AVX2.
+
+namespace aura_software {
+
+/**
+ * @brief Uniform inputs of liquid.frag for one island, computed once per
+ * frame from its LiquidIslandInstance and the frame's uniforms.
+ */
+struct IslandShading {
+  float centre[2];
+  float halfSize[2];
+  // islandRadius()
+  float radius;
+  // Warp displacement to pixels: shape.y / warpBound()
+  float warpScale;
+  // 0 when the tier has no glow
+  float glowRadius;
+  // fluidIntensity(seconds + phase)
+  float time;
+  float colorA[3];
+  float colorB[3];
+  int32_t warpIterations;
+  bool highlight;
+};
+
+// Shades `count` pixels of row y from column x0 on (pixel centres at +0.5,
+// as rasterized) and stores premultiplied colour and coverage, one array
+// per channel. The arrays need room for count rounded up to V::WIDTH.
+template <class V>
+void shadeSpan(const IslandShading &island, uint32_t y, uint32_t x0,
+               uint32_t count, float *red, float *green, float *blue,
+               float *alpha) {
+  const V zero(0.0f), half(0.5f), one(1.0f);
+  const V time(island.time);
+  const V halfX(island.halfSize[0]), halfY(island.halfSize[1]);
+  const V radius(island.radius);
+  const V warpScale(island.warpScale);
+  // max(halfSize.y, 1.0) and max(halfSize, vec2(1.0))
+  const V uvDivisor(island.halfSize[1] > 1.0f ? island.halfSize[1] : 1.0f);
+  const V centreDivisorX(island.halfSize[0] > 1.0f ? island.halfSize[0]
+                                                   : 1.0f);
+  const V localY((float)y + 0.5f - island.centre[1]);
+  // Also the y of islandColor()'s normalized position
+  const V uvY = localY / uvDivisor;
+
+  for (uint32_t i = 0; i < count; i += V::WIDTH) {
+    V localX = V::ramp((float)(x0 + i) + 0.5f - island.centre[0]);
+    V uvX = localX / uvDivisor;
+
+    // Warping logic
+    V warpedX = uvX, warpedY = uvY;
+    for (int32_t n = 1; n <= island.warpIterations; n++) {
+      float k = (float)n;
+      V amplitude(0.3f / k), frequency(k * 3.0f);
+      warpedX = warpedX + amplitude * sin(frequency * warpedY + time);
+      warpedY = warpedY + amplitude * cos(frequency * warpedX + time);
+    }
+    V px = localX + (warpedX - uvX) * warpScale;
+    V py = localY + (warpedY - uvY) * warpScale;
+
+    // roundedBox(), then smoothstep(1.0, -1.0, d)
+    V qx = abs(px) - halfX + radius;
+    V qy = abs(py) - halfY + radius;
+    V outsideX = max(qx, zero), outsideY = max(qy, zero);
+    V d = sqrt(outsideX * outsideX + outsideY * outsideY) +
+          min(max(qx, qy), zero) - radius;
+    V t = min(max((d - one) / V(-2.0f), zero), one);
+    V coverage = t * t * (V(3.0f) - V(2.0f) * t);
+
+    if (island.glowRadius > 0.0f) {
+      V falloff = min(max(one - d / V(island.glowRadius), zero), one);
+      coverage = max(coverage, falloff * falloff * half);
+    }
+
+    // islandColor()
+    V cx = localX / centreDivisorX;
+    V centre = sqrt(cx * cx + uvY * uvY);
+    V blend = half + half * sin(time * half + centre);
+    V highlight = zero;
+    if (island.highlight) {
+      V h = max(half - centre, zero);
+      highlight = h * h * h;
+    }
+    const float teal[3] = {0.0f, 1.0f, 0.8f};
+    float *out[3] = {red, green, blue};
+    for (int c = 0; c < 3; c++) {
+      V color = V(island.colorA[c]) * (one - blend) +
+                V(island.colorB[c]) * blend;
+      if (island.highlight)
+        color = color * (one - highlight) + V(teal[c]) * highlight;
+      (color * coverage).store(out[c] + i);
+    }
+    coverage.store(alpha + i);
+  }
+}
+
+#ifdef AURA_SOFTWARE_AVX2
+// shadeSpan() on 8 AVX2 lanes (SoftwareLiquidAvx2.cpp); only call it when
+// the CPU supports AVX2.
+void shadeSpanAvx2(const IslandShading &island, uint32_t y, uint32_t x0,
+                   uint32_t count, float *red, float *green, float *blue,
+                   float *alpha);
+#endif
+
+} // namespace aura_software
@@ -0,0 +1,372 @@
+#include "SoftwareLiquidRenderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "SoftwareLiquidKernel.hpp"
+
+// NEON kernel on AArch64 only: it needs vdivq, vsqrtq and vrndnq
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define AURA_SOFTWARE_NEON 1
+#include <arm_neon.h>
+#endif
+
+using aura_software::IslandShading;
+
+namespace {
+
+// The scalar reference: liquid.frag's arithmetic in float, libm sin/cos.
+struct Scalar {
+  static constexpr uint32_t WIDTH = 1;
+  float v;
+
+  Scalar(float value) : v(value) {}
+
+  static Scalar ramp(float base) { return base; }
+  void store(float *out) const { *out = v; }
+};
+
+Scalar operator+(Scalar a, Scalar b) { return a.v + b.v; }
+Scalar operator-(Scalar a, Scalar b) { return a.v - b.v; }
+Scalar operator*(Scalar a, Scalar b) { return a.v * b.v; }
+Scalar operator/(Scalar a, Scalar b) { return a.v / b.v; }
+Scalar min(Scalar a, Scalar b) { return std::min(a.v, b.v); }
+Scalar max(Scalar a, Scalar b) { return std::max(a.v, b.v); }
+Scalar abs(Scalar a) { return std::fabs(a.v); }
+Scalar sqrt(Scalar a) { return std::sqrt(a.v); }
+Scalar sin(Scalar a) { return std::sin(a.v); }
+Scalar cos(Scalar a) { return std::cos(a.v); }
+
+#ifdef AURA_SOFTWARE_NEON
+struct Neon {
+  static constexpr uint32_t WIDTH = 4;
+  float32x4_t v;
+
+  Neon(float32x4_t value) : v(value) {}
+  Neon(float value) : v(vdupq_n_f32(value)) {}
+
+  // base, base + 1, base + 2, base + 3
+  static Neon ramp(float base) {
+    const float offsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    return vaddq_f32(vdupq_n_f32(base), vld1q_f32(offsets));
+  }
+  void store(float *out) const { vst1q_f32(out, v); }
+};
+
+Neon operator+(Neon a, Neon b) { return vaddq_f32(a.v, b.v); }
+Neon operator-(Neon a, Neon b) { return vsubq_f32(a.v, b.v); }
+Neon operator*(Neon a, Neon b) { return vmulq_f32(a.v, b.v); }
+Neon operator/(Neon a, Neon b) { return vdivq_f32(a.v, b.v); }
+Neon min(Neon a, Neon b) { return vminq_f32(a.v, b.v); }
+Neon max(Neon a, Neon b) { return vmaxq_f32(a.v, b.v); }
+Neon abs(Neon a) { return vabsq_f32(a.v); }
+Neon sqrt(Neon a) { return vsqrtq_f32(a.v); }
+
+// sin(x + quadrant * pi / 2); same reduction and polynomials as the AVX2
+// kernel (SoftwareLiquidAvx2.cpp)
+Neon sinQuadrant(Neon x, int quadrant) {
+  float32x4_t j = vrndnq_f32(vmulq_n_f32(x.v, 0.636619772f));
+  float32x4_t r = vmlsq_n_f32(x.v, j, 1.5703125f);
+  r = vmlsq_n_f32(r, j, 4.837512969970703125e-4f);
+  r = vmlsq_n_f32(r, j, 7.549789954891882e-8f);
+  int32x4_t q = vaddq_s32(vcvtq_s32_f32(j), vdupq_n_s32(quadrant));
+
+  float32x4_t r2 = vmulq_f32(r, r);
+  float32x4_t s = vmlaq_n_f32(vdupq_n_f32(8.3321608736e-3f), r2,
+                              -1.9515295891e-4f);
+  s = vmlaq_f32(vdupq_n_f32(-1.6666654611e-1f), s, r2);
+  s = vmlaq_f32(r, vmulq_f32(s, r2), r);
+  float32x4_t c = vmlaq_n_f32(vdupq_n_f32(-1.388731625493765e-3f), r2,
+                              2.443315711809948e-5f);
+  c = vmlaq_f32(vdupq_n_f32(4.166664568298827e-2f), c, r2);
+  c = vmlaq_f32(vmlsq_n_f32(vdupq_n_f32(1.0f), r2, 0.5f), vmulq_f32(c, r2),
+                r2);
+
+  uint32x4_t bits = vreinterpretq_u32_s32(q);
+  uint32x4_t odd = vtstq_u32(bits, vdupq_n_u32(1));
+  float32x4_t value = vbslq_f32(odd, c, s);
+  uint32x4_t sign = vshlq_n_u32(vandq_u32(bits, vdupq_n_u32(2)), 30);
+  return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(value), sign));
+}
+
+Neon sin(Neon x) { return sinQuadrant(x, 0); }
+Neon cos(Neon x) { return sinQuadrant(x, 1); }
+#endif
+
+// liquid.frag's uniform inputs for one island (islandRadius(), warpBound(),
+// fluidIntensity()), evaluated once instead of per pixel
+IslandShading shadingFor(const LiquidFrameUniforms &frame,
+                         const LiquidIslandInstance &island,
+                         const LiquidQualitySpec &quality) {
+  IslandShading s;
+  s.centre[0] = island.rect[0];
+  s.centre[1] = island.rect[1];
+  s.halfSize[0] = island.rect[2] * 0.5f;
+  s.halfSize[1] = island.rect[3] * 0.5f;
+  s.radius = std::min(island.shape[0],
+                      std::min(island.rect[2], island.rect[3]) * 0.5f);
+  float warpBound = 0.0f;
+  for (int32_t i = 1; i <= quality.warpIterations; i++)
+    warpBound += 0.3f / (float)i;
+  s.warpScale = warpBound > 0.0f ? island.shape[1] / warpBound : 0.0f;
+  s.glowRadius = quality.glow ? island.shape[2] : 0.0f;
+  float t = frame.timing[0] + island.shape[3];
+  float ripple = std::sin(t * frame.fluidCurve[0]) * frame.fluidCurve[1];
+  s.time = t + ripple +
+           std::cos(t * frame.fluidCurve[2] + ripple) * frame.fluidCurve[3];
+  for (int c = 0; c < 3; c++) {
+    s.colorA[c] = island.colorA[c];
+    s.colorB[c] = island.colorB[c];
+  }
+  s.warpIterations = quality.warpIterations;
+  s.highlight = quality.highlight != 0;
+  return s;
+}
+
+uint8_t toUnorm8(float value) {
+  value = std::min(std::max(value, 0.0f), 1.0f);
+  return (uint8_t)(value * 255.0f + 0.5f);
+}
+
+} // namespace
+
+// One render() call, shared read-only by every thread
+struct SoftwareLiquidRenderer::Frame {
+  std::vector<IslandShading> islands;
+  // Pixel rectangle each island can colour, [x0, x1) x [y0, y1): the
+  // bounding box of islandBounds(), clipped to the frame
+  std::vector<uint32_t> boxes;
+  SimdLevel level;
+  uint8_t *rgba;
+  uint32_t width, height, stride;
+  uint32_t tilesX, tileCount;
+};
+
+// Per-thread tile buffers; one row of span output per channel
+struct SoftwareLiquidRenderer::Scratch {
+  std::vector<float> tile = std::vector<float>(TILE_SIZE * TILE_SIZE * 4);
+  // TILE_SIZE rounded up to the widest kernel's 8 lanes
+  std::vector<float> span = std::vector<float>((TILE_SIZE + 8) * 4);
+};
+
+SoftwareLiquidRenderer::SoftwareLiquidRenderer(uint32_t threads) {
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  for (uint32_t i = 1; i < threads; i++)
+    workers.emplace_back([this] { workerLoop(); });
+}
+
+SoftwareLiquidRenderer::~SoftwareLiquidRenderer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+void SoftwareLiquidRenderer::setSimdLevel(SimdLevel value) {
+  level = isSupported(value) ? value : SimdLevel::Scalar;
+}
+
+void SoftwareLiquidRenderer::render(const LiquidFrameUniforms &uniforms,
+                                    const LiquidIslandInstance *islands,
+                                    uint32_t islandCount,
+                                    const LiquidQualitySpec &quality,
+                                    uint8_t *rgba, uint32_t width,
+                                    uint32_t height, uint32_t stride) {
+  if (width == 0 || height == 0)
+    return;
+  Frame frame;
+  frame.level = level;
+  frame.rgba = rgba;
+  frame.width = width;
+  frame.height = height;
+  frame.stride = stride ? stride : width * 4;
+  frame.tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+  frame.tileCount = frame.tilesX * ((height + TILE_SIZE - 1) / TILE_SIZE);
+
+  frame.islands.reserve(islandCount);
+  frame.boxes.reserve(islandCount * 4);
+  for (uint32_t i = 0; i < islandCount; i++) {
+    const LiquidIslandInstance &island = islands[i];
+    // islandBounds() at native scale: the warp reach plus the glow or the
+    // one-pixel anti-aliasing ramp, whichever is wider
+    float reachX = island.rect[2] * 0.5f + island.shape[1] +
+                   std::max(island.shape[2], 1.0f);
+    float reachY = island.rect[3] * 0.5f + island.shape[1] +
+                   std::max(island.shape[2], 1.0f);
+    // Pixels whose centre (x + 0.5) lies inside the box
+    float x0 = std::ceil(island.rect[0] - reachX - 0.5f);
+    float x1 = std::floor(island.rect[0] + reachX - 0.5f) + 1.0f;
+    float y0 = std::ceil(island.rect[1] - reachY - 0.5f);
+    float y1 = std::floor(island.rect[1] + reachY - 0.5f) + 1.0f;
+    x0 = std::max(x0, 0.0f);
+    y0 = std::max(y0, 0.0f);
+    x1 = std::min(x1, (float)width);
+    y1 = std::min(y1, (float)height);
+    if (!(x0 < x1 && y0 < y1))
+      continue;
+    frame.islands.push_back(shadingFor(uniforms, island, quality));
+    frame.boxes.insert(frame.boxes.end(), {(uint32_t)x0, (uint32_t)x1,
+                                           (uint32_t)y0, (uint32_t)y1});
+  }
+
+  nextTile.store(0, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    current = &frame;
+    generation++;
+    busyWorkers = (uint32_t)workers.size();
+  }
+  wake.notify_all();
+
+  // This thread works too; the buffers persist across frames
+  static thread_local Scratch scratch;
+  renderTiles(frame, scratch);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  finished.wait(lock, [this] { return busyWorkers == 0; });
+  current = nullptr;
+}
+
+void SoftwareLiquidRenderer::workerLoop() {
+  Scratch scratch;
+  uint64_t seen = 0;
+  for (;;) {
+    const Frame *frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+      frame = current;
+    }
+    renderTiles(*frame, scratch);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--busyWorkers == 0)
+      finished.notify_one();
+  }
+}
+
+void SoftwareLiquidRenderer::renderTiles(const Frame &frame,
+                                         Scratch &scratch) {
+  for (;;) {
+    uint32_t tile = nextTile.fetch_add(1, std::memory_order_relaxed);
+    if (tile >= frame.tileCount)
+      return;
+    renderTile(frame, tile, scratch);
+  }
+}
+
+void SoftwareLiquidRenderer::renderTile(const Frame &frame, uint32_t tile,
+                                        Scratch &scratch) {
+  uint32_t tileX0 = (tile % frame.tilesX) * TILE_SIZE;
+  uint32_t tileY0 = (tile / frame.tilesX) * TILE_SIZE;
+  uint32_t tileX1 = std::min(tileX0 + TILE_SIZE, frame.width);
+  uint32_t tileY1 = std::min(tileY0 + TILE_SIZE, frame.height);
+  uint32_t tileWidth = tileX1 - tileX0;
+
+  // The clear colour: opaque black
+  float *accum = scratch.tile.data();
+  for (uint32_t i = 0; i < TILE_SIZE * TILE_SIZE; i++) {
+    accum[i * 4 + 0] = accum[i * 4 + 1] = accum[i * 4 + 2] = 0.0f;
+    accum[i * 4 + 3] = 1.0f;
+  }
+
+  float *red = scratch.span.data();
+  float *green = red + TILE_SIZE + 8;
+  float *blue = green + TILE_SIZE + 8;
+  float *alpha = blue + TILE_SIZE + 8;
+  for (size_t i = 0; i < frame.islands.size(); i++) {
+    const uint32_t *box = &frame.boxes[i * 4];
+    uint32_t x0 = std::max(box[0], tileX0), x1 = std::min(box[1], tileX1);
+    uint32_t y0 = std::max(box[2], tileY0), y1 = std::min(box[3], tileY1);
+    if (x0 >= x1 || y0 >= y1)
+      continue;
+    const IslandShading &island = frame.islands[i];
+    uint32_t count = x1 - x0;
+    for (uint32_t y = y0; y < y1; y++) {
+      switch (frame.level) {
+#ifdef AURA_SOFTWARE_AVX2
+      case SimdLevel::AVX2:
+        aura_software::shadeSpanAvx2(island, y, x0, count, red, green, blue,
+                                     alpha);
+        break;
+#endif
+#ifdef AURA_SOFTWARE_NEON
+      case SimdLevel::NEON:
+        aura_software::shadeSpan<Neon>(island, y, x0, count, red, green, blue,
+                                       alpha);
+        break;
+#endif
+      default:
+        aura_software::shadeSpan<Scalar>(island, y, x0, count, red, green,
+                                         blue, alpha);
+        break;
+      }
+      // Premultiplied, blended with ONE, ONE_MINUS_SRC_ALPHA
+      float *row = accum + ((y - tileY0) * TILE_SIZE + (x0 - tileX0)) * 4;
+      for (uint32_t k = 0; k < count; k++) {
+        float keep = 1.0f - alpha[k];
+        row[k * 4 + 0] = red[k] + row[k * 4 + 0] * keep;
+        row[k * 4 + 1] = green[k] + row[k * 4 + 1] * keep;
+        row[k * 4 + 2] = blue[k] + row[k * 4 + 2] * keep;
+        row[k * 4 + 3] = alpha[k] + row[k * 4 + 3] * keep;
+      }
+    }
+  }
+
+  for (uint32_t y = tileY0; y < tileY1; y++) {
+    const float *in = accum + (y - tileY0) * TILE_SIZE * 4;
+    uint8_t *out = frame.rgba + (size_t)y * frame.stride + tileX0 * 4;
+    for (uint32_t i = 0; i < tileWidth * 4; i++)
+      out[i] = toUnorm8(in[i]);
+  }
+}
+
+bool SoftwareLiquidRenderer::isSupported(SimdLevel value) {
+  switch (value) {
+  case SimdLevel::Scalar:
+    return true;
+#ifdef AURA_SOFTWARE_AVX2
+  case SimdLevel::AVX2:
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return true;
+#endif
+#endif
+#ifdef AURA_SOFTWARE_NEON
+  case SimdLevel::NEON:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+SoftwareLiquidRenderer::SimdLevel SoftwareLiquidRenderer::bestSimdLevel() {
+  static const SimdLevel best = [] {
+    const SimdLevel order[] = {SimdLevel::AVX2, SimdLevel::NEON};
+    for (SimdLevel value : order) {
+      if (isSupported(value))
+        return value;
+    }
+    return SimdLevel::Scalar;
+  }();
+  return best;
+}
+
+const char *SoftwareLiquidRenderer::simdLevelName(SimdLevel value) {
+  switch (value) {
+  case SimdLevel::AVX2:
+    return "AVX2";
+  case SimdLevel::NEON:
+    return "NEON";
+  default:
+    return "scalar";
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LiquidUniforms.hpp"
+
+/**
+ * @brief CPU reference renderer of the liquid islands.
+ *
+ * Produces the image liquid.frag draws, from the same LiquidFrameUniforms
+ * and LiquidIslandInstance data, without a Vulkan device: for image tests
+ * on GPU-less machines and as a fallback where the driver is broken. The
+ * frame is cut into TILE_SIZE tiles that a pool of threads pulls from a
+ * shared counter; each tile is blended in floats over opaque black, in
+ * island order, and converted to RGBA8 once.
+ *
+ * The shading kernel (SoftwareLiquidKernel.hpp) runs 8 pixels at a time
+ * with AVX2 or 4 with NEON, with polynomial sin/cos, or one at a time with
+ * libm as the scalar reference. render() picks the widest level the CPU
+ * supports; setSimdLevel() lets the benchmark force one. Pure CPU code,
+ * like SpringBatch.
+ */
+class SoftwareLiquidRenderer {
+public:
+  static constexpr uint32_t TILE_SIZE = 64;
+
+  enum class SimdLevel { Scalar, AVX2, NEON };
+
+  // threads = 0 uses every hardware thread. The thread calling render()
+  // shades tiles as well, so threads - 1 workers are started.
+  explicit SoftwareLiquidRenderer(uint32_t threads = 0);
+  ~SoftwareLiquidRenderer();
+  SoftwareLiquidRenderer(const SoftwareLiquidRenderer &) = delete;
+  SoftwareLiquidRenderer &operator=(const SoftwareLiquidRenderer &) = delete;
+
+  // Draws `islands` like the GPU's liquid pass at `quality` into `rgba`:
+  // width x height pixels of R, G, B, A bytes, rows `stride` bytes apart
+  // (0 = width * 4). Uses frame.timing.x and frame.fluidCurve; the liquid
+  // layer is always native scale. Blocks until the frame is complete.
+  void render(const LiquidFrameUniforms &frame,
+              const LiquidIslandInstance *islands, uint32_t islandCount,
+              const LiquidQualitySpec &quality, uint8_t *rgba, uint32_t width,
+              uint32_t height, uint32_t stride = 0);
+
+  void setSimdLevel(SimdLevel level);
+  SimdLevel simdLevel() const { return level; }
+  uint32_t threadCount() const { return (uint32_t)workers.size() + 1; }
+
+  static SimdLevel bestSimdLevel();
+  static bool isSupported(SimdLevel level);
+  static const char *simdLevelName(SimdLevel level);
+
+private:
+  struct Frame;
+  struct Scratch;
+
+  void workerLoop();
+  void renderTiles(const Frame &frame, Scratch &scratch);
+  void renderTile(const Frame &frame, uint32_t tile, Scratch &scratch);
+
+  SimdLevel level = bestSimdLevel();
+  std::vector<std::thread> workers;
+
+  // Job hand-off: render() publishes `current` and bumps `generation`;
+  // every worker drains tiles from nextTile and reports back once.
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable finished;
+  const Frame *current = nullptr;
+  uint64_t generation = 0;
+  uint32_t busyWorkers = 0;
+  bool stopping = false;
+  std::atomic<uint32_t> nextTile{0};
+};
@@ -0,0 +1,447 @@
+#include "SpringBatch.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+    defined(_M_IX86)
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AURA_SPRING_SSE2 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// Built without -mavx2; enabled per function and picked at runtime.
+#define AURA_SPRING_AVX2 1
+#define AURA_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define AURA_SPRING_AVX2 1
+#define AURA_TARGET_AVX2
+#endif
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define AURA_SPRING_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Lanes per SIMD step of the widest kernel; arrays are padded to this.
+constexpr uint32_t kPadding = 8;
+
+struct Channels {
+  float *x;
+  float *v;
+  const float *target;
+  const float *yy;
+  const float *yv;
+  const float *vy;
+  const float *vv;
+  const float *restY;
+  const float *restV;
+  uint8_t *settled; // one bit per channel, LSB first
+  uint32_t count;
+};
+
+// y = x - target;  x' = target + yy * y + yv * v;  v' = vy * y + vv * v
+// A channel is settled when |y'| <= restY and |v'| <= restV.
+void stepScalar(const Channels &c) {
+  for (uint32_t i = 0; i < c.count; i += 8) {
+    uint8_t bits = 0;
+    for (uint32_t j = i; j < i + 8; j++) {
+      float y = c.x[j] - c.target[j];
+      float v = c.v[j];
+      float ny = c.yy[j] * y + c.yv[j] * v;
+      float nv = c.vy[j] * y + c.vv[j] * v;
+      c.x[j] = c.target[j] + ny;
+      c.v[j] = nv;
+      if (std::fabs(ny) <= c.restY[j] && std::fabs(nv) <= c.restV[j])
+        bits |= (uint8_t)(1u << (j - i));
+    }
+    c.settled[i / 8] = bits;
+  }
+}
+
+#ifdef AURA_SPRING_SSE2
+void stepSse2(const Channels &c) {
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  for (uint32_t i = 0; i < c.count; i += 8) {
+    int bits = 0;
+    for (uint32_t half = 0; half < 8; half += 4) {
+      uint32_t j = i + half;
+      __m128 t = _mm_loadu_ps(c.target + j);
+      __m128 y = _mm_sub_ps(_mm_loadu_ps(c.x + j), t);
+      __m128 v = _mm_loadu_ps(c.v + j);
+      __m128 ny = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(c.yy + j), y),
+                             _mm_mul_ps(_mm_loadu_ps(c.yv + j), v));
+      __m128 nv = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(c.vy + j), y),
+                             _mm_mul_ps(_mm_loadu_ps(c.vv + j), v));
+      _mm_storeu_ps(c.x + j, _mm_add_ps(t, ny));
+      _mm_storeu_ps(c.v + j, nv);
+      __m128 rest = _mm_and_ps(
+          _mm_cmple_ps(_mm_and_ps(ny, absMask), _mm_loadu_ps(c.restY + j)),
+          _mm_cmple_ps(_mm_and_ps(nv, absMask), _mm_loadu_ps(c.restV + j)));
+      bits |= _mm_movemask_ps(rest) << half;
+    }
+    c.settled[i / 8] = (uint8_t)bits;
+  }
+}
+#endif
+
+#ifdef AURA_SPRING_AVX2
+AURA_TARGET_AVX2 void stepAvx2(const Channels &c) {
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  for (uint32_t i = 0; i < c.count; i += 8) {
+    __m256 t = _mm256_loadu_ps(c.target + i);
+    __m256 y = _mm256_sub_ps(_mm256_loadu_ps(c.x + i), t);
+    __m256 v = _mm256_loadu_ps(c.v + i);
+    __m256 ny = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(c.yy + i), y),
+                              _mm256_mul_ps(_mm256_loadu_ps(c.yv + i), v));
+    __m256 nv = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(c.vy + i), y),
+                              _mm256_mul_ps(_mm256_loadu_ps(c.vv + i), v));
+    _mm256_storeu_ps(c.x + i, _mm256_add_ps(t, ny));
+    _mm256_storeu_ps(c.v + i, nv);
+    __m256 rest = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_and_ps(ny, absMask), _mm256_loadu_ps(c.restY + i),
+                      _CMP_LE_OQ),
+        _mm256_cmp_ps(_mm256_and_ps(nv, absMask), _mm256_loadu_ps(c.restV + i),
+                      _CMP_LE_OQ));
+    c.settled[i / 8] = (uint8_t)_mm256_movemask_ps(rest);
+  }
+}
+#endif
+
+#ifdef AURA_SPRING_NEON
+void stepNeon(const Channels &c) {
+  // Lane weights turn a 4-lane compare mask into 4 bits
+  const uint32_t weights[4] = {1, 2, 4, 8};
+  const uint32x4_t laneBits = vld1q_u32(weights);
+  for (uint32_t i = 0; i < c.count; i += 8) {
+    uint32_t bits = 0;
+    for (uint32_t half = 0; half < 8; half += 4) {
+      uint32_t j = i + half;
+      float32x4_t t = vld1q_f32(c.target + j);
+      float32x4_t y = vsubq_f32(vld1q_f32(c.x + j), t);
+      float32x4_t v = vld1q_f32(c.v + j);
+      float32x4_t ny = vaddq_f32(vmulq_f32(vld1q_f32(c.yy + j), y),
+                                 vmulq_f32(vld1q_f32(c.yv + j), v));
+      float32x4_t nv = vaddq_f32(vmulq_f32(vld1q_f32(c.vy + j), y),
+                                 vmulq_f32(vld1q_f32(c.vv + j), v));
+      vst1q_f32(c.x + j, vaddq_f32(t, ny));
+      vst1q_f32(c.v + j, nv);
+      uint32x4_t rest = vandq_u32(vcleq_f32(vabsq_f32(ny), vld1q_f32(c.restY + j)),
+                                  vcleq_f32(vabsq_f32(nv), vld1q_f32(c.restV + j)));
+      uint32x4_t masked = vandq_u32(rest, laneBits);
+      uint32x2_t pair = vadd_u32(vget_low_u32(masked), vget_high_u32(masked));
+      bits |= (vget_lane_u32(pair, 0) + vget_lane_u32(pair, 1)) << half;
+    }
+    c.settled[i / 8] = (uint8_t)bits;
+  }
+}
+#endif
+
+struct StepMatrix {
+  double yy, yv, vy, vv;
+};
+
+// Explicit Euler written as a linear map:
+//   v' = v + (-k * y - d * v) * dt;  y' = y + v' * dt
+StepMatrix eulerStep(double k, double d, double dt) {
+  double vy = -k * dt;
+  double vv = 1.0 - d * dt;
+  return {1.0 + vy * dt, vv * dt, vy, vv};
+}
+
+// Exact solution of y'' = -k * y - d * v after dt seconds.
+StepMatrix analyticStep(double k, double d, double dt) {
+  if (k <= 0.0) {
+    // No spring: pure exponential drag (or free motion without damping).
+    if (d <= 0.0)
+      return {1.0, dt, 0.0, 1.0};
+    double e = std::exp(-d * dt);
+    return {1.0, (1.0 - e) / d, 0.0, e};
+  }
+  double omega = std::sqrt(k);
+  double alpha = 0.5 * d; // zeta * omega
+  double disc = alpha * alpha - k;
+  const double kCritical = 1e-6 * k;
+  if (disc < -kCritical) {
+    // Under-damped: decaying oscillation at omegaD
+    double omegaD = std::sqrt(-disc);
+    double e = std::exp(-alpha * dt);
+    double c = std::cos(omegaD * dt);
+    double sn = std::sin(omegaD * dt) / omegaD;
+    return {e * (c + alpha * sn), e * sn, -e * k * sn, e * (c - alpha * sn)};
+  }
+  if (disc > kCritical) {
+    // Over-damped: two real decay rates. cosh/sinh are formed from the two
+    // exponentials so large alpha * dt cannot overflow.
+    double beta = std::sqrt(disc);
+    double e1 = std::exp((-alpha + beta) * dt);
+    double e2 = std::exp((-alpha - beta) * dt);
+    double ch = 0.5 * (e1 + e2);
+    double sh = 0.5 * (e1 - e2) / beta;
+    return {ch + alpha * sh, sh, -k * sh, ch - alpha * sh};
+  }
+  // Critically damped
+  double e = std::exp(-omega * dt);
+  return {e * (1.0 + omega * dt), e * dt, -e * k * dt, e * (1.0 - omega * dt)};
+}
+
+} // namespace
+
+uint32_t SpringBatch::addIsland(const IslandState &initial, float k, float d) {
+  uint32_t island = islands++;
+  uint32_t needed = islands * CHANNELS_PER_ISLAND;
+  if (needed > paddedCount()) {
+    uint32_t padded = (needed + kPadding - 1) / kPadding * kPadding;
+    position.resize(padded, 0.0f);
+    velocity.resize(padded, 0.0f);
+    target.resize(padded, 0.0f);
+    stiffness.resize(padded, 0.0f);
+    damping.resize(padded, 0.0f);
+    coeffYY.resize(padded, 1.0f);
+    coeffYV.resize(padded, 0.0f);
+    coeffVY.resize(padded, 0.0f);
+    coeffVV.resize(padded, 1.0f);
+    restPositionEpsilon.resize(padded, 0.0f);
+    restVelocityEpsilon.resize(padded, 0.0f);
+    // One spare byte so the 5-bit island window can always read 16 bits
+    settledBits.resize(padded / 8 + 1, 0);
+  }
+  resting.push_back(1);
+  restingCount++;
+  coeffDirty = true;
+  uint32_t base = island * CHANNELS_PER_ISLAND;
+  std::memcpy(&position[base], &initial, sizeof(IslandState));
+  std::memcpy(&target[base], &initial, sizeof(IslandState));
+  for (uint32_t c = 0; c < CHANNELS_PER_ISLAND; c++) {
+    velocity[base + c] = 0.0f;
+    stiffness[base + c] = k;
+    damping[base + c] = d;
+    restPositionEpsilon[base + c] = defaultPositionEpsilon;
+    restVelocityEpsilon[base + c] = defaultVelocityEpsilon;
+  }
+  return island;
+}
+
+void SpringBatch::clear() {
+  islands = 0;
+  position.clear();
+  velocity.clear();
+  target.clear();
+  stiffness.clear();
+  damping.clear();
+  coeffYY.clear();
+  coeffYV.clear();
+  coeffVY.clear();
+  coeffVV.clear();
+  restPositionEpsilon.clear();
+  restVelocityEpsilon.clear();
+  settledBits.clear();
+  resting.clear();
+  restingCount = 0;
+  coeffDirty = true;
+}
+
+void SpringBatch::setTarget(uint32_t island, const IslandState &t) {
+  float *dst = &target[island * CHANNELS_PER_ISLAND];
+  if (std::memcmp(dst, &t, sizeof(IslandState)) == 0)
+    return;
+  std::memcpy(dst, &t, sizeof(IslandState));
+  if (resting[island]) {
+    resting[island] = 0;
+    restingCount--;
+  }
+}
+
+void SpringBatch::setChannelParams(uint32_t channel, float k, float d) {
+  stiffness[channel] = k;
+  damping[channel] = d;
+  coeffDirty = true;
+}
+
+void SpringBatch::setDefaultRestEpsilon(float positionEpsilon,
+                                        float velocityEpsilon) {
+  defaultPositionEpsilon = positionEpsilon;
+  defaultVelocityEpsilon = velocityEpsilon;
+}
+
+void SpringBatch::setRestEpsilon(uint32_t island, float positionEpsilon,
+                                 float velocityEpsilon) {
+  uint32_t base = island * CHANNELS_PER_ISLAND;
+  for (uint32_t c = base; c < base + CHANNELS_PER_ISLAND; c++) {
+    restPositionEpsilon[c] = positionEpsilon;
+    restVelocityEpsilon[c] = velocityEpsilon;
+  }
+}
+
+void SpringBatch::setIntegrator(Integrator value) {
+  if (mode != value)
+    coeffDirty = true;
+  mode = value;
+}
+
+void SpringBatch::updateCoefficients(float dt) {
+  if (!coeffDirty && dt == coeffDt)
+    return;
+  if (coeffDirty) {
+    // Islands share a few tunings, so the search is short; consecutive
+    // channels usually repeat the previous pair
+    springParams.clear();
+    channelParams.resize(channelCount());
+    uint32_t last = 0;
+    for (uint32_t i = 0; i < channelCount(); i++) {
+      float k = stiffness[i], d = damping[i];
+      auto same = [&](uint32_t p) {
+        return springParams[p].stiffness == k && springParams[p].damping == d;
+      };
+      if (springParams.empty() || !same(last)) {
+        last = 0;
+        while (last < springParams.size() && !same(last))
+          last++;
+        if (last == springParams.size())
+          springParams.push_back({k, d});
+      }
+      channelParams[i] = last;
+    }
+    paramCoeffs.resize(springParams.size() * 4);
+  }
+  // dt changes every frame: one exp/sin/cos per pair, then a plain copy
+  for (size_t p = 0; p < springParams.size(); p++) {
+    const SpringParams &s = springParams[p];
+    StepMatrix m = mode == Integrator::Analytic
+                       ? analyticStep(s.stiffness, s.damping, dt)
+                       : eulerStep(s.stiffness, s.damping, dt);
+    paramCoeffs[p * 4 + 0] = (float)m.yy;
+    paramCoeffs[p * 4 + 1] = (float)m.yv;
+    paramCoeffs[p * 4 + 2] = (float)m.vy;
+    paramCoeffs[p * 4 + 3] = (float)m.vv;
+  }
+  for (uint32_t i = 0; i < channelCount(); i++) {
+    const float *m = &paramCoeffs[channelParams[i] * 4];
+    coeffYY[i] = m[0];
+    coeffYV[i] = m[1];
+    coeffVY[i] = m[2];
+    coeffVV[i] = m[3];
+  }
+  coeffDt = dt;
+  coeffDirty = false;
+}
+
+void SpringBatch::updateRestState() {
+  for (uint32_t island = 0; island < islands; island++) {
+    if (resting[island])
+      continue;
+    uint32_t bit = island * CHANNELS_PER_ISLAND;
+    uint32_t window = settledBits[bit / 8] | (settledBits[bit / 8 + 1] << 8);
+    if (((window >> (bit % 8)) & 0x1f) != 0x1f)
+      continue;
+    // Snap, so a resting island is bit-exact and stays put
+    for (uint32_t c = bit; c < bit + CHANNELS_PER_ISLAND; c++) {
+      position[c] = target[c];
+      velocity[c] = 0.0f;
+    }
+    resting[island] = 1;
+    restingCount++;
+  }
+}
+
+IslandState SpringBatch::state(uint32_t island) const {
+  IslandState s;
+  std::memcpy(&s, &position[island * CHANNELS_PER_ISLAND], sizeof(IslandState));
+  return s;
+}
+
+void SpringBatch::step(float dt) { stepWith(bestSimdLevel(), dt); }
+
+void SpringBatch::stepWith(SimdLevel level, float dt) {
+  if (islands == 0 || allAtRest() || dt <= 0.0f)
+    return;
+  updateCoefficients(dt);
+  Channels c = {position.data(),
+                velocity.data(),
+                target.data(),
+                coeffYY.data(),
+                coeffYV.data(),
+                coeffVY.data(),
+                coeffVV.data(),
+                restPositionEpsilon.data(),
+                restVelocityEpsilon.data(),
+                settledBits.data(),
+                paddedCount()};
+  switch (isSupported(level) ? level : SimdLevel::Scalar) {
+#ifdef AURA_SPRING_AVX2
+  case SimdLevel::AVX2:
+    stepAvx2(c);
+    break;
+#endif
+#ifdef AURA_SPRING_SSE2
+  case SimdLevel::SSE2:
+    stepSse2(c);
+    break;
+#endif
+#ifdef AURA_SPRING_NEON
+  case SimdLevel::NEON:
+    stepNeon(c);
+    break;
+#endif
+  default:
+    stepScalar(c);
+    break;
+  }
+  updateRestState();
+}
+
+bool SpringBatch::isSupported(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::Scalar:
+    return true;
+#ifdef AURA_SPRING_SSE2
+  case SimdLevel::SSE2:
+    return true;
+#endif
+#ifdef AURA_SPRING_AVX2
+  case SimdLevel::AVX2:
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return true;
+#endif
+#endif
+#ifdef AURA_SPRING_NEON
+  case SimdLevel::NEON:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+SpringBatch::SimdLevel SpringBatch::bestSimdLevel() {
+  static const SimdLevel best = [] {
+    const SimdLevel order[] = {SimdLevel::AVX2, SimdLevel::NEON,
+                               SimdLevel::SSE2};
+    for (SimdLevel level : order) {
+      if (isSupported(level))
+        return level;
+    }
+    return SimdLevel::Scalar;
+  }();
+  return best;
+}
+
+const char *SpringBatch::simdLevelName(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::SSE2:
+    return "SSE2";
+  case SimdLevel::AVX2:
+    return "AVX2";
+  case SimdLevel::NEON:
+    return "NEON";
+  case SimdLevel::Scalar:
+  default:
+    return "scalar";
+  }
+}
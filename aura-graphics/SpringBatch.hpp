@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "IslandState.hpp"
+
+/**
+ * @brief Structure-of-arrays spring solver for many animated islands.
+ *
+ * Every IslandState field is one spring channel; island i owns channels
+ * [i * 5, i * 5 + 5). Position, velocity, target, stiffness and damping each
+ * live in their own array, padded to a multiple of 8 channels so the SIMD
+ * kernels (SSE2/AVX2 on x86, NEON on ARM) never need a scalar tail. Padding
+ * channels have zero stiffness and damping and never move.
+ *
+ * A step of either integrator is a linear map of (x - target, v), so the
+ * kernels only apply four per-channel coefficients. For the analytic
+ * integrator these come from the exact under-, critically or over-damped
+ * solution. Frame dt comes from the clock and changes every frame, so the
+ * solution is evaluated once per distinct (stiffness, damping) pair, not
+ * per channel, and copied to the channels that share it.
+ *
+ * step() picks the widest kernel the CPU supports at runtime; stepWith() lets
+ * the benchmark force one.
+ */
+class SpringBatch {
+public:
+  static constexpr uint32_t CHANNELS_PER_ISLAND = 5;
+
+  enum class SimdLevel { Scalar, SSE2, AVX2, NEON };
+  enum class Integrator {
+    // Exact damped-oscillator solution; stable for any dt.
+    Analytic,
+    // The original explicit Euler step, kept for comparison.
+    Euler,
+  };
+
+  // Returns the island index.
+  uint32_t addIsland(const IslandState &initial, float stiffness = 150.0f,
+                     float damping = 20.0f);
+  void clear();
+
+  void setTarget(uint32_t island, const IslandState &target);
+  // Per-channel tuning, e.g. a softer spring on cornerRadius.
+  void setChannelParams(uint32_t channel, float stiffness, float damping);
+  IslandState state(uint32_t island) const;
+
+  // An island is at rest once every channel is within positionEpsilon of its
+  // target and slower than velocityEpsilon (per second); it is then snapped
+  // exactly onto the target. Defaults apply to islands added afterwards.
+  void setDefaultRestEpsilon(float positionEpsilon, float velocityEpsilon);
+  void setRestEpsilon(uint32_t island, float positionEpsilon,
+                      float velocityEpsilon);
+  bool atRest(uint32_t island) const { return resting[island] != 0; }
+  bool allAtRest() const { return restingCount == islands; }
+  uint32_t restingIslands() const { return restingCount; }
+
+  void setIntegrator(Integrator value);
+  Integrator integrator() const { return mode; }
+
+  void step(float dt);
+  void stepWith(SimdLevel level, float dt);
+
+  uint32_t islandCount() const { return islands; }
+  uint32_t channelCount() const { return islands * CHANNELS_PER_ISLAND; }
+
+  static SimdLevel bestSimdLevel();
+  static bool isSupported(SimdLevel level);
+  static const char *simdLevelName(SimdLevel level);
+
+private:
+  uint32_t islands = 0;
+  Integrator mode = Integrator::Analytic;
+  // Channel arrays, all the same padded length.
+  std::vector<float> position;
+  std::vector<float> velocity;
+  std::vector<float> target;
+  std::vector<float> stiffness;
+  std::vector<float> damping;
+  // Step coefficients: x' - target = yy * (x - target) + yv * v,
+  //                    v'          = vy * (x - target) + vv * v
+  std::vector<float> coeffYY, coeffYV, coeffVY, coeffVV;
+  float coeffDt = -1.0f;
+  // Set when a spring parameter or the integrator changes
+  bool coeffDirty = true;
+  // Distinct (stiffness, damping) pairs, each channel's index into them, and
+  // the pairs' coefficients for coeffDt (yy, yv, vy, vv per pair)
+  struct SpringParams {
+    float stiffness, damping;
+  };
+  std::vector<SpringParams> springParams;
+  std::vector<uint32_t> channelParams;
+  std::vector<float> paramCoeffs;
+
+  // Rest thresholds per channel (set per island); the kernels write one
+  // "settled" bit per channel so the per-island test is a 5-bit mask check.
+  std::vector<float> restPositionEpsilon;
+  std::vector<float> restVelocityEpsilon;
+  std::vector<uint8_t> settledBits;
+  std::vector<uint8_t> resting;
+  uint32_t restingCount = 0;
+  float defaultPositionEpsilon = 0.01f;
+  float defaultVelocityEpsilon = 0.05f;
+
+  uint32_t paddedCount() const { return (uint32_t)position.size(); }
+  void updateCoefficients(float dt);
+  void updateRestState();
+};
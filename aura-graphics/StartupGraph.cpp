@@ -0,0 +1,94 @@
+#include "StartupGraph.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+StartupGraph::TaskId StartupGraph::add(std::string name,
+                                       std::function<void()> work,
+                                       std::initializer_list<TaskId> after) {
+  TaskId id = (TaskId)tasks.size();
+  Task task;
+  task.work = std::move(work);
+  task.waitingOn = (uint32_t)after.size();
+  tasks.push_back(std::move(task));
+  for (TaskId dependency : after)
+    tasks[dependency].dependents.push_back(id);
+  TaskTiming entry;
+  entry.name = std::move(name);
+  timing.push_back(std::move(entry));
+  return id;
+}
+
+void StartupGraph::run(uint32_t threads) {
+  using Clock = std::chrono::steady_clock;
+  auto toMs = [](Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+  };
+  auto start = Clock::now();
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  // Ready tasks in the order they were added, so earlier (usually longer)
+  // chains start first
+  std::deque<TaskId> ready;
+  for (TaskId id = 0; id < tasks.size(); id++)
+    if (tasks[id].waitingOn == 0)
+      ready.push_back(id);
+  size_t remaining = tasks.size();
+  std::exception_ptr error;
+
+  auto worker = [&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      changed.wait(lock, [&] { return !ready.empty() || remaining == 0; });
+      if (ready.empty())
+        return;
+      TaskId id = ready.front();
+      ready.pop_front();
+      // After a failure the rest of the graph drains without running
+      bool skip = error != nullptr;
+      lock.unlock();
+
+      auto taskStart = Clock::now();
+      std::exception_ptr failure;
+      if (!skip) {
+        try {
+          tasks[id].work();
+        } catch (...) {
+          failure = std::current_exception();
+        }
+      }
+      auto taskEnd = Clock::now();
+
+      lock.lock();
+      timing[id].startMs = toMs(taskStart - start);
+      timing[id].endMs = toMs(taskEnd - start);
+      if (failure && !error)
+        error = failure;
+      remaining--;
+      for (TaskId dependent : tasks[id].dependents)
+        if (--tasks[dependent].waitingOn == 0)
+          ready.push_back(dependent);
+      changed.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (uint32_t i = 1; i < threads && i < tasks.size(); i++)
+    workers.emplace_back(worker);
+  worker();
+  for (auto &thread : workers)
+    thread.join();
+  wall = toMs(Clock::now() - start);
+  if (error)
+    std::rethrow_exception(error);
+}
+
+double StartupGraph::workMs() const {
+  double total = 0.0;
+  for (const auto &entry : timing)
+    total += entry.endMs - entry.startMs;
+  return total;
+}
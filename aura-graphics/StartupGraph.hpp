@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Runs startup steps as a dependency graph on a few threads.
+ *
+ * Each task names the tasks it must run after; run() starts every task
+ * whose dependencies have finished on the calling thread or one of up to
+ * threads - 1 workers, so independent steps (kernel init next to device
+ * creation, pipeline cache loading next to swapchain setup) overlap. Tasks
+ * must only touch state their dependencies produced. If a task throws, the
+ * tasks after it are skipped, the ones already running finish, and run()
+ * rethrows the first exception. Plain C++ so the desktop app and the
+ * Android renderer can share it.
+ */
+class StartupGraph {
+public:
+  using TaskId = uint32_t;
+
+  struct TaskTiming {
+    std::string name;
+    // Milliseconds from the start of run()
+    double startMs = 0.0;
+    double endMs = 0.0;
+  };
+
+  // Dependencies must have been added before.
+  TaskId add(std::string name, std::function<void()> work,
+             std::initializer_list<TaskId> after = {});
+  void run(uint32_t threads);
+
+  // After run(): per-task timings in the order added, wall time of run()
+  // and the summed time of every task.
+  const std::vector<TaskTiming> &timings() const { return timing; }
+  double wallMs() const { return wall; }
+  double workMs() const;
+
+private:
+  struct Task {
+    std::function<void()> work;
+    std::vector<TaskId> dependents;
+    uint32_t waitingOn = 0;
+  };
+
+  std::vector<Task> tasks;
+  std::vector<TaskTiming> timing;
+  double wall = 0.0;
+};
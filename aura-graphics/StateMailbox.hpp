@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock-free single-producer/single-consumer mailbox; the latest value
+ * wins.
+ *
+ * A triple buffer: the producer fills its own slot and swaps it with the
+ * shared middle slot, the consumer swaps its slot with the middle one only
+ * when something new arrived. Neither side ever waits for the other, so a UI
+ * or JNI thread posting island targets can never be held up by a render
+ * thread blocked on the GPU, and values the consumer had no time for are
+ * simply overwritten. Exactly one thread may publish() and one thread may
+ * take(); T must be trivially copyable.
+ */
+template <typename T> class StateMailbox {
+public:
+  // Producer side.
+  void publish(const T &value) {
+    slots[back].value = value;
+    uint32_t previous =
+        middle.exchange(back | FRESH, std::memory_order_acq_rel);
+    back = previous & INDEX;
+    if (previous & FRESH)
+      superseded.fetch_add(1, std::memory_order_relaxed);
+    published.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Consumer side: the newest value published since the last take(), if any.
+  bool take(T &value) {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH))
+      return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+    value = slots[front].value;
+    return true;
+  }
+
+  // Values published, and those overwritten before the consumer saw them.
+  uint64_t publishedCount() const {
+    return published.load(std::memory_order_relaxed);
+  }
+  uint64_t supersededCount() const {
+    return superseded.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr uint32_t INDEX = 3;
+  static constexpr uint32_t FRESH = 4;
+
+  // Slots and indices on separate cache lines so the two threads do not
+  // false-share.
+  struct alignas(64) Slot {
+    T value{};
+  };
+  Slot slots[3];
+  alignas(64) std::atomic<uint32_t> middle{1};
+  alignas(64) uint32_t back = 0; // producer only
+  std::atomic<uint64_t> published{0};
+  std::atomic<uint64_t> superseded{0};
+  alignas(64) uint32_t front = 2; // consumer only
+};
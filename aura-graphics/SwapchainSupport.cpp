@@ -0,0 +1,124 @@
+#include "SwapchainSupport.hpp"
+
+#include <algorithm>
+
+static VkSurfaceFormatKHR
+chooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &formats,
+                    VkFormat preferredFormat) {
+  const VkFormat wanted[] = {preferredFormat, VK_FORMAT_B8G8R8A8_UNORM,
+                             VK_FORMAT_R8G8B8A8_UNORM};
+  for (VkFormat format : wanted) {
+    for (const auto &f : formats) {
+      if (f.format == format &&
+          f.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+        return f;
+    }
+  }
+  return formats[0];
+}
+
+VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR> &modes,
+                                   PresentPreference preference) {
+  std::vector<VkPresentModeKHR> order;
+  switch (preference) {
+  case PresentPreference::LowLatency:
+    order = {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR,
+             VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+    break;
+  case PresentPreference::Balanced:
+    order = {VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+    break;
+  case PresentPreference::PowerSaving:
+    break;
+  }
+  for (VkPresentModeKHR mode : order) {
+    if (std::find(modes.begin(), modes.end(), mode) != modes.end())
+      return mode;
+  }
+  return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+const char *presentModeName(VkPresentModeKHR mode) {
+  switch (mode) {
+  case VK_PRESENT_MODE_MAILBOX_KHR:
+    return "MAILBOX";
+  case VK_PRESENT_MODE_IMMEDIATE_KHR:
+    return "IMMEDIATE";
+  case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+    return "FIFO_RELAXED";
+  case VK_PRESENT_MODE_FIFO_KHR:
+    return "FIFO";
+  default:
+    return "OTHER";
+  }
+}
+
+bool querySwapchainSettings(VkPhysicalDevice physicalDevice,
+                            VkSurfaceKHR surface, PresentPreference preference,
+                            VkExtent2D fallbackExtent, VkFormat preferredFormat,
+                            SwapchainSettings &settings) {
+  VkSurfaceCapabilitiesKHR caps;
+  if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface,
+                                                &caps) != VK_SUCCESS)
+    return false;
+
+  uint32_t count = 0;
+  vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &count,
+                                       nullptr);
+  std::vector<VkSurfaceFormatKHR> formats(count);
+  vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &count,
+                                       formats.data());
+  vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &count,
+                                            nullptr);
+  std::vector<VkPresentModeKHR> modes(count);
+  vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &count,
+                                            modes.data());
+  if (formats.empty())
+    return false;
+
+  settings.format = chooseSurfaceFormat(formats, preferredFormat);
+  settings.presentMode = choosePresentMode(modes, preference);
+
+  if (caps.currentExtent.width != UINT32_MAX) {
+    settings.extent = caps.currentExtent;
+  } else {
+    settings.extent.width =
+        std::clamp(fallbackExtent.width, caps.minImageExtent.width,
+                   caps.maxImageExtent.width);
+    settings.extent.height =
+        std::clamp(fallbackExtent.height, caps.minImageExtent.height,
+                   caps.maxImageExtent.height);
+  }
+
+  // One image more than the minimum lets the CPU acquire the next image
+  // while the compositor still holds one; FIFO power saving stays lean.
+  uint32_t imageCount = caps.minImageCount;
+  if (settings.presentMode != VK_PRESENT_MODE_FIFO_KHR ||
+      preference != PresentPreference::PowerSaving)
+    imageCount++;
+  if (settings.presentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+    imageCount = std::max(imageCount, 3u);
+  if (caps.maxImageCount > 0)
+    imageCount = std::min(imageCount, caps.maxImageCount);
+  settings.imageCount = imageCount;
+
+  // Identity when allowed so the shaders' pixel coordinates stay upright;
+  // otherwise accept what the compositor asks for.
+  settings.preTransform =
+      (caps.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
+          ? VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR
+          : caps.currentTransform;
+
+  const VkCompositeAlphaFlagBitsKHR alphaModes[] = {
+      VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR, VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR,
+      VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR,
+      VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR};
+  settings.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+  for (VkCompositeAlphaFlagBitsKHR mode : alphaModes) {
+    if (caps.supportedCompositeAlpha & mode) {
+      settings.compositeAlpha = mode;
+      break;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+/**
+ * @brief What the present mode should optimise for.
+ *
+ * LowLatency prefers MAILBOX (tear-free, newest frame wins) and falls back to
+ * IMMEDIATE; Balanced prefers FIFO_RELAXED so a late frame tears instead of
+ * waiting a whole vblank; PowerSaving is plain FIFO. FIFO is always the last
+ * resort because it is the only mode every driver must support.
+ */
+enum class PresentPreference { LowLatency, Balanced, PowerSaving };
+
+/**
+ * @brief Swapchain parameters derived from the surface's current capabilities.
+ *
+ * An extent of 0x0 means the surface is minimised; callers skip presenting
+ * until it grows again. Shared by the desktop app and the Android renderer.
+ */
+struct SwapchainSettings {
+  VkSurfaceFormatKHR format;
+  VkPresentModeKHR presentMode;
+  VkExtent2D extent;
+  uint32_t imageCount;
+  VkSurfaceTransformFlagBitsKHR preTransform;
+  VkCompositeAlphaFlagBitsKHR compositeAlpha;
+};
+
+// fallbackExtent is used when the surface lets the swapchain pick its size
+// (currentExtent == 0xFFFFFFFF, e.g. Wayland); preferredFormat keeps the
+// format stable across recreation so render passes and pipelines stay valid.
+bool querySwapchainSettings(VkPhysicalDevice physicalDevice,
+                            VkSurfaceKHR surface, PresentPreference preference,
+                            VkExtent2D fallbackExtent, VkFormat preferredFormat,
+                            SwapchainSettings &settings);
+
+VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR> &modes,
+                                   PresentPreference preference);
+const char *presentModeName(VkPresentModeKHR mode);
@@ -0,0 +1,70 @@
+#include "UniformRing.hpp"
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return alignment > 1 ? (value + alignment - 1) & ~(alignment - 1) : value;
+}
+
+bool UniformRing::init(DeviceMemoryAllocator &alloc, VkDeviceSize elementSize,
+                       uint32_t slotCount, VkBufferUsageFlags usage) {
+  allocator = &alloc;
+  size = elementSize;
+  slots = slotCount;
+  baseOffset = 0;
+
+  const VkPhysicalDeviceLimits &limits = alloc.limits();
+  // Stride honours both the dynamic-offset alignment and, in case the memory
+  // turns out non-coherent, the flush granularity.
+  VkDeviceSize alignment = limits.minUniformBufferOffsetAlignment;
+  if ((usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) &&
+      limits.minStorageBufferOffsetAlignment > alignment)
+    alignment = limits.minStorageBufferOffsetAlignment;
+  if (limits.nonCoherentAtomSize > alignment)
+    alignment = limits.nonCoherentAtomSize;
+  slotStride = alignUp(elementSize, alignment);
+  flushSize = slotStride;
+
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = slotStride * slotCount;
+  bufferInfo.usage = usage;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  if (!alloc.createBuffer(bufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, ringBuffer,
+                          memory))
+    return false;
+  mapped = static_cast<uint8_t *>(memory.mapped);
+  return mapped != nullptr;
+}
+
+bool UniformRing::init(FrameUploadArena &frameArena,
+                       VkDeviceSize elementSize) {
+  size = elementSize;
+  if (!frameArena.reserve(elementSize, baseOffset))
+    return false;
+  arena = &frameArena;
+  ringBuffer = frameArena.buffer();
+  mapped = static_cast<uint8_t *>(frameArena.mapped(0));
+  slotStride = frameArena.capacity();
+  flushSize = elementSize;
+  slots = frameArena.slotCount();
+  return true;
+}
+
+void UniformRing::destroy() {
+  if (allocator && ringBuffer != VK_NULL_HANDLE)
+    allocator->destroyBuffer(ringBuffer, memory);
+  ringBuffer = VK_NULL_HANDLE;
+  mapped = nullptr;
+  allocator = nullptr;
+  arena = nullptr;
+}
+
+void *UniformRing::slot(uint32_t index) const {
+  return mapped + dynamicOffset(index);
+}
+
+void UniformRing::flush(uint32_t index) const {
+  if (arena)
+    arena->flush(dynamicOffset(index), flushSize);
+  else
+    allocator->flush(memory, dynamicOffset(index), flushSize);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "DeviceMemoryAllocator.hpp"
+#include "FrameUploadArena.hpp"
+
+/**
+ * @brief Persistently mapped uniform buffer with one slot per frame in flight.
+ *
+ * The buffer is mapped once at init and stays mapped; the CPU writes a slot
+ * after that slot's frame fence has signaled and binds it with a dynamic
+ * offset, so per-frame data never needs a command buffer re-record.
+ * Written against the C API so the desktop app and the Android renderer can
+ * both use it. Other usages (storage, indirect) can be requested for rings
+ * that hold more than uniforms, e.g. IslandInstanceRing. The memory comes
+ * from a DeviceMemoryAllocator block shared with the other rings, or from a
+ * reservation in each slot of a FrameUploadArena, whose buffer then needs
+ * the ring's usage.
+ */
+class UniformRing {
+public:
+  bool init(DeviceMemoryAllocator &allocator, VkDeviceSize elementSize,
+            uint32_t slotCount,
+            VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+  // One slot per arena slot, so slot i is rewritten once frame slot i has
+  // retired. The arena owns the memory and outlives the ring.
+  bool init(FrameUploadArena &arena, VkDeviceSize elementSize);
+  void destroy();
+
+  void *slot(uint32_t index) const;
+  template <typename T> T *at(uint32_t index) const {
+    return static_cast<T *>(slot(index));
+  }
+  // Makes CPU writes to a slot visible; a no-op on coherent memory.
+  void flush(uint32_t index) const;
+
+  uint32_t dynamicOffset(uint32_t index) const {
+    return static_cast<uint32_t>(baseOffset + index * slotStride);
+  }
+  VkBuffer buffer() const { return ringBuffer; }
+  VkDeviceSize elementSize() const { return size; }
+  uint32_t slotCount() const { return slots; }
+
+private:
+  // Exactly one is set: the ring's own buffer, or the arena it lives in
+  DeviceMemoryAllocator *allocator = nullptr;
+  FrameUploadArena *arena = nullptr;
+  VkBuffer ringBuffer = VK_NULL_HANDLE;
+  DeviceAllocation memory;
+  // Start of the buffer; slot i is at baseOffset + i * slotStride
+  uint8_t *mapped = nullptr;
+  VkDeviceSize size = 0;
+  VkDeviceSize baseOffset = 0;
+  VkDeviceSize slotStride = 0;
+  // Bytes flush() covers per slot
+  VkDeviceSize flushSize = 0;
+  uint32_t slots = 0;
+};
@@ -5,8 +5,20 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
+// Coefficients of the fluid-intensity curve (same layout as the Rust struct):
+//   ripple(t) = sin(t * ripple_frequency) * ripple_amplitude
+//   f(t)      = t + ripple(t) + cos(t * wave_frequency + ripple(t)) *
+//               wave_amplitude
+typedef struct AuraFluidCurve {
+  float ripple_frequency;
+  float ripple_amplitude;
+  float wave_frequency;
+  float wave_amplitude;
+} AuraFluidCurve;
+
 // Initialize Aura Privacy Shield from Rust
 int32_t aura_kernel_init();
 
@@ -19,6 +31,72 @@ void aura_kernel_free_string(char *s);
 // Calculate fluid intensity using Kernel logic
 float aura_kernel_calculate_fluid_intensity(float time);
 
+// out[i] = fluid intensity at times[i] for count values in one call; out may
+// alias times. Null pointers or count == 0 do nothing.
+void aura_kernel_calculate_fluid_intensity_batch(const float *times,
+                                                 float *out, size_t count);
+
+// Copies the curve's coefficients so it can be evaluated in a shader.
+// Returns 1 on success, 0 if out is null.
+int32_t aura_kernel_get_fluid_curve(AuraFluidCurve *out);
+
+// --- Kernel <-> renderer channel ---------------------------------------
+// An opaque handle to two lock-free single-producer/single-consumer rings
+// that live inside the kernel: events flow kernel -> renderer, telemetry
+// renderer -> kernel. Each message crosses one FFI call (poll_event,
+// push_telemetry) that copies one 32-byte message and does one atomic
+// store; it never locks, allocates or waits. A kernel thread owns the other
+// end of both rings and publishes every change of the kernel's state.
+
+#define AURA_EVENT_POWER_MODE 1    // value = power mode, factor = multiplier
+#define AURA_EVENT_PRIVACY_LEVEL 2 // value = privacy level
+#define AURA_EVENT_MEMORY_USAGE 3  // data = {allocated bytes, capacity}
+
+#define AURA_POWER_PERFORMANCE 0
+#define AURA_POWER_BALANCED 1
+#define AURA_POWER_EFFICIENT 2
+
+typedef struct AuraKernelEvent {
+  uint32_t kind;
+  uint32_t value;
+  float factor;
+  uint32_t reserved;
+  uint64_t data[2];
+} AuraKernelEvent;
+
+typedef struct AuraFrameTelemetry {
+  uint64_t frame_number;
+  float cpu_frame_ms;
+  float gpu_frame_ms;
+  float present_ms;
+  uint32_t island_count;
+  uint32_t reserved[2];
+} AuraFrameTelemetry;
+
+// Opaque; only the functions below touch it.
+typedef struct AuraKernelChannel AuraKernelChannel;
+
+// Allocates both rings and starts the kernel thread, which publishes the
+// current power mode, privacy level and memory usage right away. Boots the
+// kernel if aura_kernel_init has not. Null on failure.
+AuraKernelChannel *aura_kernel_channel_create();
+// Stops the kernel thread and frees the channel.
+void aura_kernel_channel_destroy(AuraKernelChannel *channel);
+
+// Renderer side; one thread polls events and one pushes telemetry.
+// 1 and fills *out when an event was waiting, 0 when empty.
+int32_t aura_kernel_channel_poll_event(const AuraKernelChannel *channel,
+                                       AuraKernelEvent *out);
+// 0 when the ring is full; the frame's telemetry is dropped.
+int32_t aura_kernel_channel_push_telemetry(
+    const AuraKernelChannel *channel, const AuraFrameTelemetry *telemetry);
+
+// Switches the kernel's power mode (AURA_POWER_*), e.g. from the platform's
+// battery saver; the kernel thread answers with an AURA_EVENT_POWER_MODE.
+// Any thread. 0 for an unknown mode.
+int32_t aura_kernel_channel_request_power_mode(
+    const AuraKernelChannel *channel, uint32_t mode);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,556 @@
+// Aura OS Liquid Island - Headless Frame Benchmark
+// Runs the LiquidIslandApp pipeline into offscreen images (no window, no
+// swapchain) and reports CPU record time, submit-to-fence latency and
+// frames/sec. Intended for display-less CI boxes with a software Vulkan
+// driver, e.g. VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LiquidIslandApp.hpp"
+#include "SoftwareLiquidRenderer.hpp"
+
+struct Series {
+  std::vector<double> samples;
+
+  void add(double v) { samples.push_back(v); }
+
+  double percentile(double p) {
+    if (samples.empty())
+      return 0.0;
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[idx];
+  }
+
+  double mean() const {
+    double sum = 0.0;
+    for (double v : samples)
+      sum += v;
+    return samples.empty() ? 0.0 : sum / samples.size();
+  }
+
+  double stddev() const {
+    if (samples.size() < 2)
+      return 0.0;
+    double m = mean(), sum = 0.0;
+    for (double v : samples)
+      sum += (v - m) * (v - m);
+    return std::sqrt(sum / (samples.size() - 1));
+  }
+};
+
+static void printSeries(const char *name, Series &s) {
+  std::printf("  %-18s avg %8.3f ms | p50 %8.3f | p95 %8.3f | max %8.3f\n",
+              name, s.mean(), s.percentile(0.5), s.percentile(0.95),
+              s.percentile(1.0));
+}
+
+// Largest per-channel difference (of 255) --check-fast-math and
+// --check-software accept. The polynomials and fp16 rounding move the warped
+// edge by a few hundredths of a pixel; an emulation of both shaders over the
+// bench's island sizes peaks at 4 levels, on the anti-aliasing ramp. The CPU
+// renderer differs from the GPU by the driver's sin/cos and by blending in
+// floats where the GPU rounds after each island, about one level.
+static const int DEFAULT_MAX_ERROR = 6;
+
+// Exit status of a check the device cannot run (ctest's SKIP_RETURN_CODE),
+// so it is reported as skipped rather than passed
+static const int EXIT_SKIPPED = 77;
+
+static void usage(const char *argv0) {
+  std::printf("usage: %s [--frames N] [--warmup N] [--width W] [--height H]\n"
+              "          [--sync] [--any-device] [--pipeline-stats] [--rerecord]\n"
+              "          [--no-pipeline-cache] [--islands N] [--tiled]\n"
+              "          [--compare-tiling] [--frames-in-flight N]\n"
+              "          [--stress-updates] [--quality low|medium|high]\n"
+              "          [--adaptive] [--render-scale S] [--dynamic-resolution]\n"
+              "          [--compare-scales] [--fast-math]\n"
+              "          [--check-fast-math] [--check-software]\n"
+              "          [--max-error N]\n"
+              "  --sync        wait for each frame to retire right after submit\n"
+              "                (exact submit-to-fence latency, no pipelining)\n"
+              "  --any-device  do not prefer a software (CPU) Vulkan device\n"
+              "  --pipeline-stats  also count shader invocations per frame\n"
+              "  --rerecord    re-record command buffers every frame instead\n"
+              "                of submitting the ones recorded at startup\n"
+              "  --no-pipeline-cache  always compile the pipeline cold\n"
+              "  --islands N   draw N islands (one instanced draw)\n"
+              "  --tiled       classify 16x16 tiles in a compute pre-pass and\n"
+              "                only run the liquid warp on edge tiles\n"
+              "  --compare-tiling  run the instanced and the tiled path back\n"
+              "                to back and compare fragment work and GPU time\n"
+              "  --frames-in-flight N  frames the CPU may run ahead, 1-3\n"
+              "  --stress-updates  run once quiet and once with a thread\n"
+              "                posting island targets as fast as it can, and\n"
+              "                compare drawFrame jitter\n"
+              "  --quality T   liquid shader tier (default high)\n"
+              "  --adaptive    let the quality governor pick the tier from\n"
+              "                frame cost, starting at --quality\n"
+              "  --render-scale S  shade the liquid layer at S (0.25-1) of\n"
+              "                the target size and upscale it\n"
+              "  --dynamic-resolution  pick the scale from frame cost\n"
+              "  --compare-scales  run at 100%%, 75%%, 50%% and 35%% and compare\n"
+              "                GPU time of the shading and upscale passes\n"
+              "  --fast-math   shade with the fp16/polynomial liquid shader\n"
+              "                when the device supports shaderFloat16\n"
+              "  --check-fast-math  render the same frames with both liquid\n"
+              "                shaders and fail if any colour channel differs\n"
+              "                by more than --max-error levels (of 255, default\n"
+              "                %d); exits with %d when the device has no\n"
+              "                shaderFloat16\n"
+              "  --check-software  render the same frames on the CPU with\n"
+              "                SoftwareLiquidRenderer and compare them with\n"
+              "                the GPU's, with the same limit\n",
+              argv0, DEFAULT_MAX_ERROR, EXIT_SKIPPED);
+}
+
+struct BenchResult {
+  std::string deviceName;
+  Series record, fenceWait, submitToFence, frame, gpu;
+  // GPU time of the island shading pass (liquid or liquid layer) and of the
+  // upscale pass
+  Series shade, upscale;
+  uint64_t fragmentInvocations = 0;
+  double shadedPixels = 0.0;
+  double totalSeconds = 0.0;
+  // Island targets posted while measuring, and how many of them a newer one
+  // replaced before the render loop picked them up
+  uint64_t targetsPosted = 0;
+  uint64_t targetsSuperseded = 0;
+  // Tier at the end of the run and governor switches while measuring
+  QualityTier quality = QualityTier::High;
+  uint64_t downshifts = 0;
+  uint64_t upshifts = 0;
+  float renderScale = 1.0f;
+  bool fastMath = false;
+};
+
+// Fixed animation step so quiet and stressed runs do the same spring work
+static const float BENCH_STEP = 1.0f / 120.0f;
+
+static BenchResult runBench(const AppConfig &config, int frames, int warmup,
+                            bool stressUpdates = false) {
+  LiquidIslandApp app(config);
+  BenchResult r;
+  app.init();
+  for (int i = 0; i < warmup; i++) {
+    app.stepAnimation(BENCH_STEP);
+    app.drawFrame();
+  }
+
+  // Stands in for a UI thread that never waits for the renderer: it
+  // toggles the island shape in a tight loop through the mailbox.
+  std::atomic<bool> stopProducer{false};
+  std::thread producer;
+  uint64_t postedBefore = app.targetMailbox().publishedCount();
+  uint64_t supersededBefore = app.targetMailbox().supersededCount();
+  if (stressUpdates) {
+    producer = std::thread([&app, &config, &stopProducer] {
+      float centreX = (float)config.width * 0.5f;
+      IslandState compact = {200.0f, 40.0f, centreX, 50.0f, 20.0f};
+      IslandState expanded = {360.0f, 120.0f, centreX, 90.0f, 40.0f};
+      for (uint64_t n = 0; !stopProducer.load(std::memory_order_relaxed); n++)
+        app.setIslandTarget(n & 1 ? expanded : compact);
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) {
+    app.stepAnimation(BENCH_STEP);
+    app.drawFrame();
+    const FrameTimings &t = app.lastFrameTimings();
+    r.record.add(t.recordMs);
+    r.fenceWait.add(t.fenceWaitMs);
+    r.submitToFence.add(t.submitToFenceMs);
+    r.frame.add(t.frameMs);
+    if (t.gpuMs > 0.0) {
+      r.gpu.add(t.gpuMs);
+      const GpuFrameStats &stats = app.lastGpuStats();
+      for (uint32_t p = 0; p < stats.passCount; p++) {
+        const GpuPassTiming &pass = stats.passes[p];
+        if (std::strncmp(pass.name, "liquid", 6) == 0)
+          r.shade.add(pass.durationMs());
+        else if (std::strcmp(pass.name, "upscale") == 0)
+          r.upscale.add(pass.durationMs());
+      }
+    }
+    r.fragmentInvocations = t.fragmentInvocations;
+    r.shadedPixels = t.shadedPixels;
+  }
+  r.totalSeconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  if (producer.joinable()) {
+    stopProducer = true;
+    producer.join();
+  }
+  r.targetsPosted = app.targetMailbox().publishedCount() - postedBefore;
+  r.targetsSuperseded =
+      app.targetMailbox().supersededCount() - supersededBefore;
+  r.deviceName = app.deviceName();
+  r.quality = app.qualityGovernor().tier();
+  r.downshifts = app.qualityGovernor().downshifts();
+  r.upshifts = app.qualityGovernor().upshifts();
+  r.renderScale = app.lastFrameTimings().renderScale;
+  r.fastMath = app.fastMathActive();
+  app.shutdown();
+  return r;
+}
+
+static void printResult(const AppConfig &config, BenchResult &r, int frames,
+                        int warmup) {
+  std::printf("------------------------------------------\n");
+  std::printf("  AURA OS | FRAME BENCH | HEADLESS\n");
+  std::printf("------------------------------------------\n");
+  std::printf("  Device: %s\n", r.deviceName.c_str());
+  std::printf("  Target: %ux%u, %u islands, %d frames (+%d warmup)%s%s%s\n",
+              config.width, config.height, config.islandCount, frames, warmup,
+              config.waitEachFrame ? ", synchronous" : "",
+              config.recordOnce ? ", recorded once" : ", re-recorded",
+              config.tiledShading ? ", tiled" : "");
+  printSeries("CPU record+upload", r.record);
+  printSeries("Fence wait", r.fenceWait);
+  printSeries("Submit->fence", r.submitToFence);
+  printSeries("drawFrame", r.frame);
+  if (!r.gpu.samples.empty())
+    printSeries("GPU frame", r.gpu);
+  double screenPixels = (double)config.width * config.height;
+  std::printf("  Island octagons: %.0f px/frame (%.2f%% of the target)\n",
+              r.shadedPixels, 100.0 * r.shadedPixels / screenPixels);
+  if (config.pipelineStatistics)
+    std::printf("  Fragment invocations: %llu/frame (%.2f%% of the target)\n",
+                (unsigned long long)r.fragmentInvocations,
+                100.0 * r.fragmentInvocations / screenPixels);
+  std::printf("  Throughput: %.1f frames/sec\n", frames / r.totalSeconds);
+  std::printf("  Quality: %s%s", qualityTierName(r.quality),
+              r.fastMath ? ", fast math (fp16)" : "");
+  if (config.adaptiveQuality)
+    std::printf(" (adaptive, %llu down / %llu up)",
+                (unsigned long long)r.downshifts,
+                (unsigned long long)r.upshifts);
+  std::printf("\n");
+  if (r.renderScale < 1.0f || config.dynamicResolution)
+    std::printf("  Liquid layer: %.0f%% of the target%s\n",
+                100.0 * r.renderScale,
+                config.dynamicResolution ? " (dynamic, final)" : "");
+}
+
+static void printScaleComparison(const std::vector<float> &scales,
+                                 std::vector<BenchResult> &results) {
+  double native = results[0].gpu.mean();
+  std::printf("------------------------------------------\n");
+  std::printf("  %-7s %12s %10s %10s %10s %8s\n", "scale", "shaded px",
+              "shade ms", "upscale ms", "GPU ms", "speedup");
+  for (size_t i = 0; i < scales.size(); i++) {
+    BenchResult &r = results[i];
+    double gpu = r.gpu.mean();
+    std::printf("  %6.0f%% %12.0f %10.3f %10.3f %10.3f %7.2fx\n",
+                100.0 * scales[i], r.shadedPixels, r.shade.mean(),
+                r.upscale.mean(), gpu, gpu > 0.0 ? native / gpu : 0.0);
+  }
+}
+
+// Shader times the golden frames are rendered at; large ones catch error
+// that grows with the angle
+static const float GOLDEN_TIMES[] = {0.0f, 1.3f, 17.0f, 250.0f, 3600.0f};
+
+struct GoldenFrame {
+  // B8G8R8A8 rows, as read back
+  std::vector<uint8_t> pixels;
+  bool fastMath = false;
+  // What the liquid pass was drawn from, for SoftwareLiquidRenderer
+  LiquidFrameUniforms uniforms = {};
+  std::vector<LiquidIslandInstance> islands;
+  QualityTier quality = QualityTier::High;
+};
+
+// Renders one frame of a fixed scene: the main island expanded, small
+// islands below it, the springs settled and the shader time pinned.
+static GoldenFrame renderGoldenFrame(AppConfig config, float time) {
+  config.shaderTime = time;
+  config.islandCount = std::max(config.islandCount, 32u);
+  config.adaptiveQuality = false;
+  config.dynamicResolution = false;
+  LiquidIslandApp app(config);
+  app.init();
+  float centreX = (float)config.width * 0.5f;
+  app.setIslandTarget({360.0f, 120.0f, centreX, 90.0f, 40.0f});
+  for (int i = 0; i < 240; i++)
+    app.stepAnimation(BENCH_STEP);
+  app.drawFrame();
+  GoldenFrame golden;
+  app.readbackFrame(golden.pixels);
+  app.lastFrameInputs(golden.uniforms, golden.islands);
+  golden.fastMath = app.fastMathActive();
+  golden.quality = app.qualityGovernor().tier();
+  app.shutdown();
+  return golden;
+}
+
+// Per-channel differences between two images of the same size, one row of
+// the golden-image tables
+struct ImageDiff {
+  int max = 0;
+  uint64_t total = 0, differ = 0, over = 0;
+};
+
+// `actualOrder` maps each channel of `expected` to its byte in `actual`
+static ImageDiff compareImages(const std::vector<uint8_t> &expected,
+                               const std::vector<uint8_t> &actual,
+                               const int actualOrder[4], int maxError) {
+  ImageDiff diff;
+  for (size_t p = 0; p < expected.size(); p += 4) {
+    int pixelMax = 0;
+    for (size_t c = 0; c < 4; c++) {
+      int error =
+          std::abs((int)expected[p + c] - (int)actual[p + actualOrder[c]]);
+      pixelMax = std::max(pixelMax, error);
+      diff.total += (uint64_t)error;
+    }
+    diff.differ += pixelMax > 0;
+    diff.over += pixelMax > maxError;
+    diff.max = std::max(diff.max, pixelMax);
+  }
+  return diff;
+}
+
+static void printDiffHeader() {
+  std::printf("------------------------------------------\n");
+  std::printf("  %-10s %10s %12s %12s %10s\n", "time (s)", "max error",
+              "mean error", "px differ", "px over");
+}
+
+static void printDiff(float time, const ImageDiff &diff, size_t bytes) {
+  std::printf("  %-10.1f %10d %12.5f %12llu %10llu\n", time, diff.max,
+              (double)diff.total / (double)bytes,
+              (unsigned long long)diff.differ, (unsigned long long)diff.over);
+}
+
+// Golden-image test of liquid_fast.frag against liquid.frag. Exit status:
+// success when no channel of any pixel differs by more than maxError,
+// EXIT_SKIPPED when the device cannot run the fast shader
+static int checkFastMath(const AppConfig &config, int maxError) {
+  AppConfig reference = config, fast = config;
+  reference.fastMath = false;
+  fast.fastMath = true;
+  const int sameOrder[4] = {0, 1, 2, 3};
+  printDiffHeader();
+  int worst = 0;
+  for (float time : GOLDEN_TIMES) {
+    GoldenFrame expected = renderGoldenFrame(reference, time);
+    GoldenFrame actual = renderGoldenFrame(fast, time);
+    if (!actual.fastMath) {
+      std::printf("  No shaderFloat16 on this device; the fast shader is not "
+                  "used: SKIPPED\n");
+      return EXIT_SKIPPED;
+    }
+    ImageDiff diff =
+        compareImages(expected.pixels, actual.pixels, sameOrder, maxError);
+    printDiff(time, diff, expected.pixels.size());
+    worst = std::max(worst, diff.max);
+  }
+  std::printf("  Fast math: max error %d of 255 (limit %d): %s\n", worst,
+              maxError, worst <= maxError ? "PASS" : "FAIL");
+  return worst <= maxError ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// SoftwareLiquidRenderer against the GPU's liquid.frag on the golden frames;
+// true when no channel differs by more than maxError
+static bool checkSoftware(const AppConfig &config, int maxError) {
+  AppConfig reference = config;
+  // The renderer reproduces the native, untiled liquid.frag pass
+  reference.fastMath = false;
+  reference.tiledShading = false;
+  reference.renderScale = 1.0f;
+  SoftwareLiquidRenderer renderer;
+  std::printf("Software renderer: %s kernel, %u threads\n",
+              SoftwareLiquidRenderer::simdLevelName(renderer.simdLevel()),
+              renderer.threadCount());
+  // The CPU writes RGBA, the readback is BGRA
+  const int bgraOrder[4] = {2, 1, 0, 3};
+  printDiffHeader();
+  int worst = 0;
+  std::vector<uint8_t> cpu((size_t)config.width * config.height * 4);
+  for (float time : GOLDEN_TIMES) {
+    GoldenFrame gpu = renderGoldenFrame(reference, time);
+    renderer.render(gpu.uniforms, gpu.islands.data(),
+                    (uint32_t)gpu.islands.size(),
+                    liquidQualitySpec(gpu.quality), cpu.data(),
+                    config.width, config.height);
+    ImageDiff diff = compareImages(cpu, gpu.pixels, bgraOrder, maxError);
+    printDiff(time, diff, cpu.size());
+    worst = std::max(worst, diff.max);
+  }
+  std::printf("  Software: max error %d of 255 (limit %d): %s\n", worst,
+              maxError, worst <= maxError ? "PASS" : "FAIL");
+  return worst <= maxError;
+}
+
+static void printStressComparison(BenchResult &quiet, BenchResult &stressed) {
+  std::printf("------------------------------------------\n");
+  std::printf("  %-22s %14s %14s\n", "", "quiet", "stressed");
+  std::printf("  %-22s %14.3f %14.3f\n", "drawFrame p50 (ms)",
+              quiet.frame.percentile(0.5), stressed.frame.percentile(0.5));
+  std::printf("  %-22s %14.3f %14.3f\n", "drawFrame p99 (ms)",
+              quiet.frame.percentile(0.99), stressed.frame.percentile(0.99));
+  std::printf("  %-22s %14.3f %14.3f\n", "drawFrame jitter (ms)",
+              quiet.frame.stddev(), stressed.frame.stddev());
+  uint64_t applied = stressed.targetsPosted - stressed.targetsSuperseded;
+  std::printf("  Targets: %.0f posted/sec, %llu applied, %llu superseded\n",
+              stressed.targetsPosted / stressed.totalSeconds,
+              (unsigned long long)applied,
+              (unsigned long long)stressed.targetsSuperseded);
+}
+
+int main(int argc, char **argv) {
+  AppConfig config;
+  config.headless = true;
+  config.preferSoftwareDevice = true;
+  // Fixed tier unless --adaptive, so runs stay comparable
+  config.adaptiveQuality = false;
+  int frames = 600;
+  int warmup = 60;
+  bool compareTiling = false;
+  bool stressUpdates = false;
+  bool compareScales = false;
+  bool checkFast = false;
+  bool checkCpu = false;
+  int maxError = DEFAULT_MAX_ERROR;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--frames" && hasValue)
+      frames = std::atoi(argv[++i]);
+    else if (arg == "--warmup" && hasValue)
+      warmup = std::atoi(argv[++i]);
+    else if (arg == "--width" && hasValue)
+      config.width = (uint32_t)std::atoi(argv[++i]);
+    else if (arg == "--height" && hasValue)
+      config.height = (uint32_t)std::atoi(argv[++i]);
+    else if (arg == "--sync")
+      config.waitEachFrame = true;
+    else if (arg == "--any-device")
+      config.preferSoftwareDevice = false;
+    else if (arg == "--pipeline-stats")
+      config.pipelineStatistics = true;
+    else if (arg == "--rerecord")
+      config.recordOnce = false;
+    else if (arg == "--no-pipeline-cache")
+      config.pipelineCachePath.clear();
+    else if (arg == "--islands" && hasValue)
+      config.islandCount = (uint32_t)std::atoi(argv[++i]);
+    else if (arg == "--tiled")
+      config.tiledShading = true;
+    else if (arg == "--compare-tiling")
+      compareTiling = true;
+    else if (arg == "--frames-in-flight" && hasValue)
+      config.framesInFlight = (uint32_t)std::atoi(argv[++i]);
+    else if (arg == "--stress-updates")
+      stressUpdates = true;
+    else if (arg == "--quality" && hasValue) {
+      std::string tier = argv[++i];
+      if (tier == "low")
+        config.quality = QualityTier::Low;
+      else if (tier == "medium")
+        config.quality = QualityTier::Medium;
+      else
+        config.quality = QualityTier::High;
+    } else if (arg == "--adaptive")
+      config.adaptiveQuality = true;
+    else if (arg == "--render-scale" && hasValue)
+      config.renderScale = (float)std::atof(argv[++i]);
+    else if (arg == "--dynamic-resolution")
+      config.dynamicResolution = true;
+    else if (arg == "--compare-scales")
+      compareScales = true;
+    else if (arg == "--fast-math")
+      config.fastMath = true;
+    else if (arg == "--check-fast-math")
+      checkFast = true;
+    else if (arg == "--check-software")
+      checkCpu = true;
+    else if (arg == "--max-error" && hasValue)
+      maxError = std::atoi(argv[++i]);
+    else {
+      usage(argv[0]);
+      return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (frames <= 0 || config.width == 0 || config.height == 0 ||
+      config.islandCount == 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  try {
+    if (checkFast)
+      return checkFastMath(config, maxError);
+    if (checkCpu)
+      return checkSoftware(config, maxError) ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (stressUpdates) {
+      BenchResult quiet = runBench(config, frames, warmup);
+      BenchResult stressed = runBench(config, frames, warmup, true);
+      printResult(config, quiet, frames, warmup);
+      printResult(config, stressed, frames, warmup);
+      printStressComparison(quiet, stressed);
+      return EXIT_SUCCESS;
+    }
+    if (compareScales) {
+      // Same scene, same tier, only the liquid layer's size changes
+      std::vector<float> scales = {1.0f, 0.75f, 0.5f, 0.35f};
+      std::vector<BenchResult> results;
+      config.dynamicResolution = false;
+      for (float scale : scales) {
+        AppConfig scaled = config;
+        scaled.renderScale = scale;
+        results.push_back(runBench(scaled, frames, warmup));
+        printResult(scaled, results.back(), frames, warmup);
+      }
+      printScaleComparison(scales, results);
+      return EXIT_SUCCESS;
+    }
+    if (!compareTiling) {
+      BenchResult r = runBench(config, frames, warmup);
+      printResult(config, r, frames, warmup);
+      return EXIT_SUCCESS;
+    }
+
+    // Same scene through both paths; fragment counts need pipeline stats
+    config.pipelineStatistics = true;
+    AppConfig tiled = config;
+    config.tiledShading = false;
+    tiled.tiledShading = true;
+    BenchResult quads = runBench(config, frames, warmup);
+    BenchResult tiles = runBench(tiled, frames, warmup);
+    printResult(config, quads, frames, warmup);
+    printResult(tiled, tiles, frames, warmup);
+
+    double quadGpu = quads.gpu.mean(), tileGpu = tiles.gpu.mean();
+    std::printf("------------------------------------------\n");
+    std::printf("  %-22s %14s %14s\n", "", "instanced", "tiled");
+    std::printf("  %-22s %14llu %14llu\n", "Fragment invocations",
+                (unsigned long long)quads.fragmentInvocations,
+                (unsigned long long)tiles.fragmentInvocations);
+    std::printf("  %-22s %14.3f %14.3f\n", "GPU ms/frame (avg)", quadGpu,
+                tileGpu);
+    if (tileGpu > 0.0)
+      std::printf("  GPU speedup: %.2fx\n", quadGpu / tileGpu);
+  } catch (const std::exception &e) {
+    std::cerr << "Aura Frame Bench Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+// Aura OS Liquid Island - Software Rasterizer Benchmark
+// Renders the liquid islands with SoftwareLiquidRenderer: checks every SIMD
+// kernel the CPU supports against the scalar (libm) reference, then times
+// the fastest one at 1, 2, 4, ... threads and reports megapixels per
+// second. CPU only; needs no Vulkan device or kernel library.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SoftwareLiquidRenderer.hpp"
+
+using Clock = std::chrono::steady_clock;
+using SimdLevel = SoftwareLiquidRenderer::SimdLevel;
+
+struct RasterConfig {
+  uint32_t width = 1280;
+  uint32_t height = 720;
+  uint32_t islands = 32;
+  uint32_t frames = 60;
+  // 0 = 1, 2, 4, ... up to the hardware thread count
+  uint32_t threads = 0;
+  QualityTier quality = QualityTier::High;
+  std::string ppmPath;
+};
+
+// The expanded main island at the top, then a grid of small pills below it,
+// like AuraFrameBench's scene
+static std::vector<LiquidIslandInstance> makeScene(const RasterConfig &config) {
+  std::vector<LiquidIslandInstance> islands;
+  IslandStyle style;
+  auto add = [&](float x, float y, float w, float h, float radius, float warp,
+                 float glow, float phase) {
+    LiquidIslandInstance island = {};
+    float rect[4] = {x, y, w, h};
+    float shape[4] = {radius, warp, glow, phase};
+    std::copy(rect, rect + 4, island.rect);
+    std::copy(shape, shape + 4, island.shape);
+    std::copy(style.colorA, style.colorA + 4, island.colorA);
+    std::copy(style.colorB, style.colorB + 4, island.colorB);
+    islands.push_back(island);
+  };
+  add(config.width * 0.5f, 90.0f, 360.0f, 120.0f, 40.0f, style.warpAmplitude,
+      style.glowRadius, 0.0f);
+
+  uint32_t columns = std::max(1u, config.width / 140);
+  for (uint32_t i = 1; i < config.islands; i++) {
+    uint32_t cell = i - 1;
+    float x = 70.0f + (float)(cell % columns) * 140.0f;
+    float y = 180.0f + (float)(cell / columns) * 56.0f;
+    add(x, y, 120.0f, 32.0f, 16.0f, 2.0f, 6.0f, 0.37f * (float)i);
+  }
+  return islands;
+}
+
+static LiquidFrameUniforms makeUniforms(const RasterConfig &config,
+                                        float seconds) {
+  LiquidFrameUniforms frame = {};
+  frame.timing[0] = seconds;
+  frame.timing[1] = 1.0f;
+  frame.resolution[0] = (float)config.width;
+  frame.resolution[1] = (float)config.height;
+  frame.resolution[2] = 1.0f / config.width;
+  frame.resolution[3] = 1.0f / config.height;
+  // The kernel's FLUID_CURVE (aura_kernel_get_fluid_curve), so this bench
+  // does not need the Rust library
+  frame.fluidCurve[0] = 0.4f;
+  frame.fluidCurve[1] = 0.15f;
+  frame.fluidCurve[2] = 1.2f;
+  frame.fluidCurve[3] = 0.05f;
+  return frame;
+}
+
+static int maxDifference(const std::vector<uint8_t> &a,
+                         const std::vector<uint8_t> &b) {
+  int worst = 0;
+  for (size_t i = 0; i < a.size(); i++)
+    worst = std::max(worst, std::abs((int)a[i] - (int)b[i]));
+  return worst;
+}
+
+static bool writePpm(const std::string &path, const std::vector<uint8_t> &rgba,
+                     uint32_t width, uint32_t height) {
+  FILE *file = std::fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  std::fprintf(file, "P6\n%u %u\n255\n", width, height);
+  for (size_t i = 0; i < (size_t)width * height; i++)
+    std::fwrite(&rgba[i * 4], 1, 3, file);
+  return std::fclose(file) == 0;
+}
+
+static void printUsage(const char *argv0) {
+  std::printf("usage: %s [--width N] [--height N] [--islands N] [--frames N]\n"
+              "       [--threads N] [--quality low|medium|high] "
+              "[--ppm path]\n",
+              argv0);
+}
+
+int main(int argc, char **argv) {
+  RasterConfig config;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto next = [&]() -> const char * {
+      return i + 1 < argc ? argv[++i] : nullptr;
+    };
+    const char *value = nullptr;
+    if (arg == "--width" && (value = next())) {
+      config.width = (uint32_t)std::max(1, std::atoi(value));
+    } else if (arg == "--height" && (value = next())) {
+      config.height = (uint32_t)std::max(1, std::atoi(value));
+    } else if (arg == "--islands" && (value = next())) {
+      config.islands = (uint32_t)std::max(1, std::atoi(value));
+    } else if (arg == "--frames" && (value = next())) {
+      config.frames = (uint32_t)std::max(1, std::atoi(value));
+    } else if (arg == "--threads" && (value = next())) {
+      config.threads = (uint32_t)std::max(1, std::atoi(value));
+    } else if (arg == "--quality" && (value = next())) {
+      std::string tier = value;
+      if (tier == "low")
+        config.quality = QualityTier::Low;
+      else if (tier == "medium")
+        config.quality = QualityTier::Medium;
+      else
+        config.quality = QualityTier::High;
+    } else if (arg == "--ppm" && (value = next())) {
+      config.ppmPath = value;
+    } else {
+      printUsage(argv[0]);
+      return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  std::vector<LiquidIslandInstance> islands = makeScene(config);
+  LiquidQualitySpec quality = liquidQualitySpec(config.quality);
+  size_t bytes = (size_t)config.width * config.height * 4;
+  std::printf("Software liquid: %ux%u, %zu islands, quality %s\n",
+              config.width, config.height, islands.size(),
+              qualityTierName(config.quality));
+
+  // Accuracy: every kernel against the scalar reference at a few times
+  const float times[] = {0.0f, 1.3f, 17.0f, 250.0f, 3600.0f};
+  const SimdLevel levels[] = {SimdLevel::AVX2, SimdLevel::NEON};
+  SoftwareLiquidRenderer renderer(1);
+  std::vector<uint8_t> reference(bytes), image(bytes);
+  bool ok = true;
+  for (SimdLevel level : levels) {
+    if (!SoftwareLiquidRenderer::isSupported(level))
+      continue;
+    int worst = 0;
+    for (float seconds : times) {
+      LiquidFrameUniforms frame = makeUniforms(config, seconds);
+      renderer.setSimdLevel(SimdLevel::Scalar);
+      renderer.render(frame, islands.data(), (uint32_t)islands.size(), quality,
+                      reference.data(), config.width, config.height);
+      renderer.setSimdLevel(level);
+      renderer.render(frame, islands.data(), (uint32_t)islands.size(), quality,
+                      image.data(), config.width, config.height);
+      worst = std::max(worst, maxDifference(reference, image));
+    }
+    // Polynomial sin/cos vs libm: rounding differences only
+    bool pass = worst <= 1;
+    ok = ok && pass;
+    std::printf("%-6s vs scalar: max channel error %d/255 %s\n",
+                SoftwareLiquidRenderer::simdLevelName(level), worst,
+                pass ? "PASS" : "FAIL");
+  }
+
+  std::vector<uint32_t> threadCounts;
+  if (config.threads) {
+    threadCounts.push_back(config.threads);
+  } else {
+    uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t n = 1; n < hardware; n *= 2)
+      threadCounts.push_back(n);
+    threadCounts.push_back(hardware);
+  }
+
+  SimdLevel best = SoftwareLiquidRenderer::bestSimdLevel();
+  std::printf("\nkernel %s, %u frames\n",
+              SoftwareLiquidRenderer::simdLevelName(best), config.frames);
+  std::printf("%8s %10s %10s %8s\n", "threads", "ms/frame", "MP/s", "speedup");
+  double megapixels = (double)config.width * config.height / 1e6;
+  double baseline = 0.0;
+  for (uint32_t threads : threadCounts) {
+    SoftwareLiquidRenderer pool(threads);
+    // One untimed frame starts the workers and warms the caches
+    LiquidFrameUniforms frame = makeUniforms(config, 0.0f);
+    pool.render(frame, islands.data(), (uint32_t)islands.size(), quality,
+                image.data(), config.width, config.height);
+    auto start = Clock::now();
+    for (uint32_t f = 0; f < config.frames; f++) {
+      frame = makeUniforms(config, (float)f / 120.0f);
+      pool.render(frame, islands.data(), (uint32_t)islands.size(), quality,
+                  image.data(), config.width, config.height);
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start)
+                    .count() /
+                config.frames;
+    if (baseline == 0.0)
+      baseline = ms;
+    std::printf("%8u %10.3f %10.1f %7.2fx\n", threads, ms,
+                megapixels / (ms / 1000.0), baseline / ms);
+  }
+
+  if (!config.ppmPath.empty()) {
+    if (writePpm(config.ppmPath, image, config.width, config.height))
+      std::printf("\nwrote %s\n", config.ppmPath.c_str());
+    else
+      std::printf("\ncould not write %s\n", config.ppmPath.c_str());
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,428 @@
+// Aura OS Liquid Island - Golden-Image and Frame-Time Regression Suite
+// Renders a fixed set of scenes headless (springs stepped a fixed number of
+// times, shader time pinned), compares each frame with a stored reference
+// image under a perceptual tolerance, and each scene's CPU frame time (all of
+// drawFrame) and GPU time with a JSON baseline. Exits non-zero when an image diverges or a
+// scene is slower than the baseline by more than --max-slowdown.
+//
+// References live in bench/golden (<scene>.ppm and baseline.json) and must
+// come from the software Vulkan driver CI uses, e.g.
+// VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json. Only
+// --update records them, into the build directory (or --golden-dir); copy
+// them to bench/golden and commit them after an intended visual or
+// performance change.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "LiquidIslandApp.hpp"
+
+#ifndef AURA_GOLDEN_DIR
+#define AURA_GOLDEN_DIR "bench/golden"
+#endif
+// Where --update writes when no --golden-dir is given
+#ifndef AURA_GOLDEN_UPDATE_DIR
+#define AURA_GOLDEN_UPDATE_DIR "golden"
+#endif
+
+struct Scene {
+  const char *name;
+  const char *description;
+  uint32_t islands;
+  // Pinned shader time (frame.timing.x)
+  float time;
+  // Spring steps after posting the expanded target; 0 keeps the main island
+  // at rest in its compact shape
+  int morphSteps;
+  QualityTier quality;
+};
+
+// 240 steps settle the springs; 12 stop the expand about halfway
+static const Scene SCENES[] = {
+    {"single", "one island at rest", 1, 0.0f, 0, QualityTier::High},
+    {"expanded", "main island expanded", 1, 1.3f, 240, QualityTier::High},
+    {"morph", "expand in progress", 1, 1.3f, 12, QualityTier::High},
+    {"many", "48 islands", 48, 17.0f, 240, QualityTier::High},
+    {"late", "an hour in, large angles", 16, 3600.0f, 240, QualityTier::High},
+    {"low", "48 islands, low tier", 48, 17.0f, 240, QualityTier::Low},
+};
+
+static const float SUITE_STEP = 1.0f / 120.0f;
+
+struct SuiteConfig {
+  // References are read from goldenDir; --update writes to updateDir
+  std::string goldenDir = AURA_GOLDEN_DIR;
+  std::string updateDir = AURA_GOLDEN_UPDATE_DIR;
+  std::string only;
+  uint32_t width = 640;
+  uint32_t height = 360;
+  int frames = 120;
+  int warmup = 30;
+  // Perceptual colour distance (0-1, YIQ) below which pixels count as equal
+  double threshold = 0.05;
+  // Fraction of the frame allowed to exceed threshold
+  double maxDiffPixels = 0.001;
+  // A scene fails when its p50 grows by more than this fraction ...
+  double maxSlowdown = 0.25;
+  // ... and by more than this many milliseconds (timer noise)
+  double minSlowdownMs = 0.05;
+  bool update = false;
+  // Missing references fail instead of only being reported
+  bool ci = false;
+  bool anyDevice = false;
+  std::string reportPath;
+};
+
+struct SceneTiming {
+  double frameMs = 0.0;
+  double gpuMs = 0.0;
+};
+
+struct Baseline {
+  std::string device;
+  std::map<std::string, SceneTiming> scenes;
+};
+
+static double median(std::vector<double> samples) {
+  if (samples.empty())
+    return 0.0;
+  std::sort(samples.begin(), samples.end());
+  return samples[samples.size() / 2];
+}
+
+// Draws the scene warmup + frames times (the springs frozen, so every frame
+// is the same work) and reads back the last frame as RGB
+static SceneTiming renderScene(const SuiteConfig &suite, const Scene &scene,
+                               std::vector<uint8_t> &rgb,
+                               std::string &device) {
+  AppConfig config;
+  config.headless = true;
+  config.preferSoftwareDevice = !suite.anyDevice;
+  config.adaptiveQuality = false;
+  config.dynamicResolution = false;
+  config.width = suite.width;
+  config.height = suite.height;
+  config.islandCount = scene.islands;
+  config.quality = scene.quality;
+  config.shaderTime = scene.time;
+
+  LiquidIslandApp app(config);
+  app.init();
+  if (scene.morphSteps > 0) {
+    float centreX = (float)suite.width * 0.5f;
+    app.setIslandTarget({360.0f, 120.0f, centreX, 90.0f, 40.0f});
+    for (int i = 0; i < scene.morphSteps; i++)
+      app.stepAnimation(SUITE_STEP);
+  }
+  for (int i = 0; i < suite.warmup; i++)
+    app.drawFrame();
+
+  std::vector<double> frame, gpu;
+  for (int i = 0; i < suite.frames; i++) {
+    app.drawFrame();
+    const FrameTimings &t = app.lastFrameTimings();
+    frame.push_back(t.frameMs);
+    if (t.gpuMs > 0.0)
+      gpu.push_back(t.gpuMs);
+  }
+
+  std::vector<uint8_t> bgra;
+  app.readbackFrame(bgra);
+  rgb.resize(bgra.size() / 4 * 3);
+  for (size_t p = 0, o = 0; p < bgra.size(); p += 4, o += 3) {
+    rgb[o + 0] = bgra[p + 2];
+    rgb[o + 1] = bgra[p + 1];
+    rgb[o + 2] = bgra[p + 0];
+  }
+  device = app.deviceName();
+  app.shutdown();
+  return {median(frame), median(gpu)};
+}
+
+static bool readPpm(const std::string &path, uint32_t &width,
+                    uint32_t &height, std::vector<uint8_t> &rgb) {
+  std::ifstream file(path, std::ios::binary);
+  std::string magic;
+  int maxValue = 0;
+  if (!(file >> magic >> width >> height >> maxValue) || magic != "P6" ||
+      maxValue != 255)
+    return false;
+  file.get();
+  rgb.resize((size_t)width * height * 3);
+  return (bool)file.read((char *)rgb.data(), (std::streamsize)rgb.size());
+}
+
+static bool writePpm(const std::string &path, uint32_t width, uint32_t height,
+                     const std::vector<uint8_t> &rgb) {
+  std::ofstream file(path, std::ios::binary);
+  file << "P6\n" << width << " " << height << "\n255\n";
+  file.write((const char *)rgb.data(), (std::streamsize)rgb.size());
+  return (bool)file;
+}
+
+// Squared YIQ distance, normalized to 0-1: brightness weighs most, as in
+// pixelmatch. Antialiased edges that move by a fraction of a pixel stay far
+// below the default threshold; a changed colour or a moved edge does not.
+static double perceptualDelta(const uint8_t *a, const uint8_t *b) {
+  double dr = (double)a[0] - b[0];
+  double dg = (double)a[1] - b[1];
+  double db = (double)a[2] - b[2];
+  double y = dr * 0.29889531 + dg * 0.58662247 + db * 0.11448223;
+  double i = dr * 0.59597799 - dg * 0.27417610 - db * 0.32180189;
+  double q = dr * 0.21147017 - dg * 0.52261711 + db * 0.31114694;
+  return (0.5053 * y * y + 0.299 * i * i + 0.1957 * q * q) / 35215.0;
+}
+
+struct ImageResult {
+  uint64_t differ = 0;
+  double worst = 0.0;
+};
+
+static ImageResult compareImages(const std::vector<uint8_t> &expected,
+                                 const std::vector<uint8_t> &actual,
+                                 double threshold) {
+  ImageResult result;
+  double limit = threshold * threshold;
+  for (size_t p = 0; p < expected.size(); p += 3) {
+    double delta = perceptualDelta(&expected[p], &actual[p]);
+    result.worst = std::max(result.worst, delta);
+    result.differ += delta > limit;
+  }
+  result.worst = std::sqrt(result.worst);
+  return result;
+}
+
+static std::string escapeJson(const std::string &text) {
+  std::string out;
+  for (char c : text) {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    out += c;
+  }
+  return out;
+}
+
+static bool writeBaseline(const std::string &path, const Baseline &baseline) {
+  std::ofstream file(path);
+  file << "{\n  \"device\": \"" << escapeJson(baseline.device)
+       << "\",\n  \"scenes\": [\n";
+  size_t n = 0;
+  for (const auto &[name, timing] : baseline.scenes) {
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "    {\"name\": \"%s\", \"frame_ms\": %.4f, \"gpu_ms\": %.4f}",
+                  name.c_str(), timing.frameMs, timing.gpuMs);
+    file << line << (++n < baseline.scenes.size() ? ",\n" : "\n");
+  }
+  file << "  ]\n}\n";
+  return (bool)file;
+}
+
+// Reads the file writeBaseline() produces; not a general JSON parser
+static bool readBaseline(const std::string &path, Baseline &baseline) {
+  std::ifstream file(path);
+  if (!file)
+    return false;
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  std::string text = buffer.str();
+
+  auto stringAfter = [&](const char *key, size_t from, size_t &end) {
+    std::string value;
+    size_t pos = text.find(key, from);
+    if (pos == std::string::npos)
+      return value;
+    pos = text.find('"', text.find(':', pos) + 1);
+    for (end = pos + 1; end < text.size() && text[end] != '"'; end++) {
+      if (text[end] == '\\')
+        end++;
+      value += text[end];
+    }
+    return value;
+  };
+  auto numberAfter = [&](const char *key, size_t from) {
+    size_t pos = text.find(key, from);
+    if (pos == std::string::npos)
+      return 0.0;
+    return std::strtod(text.c_str() + text.find(':', pos) + 1, nullptr);
+  };
+
+  size_t end = 0;
+  baseline.device = stringAfter("\"device\"", 0, end);
+  for (size_t pos = text.find("\"name\""); pos != std::string::npos;
+       pos = text.find("\"name\"", end)) {
+    std::string name = stringAfter("\"name\"", pos, end);
+    baseline.scenes[name] = {numberAfter("\"frame_ms\"", end),
+                             numberAfter("\"gpu_ms\"", end)};
+  }
+  return true;
+}
+
+static bool slower(double now, double before, const SuiteConfig &suite) {
+  return before > 0.0 && now > before * (1.0 + suite.maxSlowdown) &&
+         now - before > suite.minSlowdownMs;
+}
+
+static void usage(const char *argv0) {
+  std::printf(
+      "usage: %s [--update] [--ci] [--scene NAME] [--golden-dir DIR]\n"
+      "          [--frames N] [--warmup N] [--threshold T]\n"
+      "          [--max-diff-pixels F] [--max-slowdown F] [--any-device]\n"
+      "          [--report PATH]\n"
+      "  --update      record the reference images and the baseline into\n"
+      "                the build directory, or --golden-dir when given\n"
+      "  --ci          fail on a missing reference or baseline\n"
+      "  --scene NAME  run one scene only\n"
+      "  --threshold T perceptual colour distance (0-1) two pixels may\n"
+      "                differ by (default 0.05)\n"
+      "  --max-diff-pixels F  fraction of pixels allowed over the threshold\n"
+      "                (default 0.001)\n"
+      "  --max-slowdown F  fail a scene whose frame or GPU p50 grew by more\n"
+      "                than F (default 0.25 = 25%%)\n"
+      "  --any-device  do not prefer a software (CPU) Vulkan device\n"
+      "  --report PATH write this run's timings as JSON\n",
+      argv0);
+}
+
+int main(int argc, char **argv) {
+  SuiteConfig suite;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--update")
+      suite.update = true;
+    else if (arg == "--ci")
+      suite.ci = true;
+    else if (arg == "--scene" && hasValue)
+      suite.only = argv[++i];
+    else if (arg == "--golden-dir" && hasValue)
+      suite.goldenDir = suite.updateDir = argv[++i];
+    else if (arg == "--frames" && hasValue)
+      suite.frames = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--warmup" && hasValue)
+      suite.warmup = std::max(0, std::atoi(argv[++i]));
+    else if (arg == "--threshold" && hasValue)
+      suite.threshold = std::atof(argv[++i]);
+    else if (arg == "--max-diff-pixels" && hasValue)
+      suite.maxDiffPixels = std::atof(argv[++i]);
+    else if (arg == "--max-slowdown" && hasValue)
+      suite.maxSlowdown = std::atof(argv[++i]);
+    else if (arg == "--any-device")
+      suite.anyDevice = true;
+    else if (arg == "--report" && hasValue)
+      suite.reportPath = argv[++i];
+    else {
+      usage(argv[0]);
+      return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  std::string baselinePath = suite.goldenDir + "/baseline.json";
+  if (suite.update) {
+    baselinePath = suite.updateDir + "/baseline.json";
+    std::error_code ignored;
+    std::filesystem::create_directories(suite.updateDir, ignored);
+  }
+  Baseline baseline, current;
+  bool haveBaseline = !suite.update && readBaseline(baselinePath, baseline);
+  bool failed = false;
+  size_t pixels = (size_t)suite.width * suite.height;
+
+  std::printf("------------------------------------------\n");
+  std::printf("  AURA OS | REGRESSION SUITE | %ux%u\n", suite.width,
+              suite.height);
+  std::printf("------------------------------------------\n");
+  std::printf("  %-10s %-8s %10s %8s %10s %10s\n", "scene", "image",
+              "px over", "worst", "frame ms", "GPU ms");
+  try {
+    for (const Scene &scene : SCENES) {
+      if (!suite.only.empty() && suite.only != scene.name)
+        continue;
+      std::vector<uint8_t> rgb;
+      SceneTiming timing = renderScene(suite, scene, rgb, current.device);
+      current.scenes[scene.name] = timing;
+
+      std::string imageName = std::string("/") + scene.name + ".ppm";
+      std::vector<uint8_t> expected;
+      uint32_t width = 0, height = 0;
+      const char *status = "ok";
+      ImageResult image;
+      if (suite.update) {
+        status = writePpm(suite.updateDir + imageName, suite.width,
+                          suite.height, rgb)
+                     ? "updated"
+                     : "UNWRITABLE";
+      } else if (!readPpm(suite.goldenDir + imageName, width, height,
+                          expected)) {
+        // Never recorded implicitly: a run without references would pass
+        status = suite.ci ? "MISSING" : "missing";
+      } else if (width != suite.width || height != suite.height) {
+        status = "SIZE";
+      } else {
+        image = compareImages(expected, rgb, suite.threshold);
+        if (image.differ > suite.maxDiffPixels * pixels)
+          status = "DIFFERS";
+      }
+      // Failures are the upper-case states
+      if (status[0] >= 'A' && status[0] <= 'Z')
+        failed = true;
+
+      // Timings only mean something against the same device
+      std::string verdict;
+      auto before = baseline.scenes.find(scene.name);
+      if (haveBaseline && baseline.device == current.device &&
+          before != baseline.scenes.end()) {
+        if (slower(timing.frameMs, before->second.frameMs, suite))
+          verdict += " FRAME SLOWER";
+        if (slower(timing.gpuMs, before->second.gpuMs, suite))
+          verdict += " GPU SLOWER";
+        if (!verdict.empty()) {
+          char was[64];
+          std::snprintf(was, sizeof(was), " (was %.3f / %.3f)",
+                        before->second.frameMs, before->second.gpuMs);
+          verdict += was;
+          failed = true;
+        }
+      }
+      std::printf("  %-10s %-8s %10llu %8.3f %10.3f %10.3f%s\n", scene.name,
+                  status, (unsigned long long)image.differ, image.worst,
+                  timing.frameMs, timing.gpuMs, verdict.c_str());
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return EXIT_FAILURE;
+  }
+
+  std::printf("  Device: %s\n", current.device.c_str());
+  if (haveBaseline && baseline.device != current.device)
+    std::printf("  Baseline was recorded on %s; frame times not compared\n",
+                baseline.device.c_str());
+  // The baseline only from a full --update run
+  if (suite.update && suite.only.empty()) {
+    if (writeBaseline(baselinePath, current)) {
+      std::printf("  References written to %s\n", suite.updateDir.c_str());
+      if (suite.updateDir != AURA_GOLDEN_DIR)
+        std::printf("  Copy them to %s to commit them\n", AURA_GOLDEN_DIR);
+    } else {
+      std::printf("  Could not write %s\n", baselinePath.c_str());
+      failed = true;
+    }
+  } else if (!suite.update && !haveBaseline) {
+    std::printf("  No baseline at %s; record one with --update\n",
+                baselinePath.c_str());
+    failed = failed || suite.ci;
+  }
+  if (!suite.reportPath.empty() && !writeBaseline(suite.reportPath, current))
+    std::printf("  Could not write %s\n", suite.reportPath.c_str());
+  std::printf("  Result: %s\n", failed ? "FAIL" : "PASS");
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+// Aura OS Liquid Island - Spring Solver Microbenchmark
+// Steps N islands (5 spring channels each) with the original per-field
+// lambda and with every SpringBatch kernel the CPU supports, and reports
+// throughput in springs per microsecond. The kernels run the Euler
+// integrator so their results can be checked against the lambda. The
+// analytic integrator runs with a fixed dt and with dt jittered by a few
+// percent per step, as a real frame clock delivers it, which re-solves its
+// coefficients every step. CPU only; needs no Vulkan device.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "SpringBatch.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static const float kDt = 1.0f / 120.0f;
+
+// kDt within +/-3%, deterministic per step.
+static float jitteredDt(uint32_t step) {
+  uint32_t h = step * 2654435761u;
+  return kDt * (1.0f + 0.03f * ((float)(h >> 16) / 32767.5f - 1.0f));
+}
+
+static IslandState initialState(uint32_t i) {
+  return {200.0f, 40.0f, 400.0f + (float)(i % 17), 50.0f, 20.0f};
+}
+
+// Alternate between two targets so the springs keep moving.
+static IslandState targetState(uint32_t i, uint32_t step) {
+  bool expanded = ((step / 240) + i) % 2 == 0;
+  return expanded ? IslandState{360.0f, 120.0f, 400.0f, 90.0f, 40.0f}
+                  : initialState(i);
+}
+
+// The pre-SpringBatch code path: one scalar lambda per IslandState field.
+static double runLambda(uint32_t islands, uint32_t steps,
+                        std::vector<IslandState> &out) {
+  const float stiffness = 150.0f;
+  const float damping = 20.0f;
+  std::vector<IslandState> state(islands), velocity(islands);
+  for (uint32_t i = 0; i < islands; i++) {
+    state[i] = initialState(i);
+    velocity[i] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  }
+
+  auto start = Clock::now();
+  for (uint32_t s = 0; s < steps; s++) {
+    for (uint32_t i = 0; i < islands; i++) {
+      IslandState target = targetState(i, s);
+      float deltaTime = kDt;
+      auto calculateSpring = [&](float current, float targetVal,
+                                 float &vel) -> float {
+        float force = -stiffness * (current - targetVal) - damping * vel;
+        vel += force * deltaTime;
+        return current + vel * deltaTime;
+      };
+      IslandState &cur = state[i];
+      IslandState &vel = velocity[i];
+      cur.width = calculateSpring(cur.width, target.width, vel.width);
+      cur.height = calculateSpring(cur.height, target.height, vel.height);
+      cur.x = calculateSpring(cur.x, target.x, vel.x);
+      cur.y = calculateSpring(cur.y, target.y, vel.y);
+      cur.cornerRadius =
+          calculateSpring(cur.cornerRadius, target.cornerRadius,
+                          vel.cornerRadius);
+    }
+  }
+  double us =
+      std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  out = state;
+  return us;
+}
+
+static double runBatch(SpringBatch::SimdLevel level,
+                       SpringBatch::Integrator integrator, bool jitter,
+                       uint32_t islands, uint32_t steps,
+                       std::vector<IslandState> &out) {
+  SpringBatch batch;
+  batch.setIntegrator(integrator);
+  // Snap only when fully converged, so results stay comparable with the
+  // lambda (which never snaps) without decaying into denormals
+  batch.setDefaultRestEpsilon(1e-4f, 1e-4f);
+  for (uint32_t i = 0; i < islands; i++)
+    batch.addIsland(initialState(i));
+
+  auto start = Clock::now();
+  for (uint32_t s = 0; s < steps; s++) {
+    // Targets only change every 240 steps, as they would from UI events.
+    if (s % 240 == 0) {
+      for (uint32_t i = 0; i < islands; i++)
+        batch.setTarget(i, targetState(i, s));
+    }
+    batch.stepWith(level, jitter ? jitteredDt(s) : kDt);
+  }
+  double us =
+      std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  out.resize(islands);
+  for (uint32_t i = 0; i < islands; i++)
+    out[i] = batch.state(i);
+  return us;
+}
+
+static float maxDifference(const std::vector<IslandState> &a,
+                           const std::vector<IslandState> &b) {
+  float diff = 0.0f;
+  for (size_t i = 0; i < a.size(); i++) {
+    const float *pa = &a[i].width;
+    const float *pb = &b[i].width;
+    for (uint32_t c = 0; c < SpringBatch::CHANNELS_PER_ISLAND; c++)
+      diff = std::max(diff, std::fabs(pa[c] - pb[c]));
+  }
+  return diff;
+}
+
+int main(int argc, char **argv) {
+  uint32_t islands = 256;
+  uint32_t steps = 20000;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--islands" && hasValue)
+      islands = (uint32_t)std::atoi(argv[++i]);
+    else if (arg == "--steps" && hasValue)
+      steps = (uint32_t)std::atoi(argv[++i]);
+    else {
+      std::printf("usage: %s [--islands N] [--steps N]\n", argv[0]);
+      return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (islands == 0 || steps == 0)
+    return EXIT_FAILURE;
+
+  double springs = (double)islands * SpringBatch::CHANNELS_PER_ISLAND * steps;
+  std::printf("\n==============================================\n");
+  std::printf(" AURA OS | SPRING SOLVER BENCH\n");
+  std::printf("==============================================\n");
+  std::printf("  Islands      : %u (%u springs)\n", islands,
+              islands * SpringBatch::CHANNELS_PER_ISLAND);
+  std::printf("  Steps        : %u\n", steps);
+  std::printf("  Best kernel  : %s\n",
+              SpringBatch::simdLevelName(SpringBatch::bestSimdLevel()));
+  std::printf("----------------------------------------------\n");
+
+  std::vector<IslandState> reference;
+  double lambdaUs = runLambda(islands, steps, reference);
+  std::printf("  %-14s %9.1f springs/us\n", "per-field", springs / lambdaUs);
+
+  const SpringBatch::SimdLevel levels[] = {
+      SpringBatch::SimdLevel::Scalar, SpringBatch::SimdLevel::SSE2,
+      SpringBatch::SimdLevel::AVX2, SpringBatch::SimdLevel::NEON};
+  for (SpringBatch::SimdLevel level : levels) {
+    if (!SpringBatch::isSupported(level))
+      continue;
+    std::vector<IslandState> result;
+    double us = runBatch(level, SpringBatch::Integrator::Euler, false,
+                         islands, steps, result);
+    std::printf("  %-14s %9.1f springs/us  (x%.2f, max diff %.2g px)\n",
+                SpringBatch::simdLevelName(level), springs / us,
+                lambdaUs / us, maxDifference(reference, result));
+  }
+  for (bool jitter : {false, true}) {
+    std::vector<IslandState> analytic;
+    double us =
+        runBatch(SpringBatch::bestSimdLevel(),
+                 SpringBatch::Integrator::Analytic, jitter, islands, steps,
+                 analytic);
+    std::printf("  %-14s %9.1f springs/us  (x%.2f, %s)\n",
+                jitter ? "analytic, jit" : "analytic", springs / us,
+                lambdaUs / us,
+                SpringBatch::simdLevelName(SpringBatch::bestSimdLevel()));
+  }
+  std::printf("==============================================\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+# Build-time shader compilation shared by the desktop build and the Android
+# NDK build. GLSL sources are compiled to SPIR-V with glslc (or
+# glslangValidator) and embedded into a generated header, so the binaries
+# never read shader files at runtime.
+#
+#   aura_embed_shaders(<target> HEADER <name.h> SHADERS <file.vert> ...)
+#
+# Each shader becomes `aura_shaders::<file>_<stage>` (e.g. liquid_frag) plus a
+# `<name>_size` byte count. Editing a .vert/.frag rebuilds only that shader.
+
+set(AURA_SHADER_TOOLS_DIR "${CMAKE_CURRENT_LIST_DIR}")
+
+set(_aura_glslc_hints "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+if(ANDROID_NDK)
+    # The NDK ships glslc under shader-tools/<host-tag>/
+    file(GLOB _aura_ndk_shader_tools "${ANDROID_NDK}/shader-tools/*")
+    list(APPEND _aura_glslc_hints ${_aura_ndk_shader_tools})
+endif()
+
+find_program(AURA_GLSLC glslc HINTS ${_aura_glslc_hints})
+if(NOT AURA_GLSLC)
+    find_program(AURA_GLSLANG_VALIDATOR glslangValidator HINTS ${_aura_glslc_hints})
+endif()
+
+function(aura_embed_shaders target)
+    cmake_parse_arguments(ARG "" "HEADER" "SHADERS" ${ARGN})
+    if(NOT AURA_GLSLC AND NOT AURA_GLSLANG_VALIDATOR)
+        message(FATAL_ERROR "aura_embed_shaders: neither glslc nor glslangValidator found "
+                            "(install the Vulkan SDK or set AURA_GLSLC)")
+    endif()
+
+    set(outDir "${CMAKE_CURRENT_BINARY_DIR}/aura_shaders")
+    file(MAKE_DIRECTORY "${outDir}")
+
+    set(spvFiles "")
+    set(entries "")
+    foreach(shader IN LISTS ARG_SHADERS)
+        get_filename_component(source "${shader}" ABSOLUTE)
+        get_filename_component(sourceDir "${source}" DIRECTORY)
+        get_filename_component(fileName "${source}" NAME)
+        string(MAKE_C_IDENTIFIER "${fileName}" symbol)
+        set(spv "${outDir}/${fileName}.spv")
+
+        # Shared #include files; listed explicitly for when no depfile is used
+        file(GLOB includes "${sourceDir}/*.glsl")
+
+        # SPIR-V 1.0 / Vulkan 1.0 so the same module loads on every Android driver
+        if(AURA_GLSLC)
+            # glslc tracks #include'd files through a depfile where the generator can
+            set(depArgs "")
+            if(CMAKE_GENERATOR MATCHES "Ninja" OR NOT CMAKE_VERSION VERSION_LESS 3.20)
+                set(depArgs DEPFILE "${spv}.d")
+            endif()
+            add_custom_command(
+                OUTPUT "${spv}"
+                COMMAND "${AURA_GLSLC}" --target-env=vulkan1.0 -O -I "${sourceDir}"
+                        -MD -MF "${spv}.d" -o "${spv}" "${source}"
+                DEPENDS "${source}" ${includes}
+                ${depArgs}
+                COMMENT "Compiling shader ${fileName}"
+                VERBATIM)
+        else()
+            add_custom_command(
+                OUTPUT "${spv}"
+                COMMAND "${AURA_GLSLANG_VALIDATOR}" -V --target-env vulkan1.0
+                        -I${sourceDir} -o "${spv}" "${source}"
+                DEPENDS "${source}" ${includes}
+                COMMENT "Compiling shader ${fileName}"
+                VERBATIM)
+        endif()
+
+        list(APPEND spvFiles "${spv}")
+        # '|' rather than ';' so the list survives as a single -D argument
+        string(APPEND entries "|${symbol}=${spv}")
+    endforeach()
+
+    string(SUBSTRING "${entries}" 1 -1 entries)
+    set(header "${outDir}/${ARG_HEADER}")
+    add_custom_command(
+        OUTPUT "${header}"
+        COMMAND "${CMAKE_COMMAND}" "-DOUTPUT=${header}" "-DSHADERS=${entries}"
+                -P "${AURA_SHADER_TOOLS_DIR}/SpirvToHeader.cmake"
+        DEPENDS ${spvFiles} "${AURA_SHADER_TOOLS_DIR}/SpirvToHeader.cmake"
+        COMMENT "Embedding SPIR-V into ${ARG_HEADER}"
+        VERBATIM)
+
+    add_custom_target(${target}_shaders DEPENDS "${header}")
+    add_dependencies(${target} ${target}_shaders)
+    target_include_directories(${target} PRIVATE "${outDir}")
+endfunction()
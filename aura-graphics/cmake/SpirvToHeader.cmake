@@ -0,0 +1,47 @@
+# Converts compiled SPIR-V modules into a C++ header of aligned constexpr
+# uint32_t arrays. Run in script mode:
+#   cmake -DOUTPUT=<header> -DSHADERS="<name>=<file.spv>|..." -P SpirvToHeader.cmake
+
+if(NOT OUTPUT OR NOT SHADERS)
+    message(FATAL_ERROR "SpirvToHeader: OUTPUT and SHADERS are required")
+endif()
+
+string(REPLACE "|" ";" SHADERS "${SHADERS}")
+set(body "")
+foreach(entry IN LISTS SHADERS)
+    string(REPLACE "=" ";" parts "${entry}")
+    list(GET parts 0 name)
+    list(GET parts 1 spv)
+
+    file(READ "${spv}" hex HEX)
+    string(LENGTH "${hex}" hexLength)
+    math(EXPR remainder "${hexLength} % 8")
+    if(hexLength EQUAL 0 OR NOT remainder EQUAL 0)
+        message(FATAL_ERROR "SpirvToHeader: ${spv} is not a SPIR-V module")
+    endif()
+
+    # SPIR-V is little-endian: swap each 4-byte group into a 32-bit literal
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1," words "${hex}")
+    string(REGEX REPLACE "(0x........,0x........,0x........,0x........,0x........,0x........,)"
+           "\\1\n    " words "${words}")
+    string(REPLACE "," ", " words "${words}")
+    string(REPLACE ", \n" ",\n" words "${words}")
+    string(REGEX REPLACE "[ \n]+$" "" words "${words}")
+
+    string(APPEND body
+        "alignas(16) inline constexpr uint32_t ${name}[] = {\n    ${words}\n};\n"
+        "inline constexpr size_t ${name}_size = sizeof(${name});\n\n")
+endforeach()
+
+set(content "// Generated by aura-graphics/cmake/SpirvToHeader.cmake - do not edit.\n")
+string(APPEND content "#pragma once\n\n#include <cstddef>\n#include <cstdint>\n\n")
+string(APPEND content "namespace aura_shaders {\n\n${body}} // namespace aura_shaders\n")
+
+# Only touch the header when the SPIR-V actually changed
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+    if(previous STREQUAL content)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${content}")
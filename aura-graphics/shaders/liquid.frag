@@ -1,42 +1,55 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
-layout(location = 0) in vec3 fragColor;
+#include "liquid_common.glsl"
+
+layout(location = 0) flat in uint islandIndex;
+layout(location = 1) in vec2 localPos;
 layout(location = 0) out vec4 outColor;
 
-layout(push_constant) uniform PushConstants {
-    float time;
-} push;
+// Largest per-axis displacement of the warp loop below:
+// 0.3 * (1 + 1/2 + ... + 1/WARP_ITERATIONS), folded at pipeline creation
+float warpBound() {
+    float bound = 0.0;
+    for (int i = 1; i <= WARP_ITERATIONS; i++)
+        bound += 0.3 / float(i);
+    return bound;
+}
 
 void main() {
-    // Coordinate normalization
-    vec2 uv = gl_FragCoord.xy / vec2(800.0, 600.0);
-    uv = uv * 2.0 - 1.0;
-    uv.x *= 800.0 / 600.0; // Aspect ratio correction
-    
+    Island island = islands[islandIndex];
+    vec2 halfSize = island.rect.zw * 0.5;
+    float time = fluidIntensity(frame.timing.x + island.shape.w);
+
+    // Coordinate normalization (island height spans [-1, 1])
+    vec2 uv = localPos / max(halfSize.y, 1.0);
+
     // Warping logic to make it look "liquid/liat"
-    for(float i = 1.0; i < 4.0; i++) {
-        uv.x += 0.3 / i * sin(i * 3.0 * uv.y + push.time);
-        uv.y += 0.3 / i * cos(i * 3.0 * uv.x + push.time);
+    vec2 warped = uv;
+    for (int n = 1; n <= WARP_ITERATIONS; n++) {
+        float i = float(n);
+        warped.x += 0.3 / i * sin(i * 3.0 * warped.y + time);
+        warped.y += 0.3 / i * cos(i * 3.0 * warped.x + time);
     }
-    
-    float d = length(uv);
-    
-    // Smooth threshold for the organic blob (gooey effect)
-    float mask = smoothstep(0.7, 0.68, d);
-    
-    // Premium Color Palette: Aura Blue to Cosmic Purple
-    vec3 auraBlue = vec3(0.1, 0.5, 1.0);
-    vec3 cosmicPurple = vec3(0.6, 0.2, 1.0);
-    vec3 mixedColor = mix(auraBlue, cosmicPurple, 0.5 + 0.5 * sin(push.time * 0.5 + d));
-    
-    // Add Electric Teal highlight
-    mixedColor = mix(mixedColor, vec3(0.0, 1.0, 0.8), pow(max(0.0, 0.5 - d), 3.0));
-    
-    if (mask > 0.0) {
-        // Dynamic glow and pulse
-        float glow = 0.1 / d;
-        outColor = vec4(mixedColor * mask + mixedColor * glow * 0.5, mask);
-    } else {
+    // Scale the displacement so the edge moves at most shape.y pixels
+    vec2 p = localPos + (warped - uv) * (island.shape.y / warpBound());
+
+    // Signed distance to the warped pill, anti-aliased over one pixel. In a
+    // reduced-scale liquid layer the ramp is linear and one texel wide, so
+    // bilinear filtering keeps it proportional to d for upscale.frag
+    float d = roundedBox(p, halfSize, islandRadius(island));
+    float width = edgeWidth();
+    float mask = width > 1.0 ? clamp(0.5 - 0.5 * d / width, 0.0, 1.0)
+                             : smoothstep(1.0, -1.0, d);
+
+    // Dynamic glow, fading to zero glowRadius pixels past the edge
+    float glow = 0.0;
+    if (GLOW && island.shape.z > 0.0)
+        glow = pow(clamp(1.0 - d / island.shape.z, 0.0, 1.0), 2.0) * 0.5;
+
+    float alpha = max(mask, glow);
+    if (alpha <= 0.0)
         discard;
-    }
+    // Premultiplied; blended with ONE, ONE_MINUS_SRC_ALPHA
+    outColor = vec4(islandColor(island, localPos, time) * alpha, alpha);
 }
@@ -0,0 +1,88 @@
+// Declarations shared by the liquid shaders (#include "liquid_common.glsl").
+// Layouts mirror LiquidUniforms.hpp.
+
+// Per-frame data streamed through the uniform ring
+layout(set = 0, binding = 0) uniform FrameData {
+    vec4 timing;     // x = seconds, y = liquid layer scale (1 = native)
+    vec4 resolution; // xy = size in pixels, zw = 1 / size
+    uvec4 counts;    // x = islands this frame, y = tile list capacity
+    vec4 fluidCurve; // ripple frequency/amplitude, wave frequency/amplitude
+} frame;
+
+struct Island {
+    vec4 rect;   // xy = centre, zw = width/height (pixels)
+    vec4 shape;  // x = corner radius, y = warp amplitude, z = glow radius, w = phase
+    vec4 colorA;
+    vec4 colorB;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Islands {
+    Island islands[];
+};
+
+// Quality tier (LiquidQualitySpec in LiquidUniforms.hpp); every tier is a
+// pipeline built at startup, picked per frame by the QualityGovernor
+layout(constant_id = 1) const int WARP_ITERATIONS = 3;
+layout(constant_id = 2) const bool GLOW = true;
+layout(constant_id = 3) const bool HIGHLIGHT = true;
+
+// Screen tiles of the tiled path (tile_classify.comp, tile.vert)
+const float TILE_SIZE = 16.0;
+
+// The kernel's aura_kernel_calculate_fluid_intensity(), evaluated here from
+// its exported coefficients instead of once per frame across the FFI
+float fluidIntensity(float t) {
+    float ripple = sin(t * frame.fluidCurve.x) * frame.fluidCurve.y;
+    return t + ripple + cos(t * frame.fluidCurve.z + ripple) * frame.fluidCurve.w;
+}
+
+float roundedBox(vec2 p, vec2 halfSize, float radius) {
+    vec2 q = abs(p) - halfSize + radius;
+    return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+}
+
+float islandRadius(Island island) {
+    return min(island.shape.x, min(island.rect.z, island.rect.w) * 0.5);
+}
+
+// Half-width of the anti-aliasing ramp across the island edge, in
+// framebuffer pixels: one pixel natively, one texel of the liquid layer when
+// it is rendered at a lower scale (upscale.frag rebuilds a sharp edge from it)
+float edgeWidth() {
+    float scale = frame.timing.y;
+    return scale > 0.0 && scale < 1.0 ? 1.0 / scale : 1.0;
+}
+
+// Region liquid.frag can touch, mirrored by islandBounds() in
+// IslandInstanceRing.cpp. The warp moves a point by at most shape.y per axis
+// and the coverage (the anti-aliasing ramp, or the glow) ends shape.z past
+// the warped edge, so, with c = max(shape.z, edgeWidth()),
+//   - per axis the island reaches halfSize + shape.y + c, and
+//   - since the SDF is 1-Lipschitz, nothing is drawn where the unwarped SDF
+//     exceeds shape.y * sqrt(2) + c; near a rounded corner that
+//     cuts the bounding box along a 45 degree line.
+// halfExtent is the box, cut the leg length of the triangle removed from
+// each of its corners.
+void islandBounds(Island island, out vec2 halfExtent, out float cut) {
+    float coverage = max(island.shape.z, edgeWidth());
+    vec2 halfSize = island.rect.zw * 0.5;
+    float radius = islandRadius(island);
+    halfExtent = halfSize + island.shape.y + coverage;
+    float reach = island.shape.y * 1.41421356 + coverage;
+    // Corner circle centre + its reach along the diagonal, as x + y
+    float diagonal = dot(halfSize - radius, vec2(1.0)) + (radius + reach) * 1.41421356;
+    cut = clamp(halfExtent.x + halfExtent.y - diagonal, 0.0,
+                min(halfExtent.x, halfExtent.y));
+}
+
+// Premium Color Palette: Aura Blue to Cosmic Purple, with an Electric Teal
+// highlight towards the centre
+vec3 islandColor(Island island, vec2 localPos, float time) {
+    vec2 halfSize = island.rect.zw * 0.5;
+    float centre = length(localPos / max(halfSize, vec2(1.0)));
+    vec3 mixedColor = mix(island.colorA.rgb, island.colorB.rgb,
+                          0.5 + 0.5 * sin(time * 0.5 + centre));
+    if (!HIGHLIGHT)
+        return mixedColor;
+    return mix(mixedColor, vec3(0.0, 1.0, 0.8), pow(max(0.0, 0.5 - centre), 3.0));
+}
@@ -0,0 +1,108 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+
+#include "liquid_common.glsl"
+
+// liquid.frag with half-precision arithmetic and polynomial sin/cos, for
+// devices with shaderFloat16 (AppConfig::fastMath). Pixel positions and the
+// edge distance stay fp32: above 1024 fp16 steps a whole pixel, far too
+// coarse for the anti-aliasing ramp. Angles are reduced to turns in fp32 as
+// well, so their error does not grow with time or island size; everything
+// after that (sine polynomials, glow falloff, colour mixing) runs in fp16.
+// AuraFrameBench --check-fast-math bounds the per-pixel difference to
+// liquid.frag.
+
+layout(location = 0) flat in uint islandIndex;
+layout(location = 1) in vec2 localPos;
+layout(location = 0) out vec4 outColor;
+
+// sin(2 pi t) for t in [-0.5, 0.5]: folded into [-0.25, 0.25], then an odd
+// quintic fitted for minimax error (7e-5; about 1.2e-3 with fp16 rounding)
+float16_t sinTurns(float16_t t) {
+    float16_t folded = (t > 0.0hf ? 0.5hf : -0.5hf) - t;
+    t = abs(t) > 0.25hf ? folded : t;
+    float16_t t2 = t * t;
+    return t * (6.28128hf + t2 * (-41.095257hf + 73.585698hf * t2));
+}
+
+// Angle in radians to turns in [-0.5, 0.5], in full precision
+float16_t turns(float radians) {
+    float t = radians * 0.15915494;
+    return float16_t(t - floor(t + 0.5));
+}
+
+float16_t fastSin(float radians) {
+    return sinTurns(turns(radians));
+}
+
+float16_t fastCos(float radians) {
+    return sinTurns(turns(radians + 1.57079633));
+}
+
+// fluidIntensity() on the polynomials; t grows without bound, so only the
+// reduced angles go to fp16
+float fastFluidIntensity(float t) {
+    float ripple = float(fastSin(t * frame.fluidCurve.x)) * frame.fluidCurve.y;
+    return t + ripple +
+           float(fastCos(t * frame.fluidCurve.z + ripple)) * frame.fluidCurve.w;
+}
+
+// islandColor() in fp16, pow(x, 3) as two multiplies
+f16vec3 fastIslandColor(Island island, vec2 localPos, float time) {
+    vec2 halfSize = island.rect.zw * 0.5;
+    float centre = length(localPos / max(halfSize, vec2(1.0)));
+    f16vec3 mixedColor = mix(f16vec3(island.colorA.rgb), f16vec3(island.colorB.rgb),
+                             0.5hf + 0.5hf * fastSin(time * 0.5 + centre));
+    if (!HIGHLIGHT)
+        return mixedColor;
+    float16_t highlight = float16_t(max(0.0, 0.5 - centre));
+    return mix(mixedColor, f16vec3(0.0hf, 1.0hf, 0.8hf),
+               highlight * highlight * highlight);
+}
+
+// Same bound as liquid.frag's, so the two variants cover the same pixels
+float warpBound() {
+    float bound = 0.0;
+    for (int i = 1; i <= WARP_ITERATIONS; i++)
+        bound += 0.3 / float(i);
+    return bound;
+}
+
+void main() {
+    Island island = islands[islandIndex];
+    vec2 halfSize = island.rect.zw * 0.5;
+    float time = fastFluidIntensity(frame.timing.x + island.shape.w);
+
+    vec2 uv = localPos / max(halfSize.y, 1.0);
+
+    // The warp of liquid.frag; the displacement terms are fp16, their sum
+    // stays fp32 so it does not lose the small offsets next to uv
+    vec2 warped = uv;
+    for (int n = 1; n <= WARP_ITERATIONS; n++) {
+        float i = float(n);
+        float16_t amplitude = float16_t(0.3 / i);
+        warped.x += float(amplitude * fastSin(i * 3.0 * warped.y + time));
+        warped.y += float(amplitude * fastCos(i * 3.0 * warped.x + time));
+    }
+    vec2 p = localPos + (warped - uv) * (island.shape.y / warpBound());
+
+    float d = roundedBox(p, halfSize, islandRadius(island));
+    float width = edgeWidth();
+    float mask = width > 1.0 ? clamp(0.5 - 0.5 * d / width, 0.0, 1.0)
+                             : smoothstep(1.0, -1.0, d);
+
+    // pow(x, 2) as a multiply; the falloff only matters within a glow
+    // radius of the edge, where fp16 resolves d finely
+    float16_t glow = 0.0hf;
+    if (GLOW && island.shape.z > 0.0) {
+        float16_t falloff = clamp(1.0hf - float16_t(d / island.shape.z), 0.0hf, 1.0hf);
+        glow = falloff * falloff * 0.5hf;
+    }
+
+    float alpha = max(mask, float(glow));
+    if (alpha <= 0.0)
+        discard;
+    // Premultiplied; blended with ONE, ONE_MINUS_SRC_ALPHA
+    outColor = vec4(vec3(fastIslandColor(island, localPos, time)) * alpha, alpha);
+}
@@ -0,0 +1,18 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "liquid_common.glsl"
+
+// Interior tiles of the tiled path: tile_classify.comp guarantees the warped
+// edge and its anti-aliasing never reach these pixels, so liquid.frag would
+// produce exactly this colour at full coverage. No warp loop, no discard.
+
+layout(location = 0) flat in uint islandIndex;
+layout(location = 1) in vec2 localPos;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    Island island = islands[islandIndex];
+    float time = fluidIntensity(frame.timing.x + island.shape.w);
+    outColor = vec4(islandColor(island, localPos, time), 1.0);
+}
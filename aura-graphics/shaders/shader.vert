@@ -1,20 +1,37 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
-layout(location = 0) out vec3 fragColor;
+#include "liquid_common.glsl"
 
-vec2 positions[3] = vec2[](
-    vec2(0.0, -0.5),
-    vec2(0.5, 0.5),
-    vec2(-0.5, 0.5)
-);
+// One instance per island: expands it into an octagon hugging the island's
+// reach (islandBounds) so only pixels the island can colour are shaded; the
+// cost follows the island's size, not the screen's.
+
+layout(location = 0) flat out uint islandIndex;
+layout(location = 1) out vec2 localPos; // pixels relative to the island centre
 
-vec3 colors[3] = vec3[](
-    vec3(1.0, 0.0, 0.0),
-    vec3(0.0, 1.0, 0.0),
-    vec3(0.0, 0.0, 1.0)
+// Octagon corners, clockwise (y down) from the top-left of the top edge:
+// xy = bounding-box corner sign, zw = direction the cut moves it
+const vec4 octagon[8] = vec4[](
+    vec4(-1.0, -1.0, 1.0, 0.0), vec4(1.0, -1.0, -1.0, 0.0),
+    vec4(1.0, -1.0, 0.0, 1.0), vec4(1.0, 1.0, 0.0, -1.0),
+    vec4(1.0, 1.0, -1.0, 0.0), vec4(-1.0, 1.0, 1.0, 0.0),
+    vec4(-1.0, 1.0, 0.0, -1.0), vec4(-1.0, -1.0, 0.0, 1.0)
 );
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
+    Island island = islands[gl_InstanceIndex];
+    vec2 halfExtent;
+    float cut;
+    islandBounds(island, halfExtent, cut);
+
+    // 6 triangles fanned around corner 0 (18 vertices per island)
+    int triangle = gl_VertexIndex / 3;
+    int corner = gl_VertexIndex % 3;
+    vec4 v = octagon[corner == 0 ? 0 : triangle + corner];
+
+    localPos = v.xy * halfExtent + v.zw * cut;
+    vec2 pixel = island.rect.xy + localPos;
+    gl_Position = vec4(pixel * frame.resolution.zw * 2.0 - 1.0, 0.0, 1.0);
+    islandIndex = uint(gl_InstanceIndex);
 }
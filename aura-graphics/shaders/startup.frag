@@ -0,0 +1,23 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "liquid_common.glsl"
+
+// Stand-in for liquid.frag while the liquid pipelines compile in the
+// background: the island's pill, unwarped and without glow, flat in its
+// first colour. Tiny, so it is the first pipeline built and the first frame
+// can go out before the real shaders are ready.
+
+layout(location = 0) flat in uint islandIndex;
+layout(location = 1) in vec2 localPos;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    Island island = islands[islandIndex];
+    float d = roundedBox(localPos, island.rect.zw * 0.5, islandRadius(island));
+    float alpha = smoothstep(1.0, -1.0, d);
+    if (alpha <= 0.0)
+        discard;
+    // Premultiplied; blended with ONE, ONE_MINUS_SRC_ALPHA
+    outColor = vec4(island.colorA.rgb * alpha, alpha);
+}
@@ -0,0 +1,39 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "liquid_common.glsl"
+
+// Tiled path: one instance per (tile, island) entry written by
+// tile_classify.comp. Edge entries are stored from the front of the list and
+// drawn with liquid.frag, interior entries from the back and drawn with
+// liquid_fill.frag.
+
+layout(constant_id = 0) const bool INTERIOR_LIST = false;
+
+layout(std430, set = 0, binding = 2) readonly buffer Tiles {
+    uint edgeDraw[4];
+    uint interiorDraw[4];
+    uint used;
+    uint reserved[3];
+    uvec2 entries[]; // x = tileY << 16 | tileX, y = island index
+} tiles;
+
+layout(location = 0) flat out uint islandIndex;
+layout(location = 1) out vec2 localPos;
+
+const vec2 corners[6] = vec2[](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+    vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0)
+);
+
+void main() {
+    uint entry = INTERIOR_LIST ? frame.counts.y - 1u - uint(gl_InstanceIndex)
+                               : uint(gl_InstanceIndex);
+    uvec2 item = tiles.entries[entry];
+    vec2 tile = vec2(item.x & 0xffffu, item.x >> 16);
+    vec2 pixel = (tile + corners[gl_VertexIndex]) * TILE_SIZE;
+
+    islandIndex = item.y;
+    localPos = pixel - islands[item.y].rect.xy;
+    gl_Position = vec4(pixel * frame.resolution.zw * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,41 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "liquid_common.glsl"
+
+// Dynamic resolution: composites the liquid layer, rendered at timing.y of
+// the framebuffer size, into the framebuffer. Drawn with the island octagons
+// of shader.vert, so only pixels an island can reach are touched.
+//
+// The layer is premultiplied colour plus coverage alpha. Colour and glow are
+// smooth and are simply filtered bilinearly. The edge is not: liquid.frag
+// writes it there as a linear ramp one texel wide, so the filtered alpha is
+// still a linear function of the signed distance d. The distance is recovered
+// from it and the one-pixel native ramp re-applied, which keeps the border as
+// crisp as at full resolution.
+
+layout(set = 1, binding = 0) uniform sampler2D liquidLayer;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    float scale = frame.timing.y;
+    vec2 layerSize = ceil(frame.resolution.xy * scale);
+    vec2 layerPos = gl_FragCoord.xy * layerSize * frame.resolution.zw;
+    // Stay half a texel inside the rendered part of the (larger) image
+    vec2 uv = clamp(layerPos, vec2(0.5), layerSize - 0.5) /
+              vec2(textureSize(liquidLayer, 0));
+    vec4 layer = texture(liquidLayer, uv);
+
+    // Inverse of liquid.frag's layer ramp, then its native ramp. With glow,
+    // alpha below one half is the glow, which needs no sharpening.
+    float alpha = layer.a;
+    float d = (0.5 - alpha) * 2.0 * edgeWidth();
+    float sharp = smoothstep(1.0, -1.0, d);
+    float outAlpha = GLOW && alpha < 0.5 ? alpha : sharp;
+    vec3 color = alpha > 0.0 ? layer.rgb * (outAlpha / alpha) : vec3(0.0);
+
+    // Opaque over the black clear colour, so octagons of overlapping islands
+    // write the same value and blending twice changes nothing
+    outColor = vec4(color, 1.0);
+}
@@ -0,0 +1,464 @@
+/// Kanal Kernel <-> Renderer
+/// Dua ring buffer lock-free single-producer/single-consumer, dialokasikan
+/// sekali oleh kernel:
+/// - `events`: kernel -> renderer (mode daya, level privasi, memori kernel)
+/// - `telemetry`: renderer -> kernel (waktu frame)
+///
+/// C hanya melihat handle opaque (`AuraKernelChannel *` di `aura_kernel.h`);
+/// setiap pesan lewat satu panggilan FFI (`aura_kernel_channel_poll_event`,
+/// `aura_kernel_channel_push_telemetry`). Hanya `AuraKernelEvent` dan
+/// `AuraFrameTelemetry` yang punya layout C. Indeks tulis dan baca
+/// masing-masing menempati cache line sendiri (64 byte) agar producer dan
+/// consumer tidak saling false-sharing. Tidak ada lock dan tidak ada alokasi
+/// per pesan: push/pop hanya menyalin satu slot dan satu store atomik.
+use std::cell::UnsafeCell;
+use std::mem::MaybeUninit;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicBool, AtomicU32, Ordering};
+use std::thread::JoinHandle;
+use std::time::Duration;
+
+use crate::kernel_state::{self, KernelState};
+use crate::memory_manager::MemoryManager;
+use crate::power::{PowerCoreMode, PowerManager};
+
+pub const AURA_EVENT_POWER_MODE: u32 = 1;
+pub const AURA_EVENT_PRIVACY_LEVEL: u32 = 2;
+pub const AURA_EVENT_MEMORY_USAGE: u32 = 3;
+
+pub const AURA_CHANNEL_EVENT_CAPACITY: usize = 64;
+pub const AURA_CHANNEL_TELEMETRY_CAPACITY: usize = 256;
+
+/// Pesan kernel -> renderer (32 byte).
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct AuraKernelEvent {
+    /// `AURA_EVENT_*`
+    pub kind: u32,
+    /// Mode daya (0 = Performance, 1 = Balanced, 2 = Efficient) atau level
+    /// privasi (0 = Standard, 1 = High, 2 = Paranoid)
+    pub value: u32,
+    /// Mode daya: faktor optimasi dari `PowerManager`
+    pub factor: f32,
+    pub reserved: u32,
+    /// Memori: byte teralokasi dan kapasitas
+    pub data: [u64; 2],
+}
+
+/// Pesan renderer -> kernel, satu per frame (32 byte).
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct AuraFrameTelemetry {
+    pub frame_number: u64,
+    pub cpu_frame_ms: f32,
+    pub gpu_frame_ms: f32,
+    pub present_ms: f32,
+    pub island_count: u32,
+    pub reserved: [u32; 2],
+}
+
+#[repr(C, align(64))]
+struct CacheLine(AtomicU32);
+
+/// Ring SPSC berukuran tetap; `N` harus pangkat dua. Indeks berjalan terus
+/// (wrapping u32) dan di-mask saat mengakses slot, jadi penuh = `N` pesan.
+#[repr(C)]
+pub struct SpscRing<T: Copy, const N: usize> {
+    // Ditulis producer, dibaca consumer
+    head: CacheLine,
+    // Ditulis consumer, dibaca producer
+    tail: CacheLine,
+    slots: [UnsafeCell<MaybeUninit<T>>; N],
+}
+
+// Satu producer dan satu consumer; slot hanya disentuh oleh pemiliknya
+// sesuai head/tail (Acquire/Release).
+unsafe impl<T: Copy + Send, const N: usize> Sync for SpscRing<T, N> {}
+
+impl<T: Copy, const N: usize> SpscRing<T, N> {
+    const MASK: u32 = {
+        assert!(N.is_power_of_two() && N <= (1 << 31));
+        (N - 1) as u32
+    };
+
+    pub fn new() -> Self {
+        Self {
+            head: CacheLine(AtomicU32::new(0)),
+            tail: CacheLine(AtomicU32::new(0)),
+            slots: [const { UnsafeCell::new(MaybeUninit::uninit()) }; N],
+        }
+    }
+
+    /// Producer: false jika ring penuh (pesan dibuang, tidak menunggu).
+    pub fn push(&self, value: T) -> bool {
+        let head = self.head.0.load(Ordering::Relaxed);
+        let tail = self.tail.0.load(Ordering::Acquire);
+        if head.wrapping_sub(tail) as usize >= N {
+            return false;
+        }
+        unsafe {
+            (*self.slots[(head & Self::MASK) as usize].get()).write(value);
+        }
+        self.head.0.store(head.wrapping_add(1), Ordering::Release);
+        true
+    }
+
+    /// Consumer: pesan tertua, atau `None` jika kosong.
+    pub fn pop(&self) -> Option<T> {
+        let tail = self.tail.0.load(Ordering::Relaxed);
+        let head = self.head.0.load(Ordering::Acquire);
+        if tail == head {
+            return None;
+        }
+        let value = unsafe { (*self.slots[(tail & Self::MASK) as usize].get()).assume_init() };
+        self.tail.0.store(tail.wrapping_add(1), Ordering::Release);
+        Some(value)
+    }
+}
+
+/// Kedua ring, dipegang bersama oleh thread kernel dan handle renderer.
+pub struct AuraKernelChannel {
+    pub events: SpscRing<AuraKernelEvent, AURA_CHANNEL_EVENT_CAPACITY>,
+    pub telemetry: SpscRing<AuraFrameTelemetry, AURA_CHANNEL_TELEMETRY_CAPACITY>,
+}
+
+impl AuraKernelChannel {
+    pub fn new() -> Self {
+        Self {
+            events: SpscRing::new(),
+            telemetry: SpscRing::new(),
+        }
+    }
+
+    pub fn publish_power(&self, power: &PowerManager) -> bool {
+        self.events.push(AuraKernelEvent {
+            kind: AURA_EVENT_POWER_MODE,
+            value: power_mode_index(&power.mode),
+            factor: power.get_optimization_factor(),
+            ..Default::default()
+        })
+    }
+
+    pub fn publish_privacy_level(&self, level: u32) -> bool {
+        self.events.push(AuraKernelEvent {
+            kind: AURA_EVENT_PRIVACY_LEVEL,
+            value: level,
+            ..Default::default()
+        })
+    }
+
+    pub fn publish_memory(&self, memory: &MemoryManager) -> bool {
+        let (allocated, capacity) = memory.get_usage();
+        self.events.push(AuraKernelEvent {
+            kind: AURA_EVENT_MEMORY_USAGE,
+            data: [allocated as u64, capacity as u64],
+            ..Default::default()
+        })
+    }
+}
+
+fn power_mode_index(mode: &PowerCoreMode) -> u32 {
+    match mode {
+        PowerCoreMode::Performance => 0,
+        PowerCoreMode::Balanced => 1,
+        PowerCoreMode::Efficient => 2,
+    }
+}
+
+fn power_mode_from_index(index: u32) -> Option<PowerCoreMode> {
+    match index {
+        0 => Some(PowerCoreMode::Performance),
+        1 => Some(PowerCoreMode::Balanced),
+        2 => Some(PowerCoreMode::Efficient),
+        _ => None,
+    }
+}
+
+/// Ringkasan telemetri yang sudah dibaca kernel.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct TelemetrySummary {
+    pub frames: u64,
+    pub total_cpu_ms: f64,
+    pub max_cpu_ms: f32,
+    pub last_frame: u64,
+}
+
+impl TelemetrySummary {
+    pub fn record(&mut self, t: &AuraFrameTelemetry) {
+        self.frames += 1;
+        self.total_cpu_ms += t.cpu_frame_ms as f64;
+        self.max_cpu_ms = self.max_cpu_ms.max(t.cpu_frame_ms);
+        self.last_frame = t.frame_number;
+    }
+}
+
+// Interval thread kernel; pesan menunggu paling lama selama ini di ring
+const SERVICE_INTERVAL: Duration = Duration::from_millis(50);
+
+/// Status kernel yang terakhir berhasil diterbitkan ke renderer; `None`
+/// berarti belum pernah.
+#[derive(Default)]
+struct Published {
+    power_mode: Option<u32>,
+    privacy_level: Option<u32>,
+    memory: Option<(usize, usize)>,
+}
+
+/// Sisi kernel: satu thread yang menjadi producer `events` dan consumer
+/// `telemetry`. Thread ini menerbitkan setiap perubahan status kernel
+/// (`kernel_state`), termasuk mode daya yang diminta host, jadi ring tetap
+/// single-producer.
+struct KernelService {
+    channel: Arc<AuraKernelChannel>,
+    stop: AtomicBool,
+}
+
+impl KernelService {
+    fn run(&self) {
+        let mut published = Published::default();
+        let mut summary = TelemetrySummary::default();
+        while !self.stop.load(Ordering::Acquire) {
+            while let Some(t) = self.channel.telemetry.pop() {
+                summary.record(&t);
+            }
+            kernel_state::with(|kernel| self.publish_changes(kernel, &mut published));
+            std::thread::park_timeout(SERVICE_INTERVAL);
+        }
+        while let Some(t) = self.channel.telemetry.pop() {
+            summary.record(&t);
+        }
+        if summary.frames > 0 {
+            println!(
+                "[Rust Kernel] Telemetry: {} frames, avg CPU {:.3} ms, max {:.3} ms",
+                summary.frames,
+                summary.total_cpu_ms / summary.frames as f64,
+                summary.max_cpu_ms
+            );
+        }
+    }
+}
+
+impl KernelService {
+    /// Ring penuh: yang belum terkirim dicoba lagi di putaran berikutnya.
+    fn publish_changes(&self, kernel: &KernelState, published: &mut Published) {
+        let mode = power_mode_index(&kernel.power.mode);
+        if published.power_mode != Some(mode) && self.channel.publish_power(&kernel.power) {
+            published.power_mode = Some(mode);
+        }
+        if published.privacy_level != Some(kernel.privacy_level)
+            && self.channel.publish_privacy_level(kernel.privacy_level)
+        {
+            published.privacy_level = Some(kernel.privacy_level);
+        }
+        let usage = kernel.memory.get_usage();
+        if published.memory != Some(usage) && self.channel.publish_memory(&kernel.memory) {
+            published.memory = Some(usage);
+        }
+    }
+}
+
+/// Handle yang dipegang renderer (opaque `AuraKernelChannel *` di C): kanal
+/// bersama plus thread kernel.
+pub struct AuraKernelChannelHandle {
+    channel: Arc<AuraKernelChannel>,
+    service: Arc<KernelService>,
+    thread: Option<JoinHandle<()>>,
+}
+
+/// Mem-boot kernel jika `aura_kernel_init` belum dipanggil; null jika boot
+/// atau pembuatan thread gagal.
+#[unsafe(no_mangle)]
+pub extern "C" fn aura_kernel_channel_create() -> *mut AuraKernelChannelHandle {
+    if !kernel_state::boot() {
+        return std::ptr::null_mut();
+    }
+    let channel = Arc::new(AuraKernelChannel::new());
+    let service = Arc::new(KernelService {
+        channel: channel.clone(),
+        stop: AtomicBool::new(false),
+    });
+    let worker = service.clone();
+    let thread = std::thread::Builder::new()
+        .name("aura-kernel-channel".to_string())
+        .spawn(move || worker.run());
+    match thread {
+        Ok(thread) => Box::into_raw(Box::new(AuraKernelChannelHandle {
+            channel,
+            service,
+            thread: Some(thread),
+        })),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn aura_kernel_channel_destroy(handle: *mut AuraKernelChannelHandle) {
+    if handle.is_null() {
+        return;
+    }
+    let mut handle = unsafe { Box::from_raw(handle) };
+    handle.service.stop.store(true, Ordering::Release);
+    if let Some(thread) = handle.thread.take() {
+        thread.thread().unpark();
+        let _ = thread.join();
+    }
+}
+
+/// Renderer (consumer `events`): 1 dan isi `out` jika ada pesan, 0 jika kosong.
+#[unsafe(no_mangle)]
+pub extern "C" fn aura_kernel_channel_poll_event(
+    handle: *const AuraKernelChannelHandle,
+    out: *mut AuraKernelEvent,
+) -> i32 {
+    if handle.is_null() || out.is_null() {
+        return 0;
+    }
+    match unsafe { &*handle }.channel.events.pop() {
+        Some(event) => {
+            unsafe { *out = event };
+            1
+        }
+        None => 0,
+    }
+}
+
+/// Renderer (producer `telemetry`): 0 jika ring penuh (frame dibuang).
+#[unsafe(no_mangle)]
+pub extern "C" fn aura_kernel_channel_push_telemetry(
+    handle: *const AuraKernelChannelHandle,
+    telemetry: *const AuraFrameTelemetry,
+) -> i32 {
+    if handle.is_null() || telemetry.is_null() {
+        return 0;
+    }
+    unsafe { &*handle }
+        .channel
+        .telemetry
+        .push(unsafe { *telemetry }) as i32
+}
+
+/// Host (mis. battery saver Android) mengubah mode daya kernel; thread kernel
+/// menerbitkannya sebagai `AURA_EVENT_POWER_MODE`. Aman dari thread mana pun.
+#[unsafe(no_mangle)]
+pub extern "C" fn aura_kernel_channel_request_power_mode(
+    handle: *const AuraKernelChannelHandle,
+    mode: u32,
+) -> i32 {
+    let Some(mode) = power_mode_from_index(mode) else {
+        return 0;
+    };
+    if handle.is_null() || kernel_state::with(|kernel| kernel.power.mode = mode).is_none() {
+        return 0;
+    }
+    let handle = unsafe { &*handle };
+    if let Some(thread) = &handle.thread {
+        thread.thread().unpark();
+    }
+    1
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_ring_fifo_and_full() {
+        let ring: SpscRing<u32, 4> = SpscRing::new();
+        for i in 0..4 {
+            assert!(ring.push(i));
+        }
+        assert!(!ring.push(99));
+        for i in 0..4 {
+            assert_eq!(ring.pop(), Some(i));
+        }
+        assert_eq!(ring.pop(), None);
+    }
+
+    #[test]
+    fn test_ring_across_threads() {
+        let ring: Arc<SpscRing<u64, 64>> = Arc::new(SpscRing::new());
+        let producer = ring.clone();
+        let count = 100_000u64;
+        let thread = std::thread::spawn(move || {
+            for i in 0..count {
+                while !producer.push(i) {
+                    std::thread::yield_now();
+                }
+            }
+        });
+        let mut expected = 0;
+        while expected < count {
+            match ring.pop() {
+                Some(v) => {
+                    assert_eq!(v, expected);
+                    expected += 1;
+                }
+                None => std::thread::yield_now(),
+            }
+        }
+        thread.join().unwrap();
+    }
+
+    #[test]
+    fn test_layout_is_cache_line_padded() {
+        assert_eq!(std::mem::size_of::<AuraKernelEvent>(), 32);
+        assert_eq!(std::mem::size_of::<AuraFrameTelemetry>(), 32);
+        assert_eq!(std::mem::align_of::<AuraKernelChannel>(), 64);
+        assert_eq!(
+            std::mem::offset_of!(SpscRing<AuraKernelEvent, 64>, tail),
+            64
+        );
+        assert_eq!(
+            std::mem::offset_of!(SpscRing<AuraKernelEvent, 64>, slots),
+            128
+        );
+    }
+
+    #[test]
+    fn test_channel_round_trip() {
+        let handle = aura_kernel_channel_create();
+        assert!(!handle.is_null());
+        let mut kinds = Vec::new();
+        let mut event = AuraKernelEvent::default();
+        while kinds.len() < 3 {
+            if aura_kernel_channel_poll_event(handle, &mut event) == 1 {
+                kinds.push(event.kind);
+                // Status kernel yang di-boot, bukan salinan milik kanal
+                if event.kind == AURA_EVENT_MEMORY_USAGE {
+                    let (allocated, capacity) =
+                        kernel_state::with(|kernel| kernel.memory.get_usage()).unwrap();
+                    assert_eq!(event.data, [allocated as u64, capacity as u64]);
+                }
+            } else {
+                std::thread::yield_now();
+            }
+        }
+        assert_eq!(
+            kinds,
+            vec![
+                AURA_EVENT_POWER_MODE,
+                AURA_EVENT_PRIVACY_LEVEL,
+                AURA_EVENT_MEMORY_USAGE
+            ]
+        );
+
+        assert_eq!(aura_kernel_channel_request_power_mode(handle, 2), 1);
+        assert_eq!(aura_kernel_channel_request_power_mode(handle, 7), 0);
+        loop {
+            if aura_kernel_channel_poll_event(handle, &mut event) == 1 {
+                assert_eq!(event.kind, AURA_EVENT_POWER_MODE);
+                assert_eq!(event.value, 2);
+                break;
+            }
+            std::thread::yield_now();
+        }
+
+        let telemetry = AuraFrameTelemetry {
+            frame_number: 1,
+            cpu_frame_ms: 2.0,
+            ..Default::default()
+        };
+        assert_eq!(aura_kernel_channel_push_telemetry(handle, &telemetry), 1);
+        aura_kernel_channel_destroy(handle);
+    }
+}
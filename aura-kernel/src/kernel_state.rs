@@ -0,0 +1,71 @@
+/// Status Kernel Aura di dalam library
+/// Di-boot sekali oleh `aura_kernel_init`, dengan konfigurasi yang sama seperti
+/// `KernelCore::boot` di binary: privasi High, mode daya Balanced, memori
+/// kernel 1 MB dengan region Shield 4096 byte. Thread kanal renderer membaca
+/// status ini dan permintaan mode daya dari host mengubahnya, jadi event yang
+/// diterima renderer selalu status kernel yang sebenarnya.
+use std::sync::{Mutex, MutexGuard};
+
+use crate::memory_manager::MemoryManager;
+use crate::power::PowerManager;
+
+pub const PRIVACY_LEVEL_STANDARD: u32 = 0;
+pub const PRIVACY_LEVEL_HIGH: u32 = 1;
+pub const PRIVACY_LEVEL_PARANOID: u32 = 2;
+
+const KERNEL_MEMORY_CAPACITY: usize = 1024 * 1024;
+const SHIELD_REGION_SIZE: usize = 4096;
+
+pub struct KernelState {
+    pub power: PowerManager,
+    pub memory: MemoryManager,
+    /// `PRIVACY_LEVEL_*`
+    pub privacy_level: u32,
+}
+
+static KERNEL: Mutex<Option<KernelState>> = Mutex::new(None);
+
+fn lock() -> MutexGuard<'static, Option<KernelState>> {
+    // Status tetap utuh walau thread lain panik sambil memegang lock
+    KERNEL.lock().unwrap_or_else(|poisoned| poisoned.into_inner())
+}
+
+/// Mem-boot kernel jika belum berjalan. True jika kernel berjalan setelahnya.
+pub fn boot() -> bool {
+    let mut kernel = lock();
+    if kernel.is_none() {
+        let mut memory = MemoryManager::new(KERNEL_MEMORY_CAPACITY);
+        if memory.allocate_region(SHIELD_REGION_SIZE).is_err() {
+            return false;
+        }
+        *kernel = Some(KernelState {
+            power: PowerManager::new(),
+            memory,
+            privacy_level: PRIVACY_LEVEL_HIGH,
+        });
+    }
+    true
+}
+
+/// Menjalankan `f` pada status kernel; `None` jika kernel belum di-boot.
+pub fn with<R>(f: impl FnOnce(&mut KernelState) -> R) -> Option<R> {
+    lock().as_mut().map(f)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_boot_is_idempotent() {
+        assert!(boot());
+        let usage = with(|kernel| kernel.memory.get_usage()).unwrap();
+        assert!(boot());
+        assert_eq!(with(|kernel| kernel.memory.get_usage()), Some(usage));
+        assert_eq!(usage, (SHIELD_REGION_SIZE, KERNEL_MEMORY_CAPACITY));
+        assert_eq!(
+            with(|kernel| kernel.privacy_level),
+            Some(PRIVACY_LEVEL_HIGH)
+        );
+    }
+}
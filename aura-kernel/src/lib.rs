@@ -1,10 +1,16 @@
 use std::ffi::CString;
 use std::os::raw::c_char;
 
+pub mod channel;
+pub mod kernel_state;
+pub mod memory_manager;
+pub mod power;
+
+/// Mem-boot status kernel (lihat `kernel_state`); aman dipanggil berulang.
 #[unsafe(no_mangle)]
 pub extern "C" fn aura_kernel_init() -> i32 {
     println!("[Rust Kernel] FFI: Initializing Aura Privacy Shield...");
-    1 // Success
+    kernel_state::boot() as i32
 }
 
 #[unsafe(no_mangle)]
@@ -23,11 +29,120 @@ pub extern "C" fn aura_kernel_free_string(s: *mut c_char) {
     }
 }
 
+/// Koefisien kurva fluid intensity, dengan layout yang sama seperti
+/// `AuraFluidCurve` di `aura_kernel.h`:
+///
+/// ```text
+/// ripple(t) = sin(t * ripple_frequency) * ripple_amplitude
+/// f(t)      = t + ripple(t) + cos(t * wave_frequency + ripple(t)) * wave_amplitude
+/// ```
+///
+/// Renderer mengambilnya sekali lewat `aura_kernel_get_fluid_curve` lalu
+/// menghitung kurva yang sama di shader per pulau, tanpa panggilan FFI per frame.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct AuraFluidCurve {
+    pub ripple_frequency: f32,
+    pub ripple_amplitude: f32,
+    pub wave_frequency: f32,
+    pub wave_amplitude: f32,
+}
+
+// Logika Kernel: Membuat pergerakan lebih "liat" dengan mencampur dua gelombang sinus
+// Menghasilkan efek perlambatan dan percepatan yang tidak konstan
+const FLUID_CURVE: AuraFluidCurve = AuraFluidCurve {
+    ripple_frequency: 0.4,
+    ripple_amplitude: 0.15,
+    wave_frequency: 1.2,
+    wave_amplitude: 0.05,
+};
+
+fn fluid_intensity(curve: &AuraFluidCurve, time: f32) -> f32 {
+    let ripple = (time * curve.ripple_frequency).sin() * curve.ripple_amplitude;
+    let wave = (time * curve.wave_frequency + ripple).cos() * curve.wave_amplitude;
+    time + ripple + wave
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn aura_kernel_calculate_fluid_intensity(time: f32) -> f32 {
-    // Logika Kernel: Membuat pergerakan lebih "liat" dengan mencampur dua gelombang sinus
-    // Menghasilkan efek perlambatan dan percepatan yang tidak konstan
-    let ripple = (time * 0.4).sin() * 0.15;
-    let wave = (time * 1.2 + ripple).cos() * 0.05;
-    time + ripple + wave
+    fluid_intensity(&FLUID_CURVE, time)
+}
+
+/// Menghitung `count` nilai sekaligus: `out[i] = f(times[i])`. Satu panggilan
+/// FFI untuk semua pulau/partikel. Pointer null atau `count == 0` diabaikan.
+#[unsafe(no_mangle)]
+pub extern "C" fn aura_kernel_calculate_fluid_intensity_batch(
+    times: *const f32,
+    out: *mut f32,
+    count: usize,
+) {
+    if times.is_null() || out.is_null() || count == 0 {
+        return;
+    }
+    // Caller menjamin kedua buffer berisi `count` float; boleh buffer yang sama
+    // (in-place), jadi dibaca per elemen, bukan lewat dua slice yang overlap.
+    unsafe {
+        for i in 0..count {
+            *out.add(i) = fluid_intensity(&FLUID_CURVE, *times.add(i));
+        }
+    }
+}
+
+/// Menyalin koefisien kurva ke `out`. Mengembalikan 1 jika berhasil, 0 jika
+/// `out` null.
+#[unsafe(no_mangle)]
+pub extern "C" fn aura_kernel_get_fluid_curve(out: *mut AuraFluidCurve) -> i32 {
+    if out.is_null() {
+        return 0;
+    }
+    unsafe {
+        *out = FLUID_CURVE;
+    }
+    1
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_batch_matches_scalar() {
+        let times: Vec<f32> = (0..100).map(|i| i as f32 * 0.37 - 5.0).collect();
+        let mut out = vec![0.0f32; times.len()];
+        aura_kernel_calculate_fluid_intensity_batch(times.as_ptr(), out.as_mut_ptr(), times.len());
+        for (t, v) in times.iter().zip(&out) {
+            assert_eq!(*v, aura_kernel_calculate_fluid_intensity(*t));
+        }
+    }
+
+    #[test]
+    fn test_batch_in_place() {
+        let mut values = vec![0.0f32, 1.0, 2.5];
+        let expected: Vec<f32> = values
+            .iter()
+            .map(|t| aura_kernel_calculate_fluid_intensity(*t))
+            .collect();
+        let ptr = values.as_mut_ptr();
+        aura_kernel_calculate_fluid_intensity_batch(ptr, ptr, values.len());
+        assert_eq!(values, expected);
+    }
+
+    #[test]
+    fn test_curve_reproduces_scalar() {
+        let mut curve = AuraFluidCurve {
+            ripple_frequency: 0.0,
+            ripple_amplitude: 0.0,
+            wave_frequency: 0.0,
+            wave_amplitude: 0.0,
+        };
+        assert_eq!(aura_kernel_get_fluid_curve(&mut curve), 1);
+        assert_eq!(aura_kernel_get_fluid_curve(std::ptr::null_mut()), 0);
+        for i in 0..50 {
+            let t = i as f32 * 1.7;
+            assert_eq!(
+                fluid_intensity(&curve, t),
+                aura_kernel_calculate_fluid_intensity(t)
+            );
+        }
+    }
 }
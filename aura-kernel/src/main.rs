@@ -1,11 +1,9 @@
 use std::time::Instant;
 
-mod memory_manager;
-mod power;
 mod privacy;
 
-use memory_manager::MemoryManager;
-use power::PowerManager;
+use aura_kernel::memory_manager::MemoryManager;
+use aura_kernel::power::PowerManager;
 use privacy::PrivacyShield;
 
 /// Tingkat keamanan privasi di Aura OS